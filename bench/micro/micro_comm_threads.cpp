@@ -75,6 +75,8 @@ int main(int argc, char** argv) {
         comm_suffix = "MPI";
     else if (COMMUNICATOR_NUM == NOCOPY_COMMUNICATOR)
         comm_suffix = "NoCopyComm (" + std::to_string(NOCOPY_COMMUNICATOR_THREADS) + ")";
+    else if (COMMUNICATOR_NUM == SHM_COMMUNICATOR)
+        comm_suffix = "SharedMemoryComm";
 
     single_cout(
         "Vector: " << test_size << " x " << std::numeric_limits<std::make_unsigned_t<T>>::digits
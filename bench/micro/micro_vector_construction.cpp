@@ -28,9 +28,6 @@ int main(int argc, char** argv) {
         test_size = atoi(argv[4]);
     }
 
-    std::vector<int> v1 = std::vector<int>(test_size, 0);
-    std::iota(v1.begin(), v1.end(), 0);
-
     std::vector<int> v2 = std::vector<int>(test_size, 0);
     std::iota(v2.begin(), v2.end(), 0);
 
@@ -38,9 +35,6 @@ int main(int argc, char** argv) {
 
     stopwatch::timepoint("Start");
 
-    orq::Vector<int> V1 = orq::Vector<int>(std::move(v1));
-    stopwatch::timepoint("Move constructor");
-
     orq::Vector<int> V2 = orq::Vector<int>(v2);
     stopwatch::timepoint("Copy constructor");
 
@@ -50,6 +44,22 @@ int main(int argc, char** argv) {
     orq::Vector<int> V4 = orq::Vector<int>(s1);
     stopwatch::timepoint("Range copy constructor (using span)");
 
+    { orq::Vector<int> released(test_size); }
+    stopwatch::timepoint("Construct and release");
+
+    orq::Vector<int> V5 = orq::Vector<int>(test_size);
+    stopwatch::timepoint("Zeroed constructor (reused storage)");
+
+    { orq::Vector<int> released(test_size); }
+    stopwatch::timepoint("Construct and release");
+
+    auto V6 = orq::Vector<int>::uninitialized(test_size);
+    stopwatch::timepoint("Uninitialized constructor (reused storage)");
+
+    auto stats = orq::memory::pool_stats();
+    std::cout << "Vector storage: current " << stats.current << "B, peak " << stats.peak
+              << "B, cached " << stats.cached << "B\n";
+
     stopwatch::done();
 
     return 0;
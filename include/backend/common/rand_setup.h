@@ -72,7 +72,7 @@ void create_common_prg_among_group(
 
     // by now, all parties agree on a seed
     std::unique_ptr<DeterministicPRGAlgorithm> prg_algorithm =
-        std::make_unique<orq::random::AESPRGAlgorithm>(seed_vec);
+        std::make_unique<orq::random::AESCTRPRGAlgorithm>(seed_vec);
     auto commonPRG = std::make_shared<orq::random::CommonPRG>(std::move(prg_algorithm), rank);
     commonPRGManager->add(commonPRG, group);
 }
@@ -139,7 +139,7 @@ void setup_3pc_common_prgs(int rank,
         }
 
         std::unique_ptr<DeterministicPRGAlgorithm> prg_algorithm =
-            std::make_unique<orq::random::AESPRGAlgorithm>(seed_vec);
+            std::make_unique<orq::random::AESCTRPRGAlgorithm>(seed_vec);
         auto commonPRG = std::make_shared<orq::random::CommonPRG>(std::move(prg_algorithm), rank);
         commonPRGManager->add(commonPRG, relative_rank);
     }
@@ -216,7 +216,7 @@ void setup_4pc_common_prgs(int rank,
         }
 
         std::unique_ptr<DeterministicPRGAlgorithm> prg_algorithm =
-            std::make_unique<orq::random::AESPRGAlgorithm>(seed_vec);
+            std::make_unique<orq::random::AESCTRPRGAlgorithm>(seed_vec);
         auto commonPRG = std::make_shared<orq::random::CommonPRG>(std::move(prg_algorithm), rank);
         commonPRGManager->add(commonPRG, relative_rank);
     }
@@ -281,6 +281,10 @@ void setup_2pc_correlation_generators(cg_map_t& cg, int rank,
     // Use real generators - gilboa OLE and silent OT
     auto vg_a = new GilboaOLE<T>(rank, comm, thread);
     auto vg_b = new SilentOT<T>(rank, comm, thread);
+    // The pools own their generators, which run over libOTe sockets rather
+    // than `comm`; `comm` is only used to check correlations from this
+    // worker's thread. So a pool may be refilled in the background
+    // (`startBackgroundRefill`) while the worker communicates.
     auto pooled_ole = make_pooled<GilboaOLE<T>>(rank, comm, thread);
     auto pooled_ot = make_pooled<SilentOT<T>>(rank, comm, thread);
     cg[{Ti, Correlation::BeaverMulTriple}] =
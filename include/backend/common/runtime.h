@@ -4,14 +4,17 @@
 #include <sched.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <atomic>
 #include <barrier>
 #include <mutex>
 #include <queue>
+#include <string>
 #include <thread>
 
 #include "profiling/thread_profiling.h"
 #include "task.h"
+#include "work_stealing.h"
 #include "worker.h"
 
 #ifdef MPC_USE_MPI_COMMUNICATOR
@@ -46,7 +49,7 @@ class ShardedPermutation;
 #define EVectorClass(T) EVector<T, R>
 
 /**
- * @brief Macro to generate evaluator for `reshare`
+ * @brief Macro to generate evaluators for `reshare` and `reshare_mixed`
  *
  */
 #define define_reshare(S)                                                                          \
@@ -54,6 +57,12 @@ class ShardedPermutation;
     void reshare(EVectorClass(S) & x, const T &...args) {                                          \
         eval_protocol_reshare<RepProto<S, R>, &Worker::PROTO_OBJ_NAME(S), EVector<S, R>>(x,        \
                                                                                          args...); \
+    }                                                                                              \
+    template <int R>                                                                               \
+    void reshare_mixed(EVectorClass(S) & x, const std::set<int> &group,                            \
+                       const size_t num_arithmetic) {                                              \
+        eval_protocol_reshare_mixed<RepProto<S, R>, &Worker::PROTO_OBJ_NAME(S), EVector<S, R>>(    \
+            x, group, num_arithmetic);                                                             \
     }
 
 /**
@@ -97,11 +106,14 @@ class ShardedPermutation;
  * @brief Macro to generate evaluator for two-argument functions
  *
  */
-#define define_2_arg(S, F, InT, OutT)                                                           \
-    template <int R, typename... T>                                                             \
-    void F(InT x, InT y, OutT &r, const T &...args) {                                           \
-        eval_protocol_2arg<RepProto<S, R>, &Worker::PROTO_OBJ_NAME(S), &RepProto<S, R>::F, InT, \
-                           OutT>(x, y, r, args...);                                             \
+#define define_2_arg(S, F, InT, OutT)                                                            \
+    template <int R, typename... T>                                                              \
+    void F(InT x, InT y, OutT &r, const T &...args) {                                            \
+        eval_protocol_2arg<RepProto<S, R>, &Worker::PROTO_OBJ_NAME(S),                           \
+                           static_cast<void (RepProto<S, R>::*)(const InT &, const InT &, OutT &, \
+                                                                const T &...)>(                  \
+                               &RepProto<S, R>::F),                                              \
+                           InT, OutT>(x, y, r, args...);                                         \
     }
 
 /**
@@ -116,6 +128,21 @@ class ShardedPermutation;
                                       &RepProto<S, R>::F, InT, OutT>(x, y, r, agg, args...); \
     }
 
+/**
+ * @brief Macro to generate a non-blocking evaluator for two-argument functions. The operation is
+ * queued and only executed (together with all other pending operations of the same function and
+ * type; different functions are not merged) at the next `flush()`.
+ *
+ */
+#define define_2_arg_async(S, F, InT)                                  \
+    template <int R>                                                   \
+    AsyncHandle F##_async(InT x, InT y, InT r) {                       \
+        return enqueue_async<InT>(#F "/" #S, x, y, r,                  \
+                                  [this](InT &_x, InT &_y, InT &_r) {  \
+                                      this->template F<R>(_x, _y, _r); \
+                                  });                                  \
+    }
+
 /**
  * @brief Macro to define all runtime-protocol functionalities
  *
@@ -128,10 +155,13 @@ class ShardedPermutation;
     define_2_arg(T, xor_b, EVectorClass(T), EVectorClass(T));                          \
     define_2_arg_aggregator(T, dot_product_a, EVectorClass(T), EVectorClass(T));       \
     define_2_arg(T, and_b, EVectorClass(T), EVectorClass(T));                          \
+    define_2_arg_async(T, multiply_a, EVectorClass(T));                                \
+    define_2_arg_async(T, and_b, EVectorClass(T));                                     \
     define_1_arg(T, not_b, EVectorClass(T), EVectorClass(T));                          \
     define_1_arg(T, not_b_1, EVectorClass(T), EVectorClass(T));                        \
     define_1_arg(T, ltz, EVectorClass(T), EVectorClass(T));                            \
     define_1_arg(T, b2a_bit, EVectorClass(T), EVectorClass(T));                        \
+    define_1_arg(T, b2a_dabit, EVectorClass(T), EVectorClass(T));                      \
     define_reshare(T);                                                                 \
     define_1_arg(T, reconstruct_from_a, orq::Vector<T>, std::vector<EVectorClass(T)>); \
     define_1_arg(T, reconstruct_from_b, orq::Vector<T>, std::vector<EVectorClass(T)>); \
@@ -141,10 +171,40 @@ class ShardedPermutation;
     define_1_alloc(T, secret_share_b, orq::Vector<T>, EVectorClass(T));                \
     define_1_alloc(T, public_share, orq::Vector<T>, EVectorClass(T));                  \
     define_1_pair(T, div_const_a, EVectorClass(T), EVectorClass(T));                   \
-    define_1_pair(T, redistribute_shares_b, EVectorClass(T), EVectorClass(T));
+    define_1_pair(T, redistribute_shares_b, EVectorClass(T), EVectorClass(T));         \
+    define_1_pair(T, edabit_shares_b, EVectorClass(T), EVectorClass(T));
 
 namespace orq::service {
 
+class RunTime;
+
+/**
+ * @brief Handle to a primitive dispatched with one of the runtime's `*_async` functions. The
+ * result vector passed to the call is only valid once the handle is ready.
+ *
+ */
+class AsyncHandle {
+    std::shared_ptr<bool> done;
+    RunTime *rt;
+
+   public:
+    AsyncHandle(std::shared_ptr<bool> _done, RunTime *_rt) : done(_done), rt(_rt) {}
+
+    /**
+     * @brief Check whether the operation has completed
+     *
+     * @return true
+     * @return false
+     */
+    bool ready() const { return *done; }
+
+    /**
+     * @brief Block until the operation has completed. Flushes all pending
+     * operations in the runtime if necessary.
+     */
+    void wait();
+};
+
 class RunTime {
    private:
     /**
@@ -176,9 +236,155 @@ class RunTime {
      */
     std::vector<std::thread> socket_comm_threads;
 
+    /**
+     * @brief Whether local (non-MPC) tasks are scheduled with work stealing. Defaults to on if
+     * compiled with `USE_WORK_STEALING`.
+     *
+     */
+#ifdef USE_WORK_STEALING
+    bool work_stealing = true;
+#else
+    bool work_stealing = false;
+#endif
+
+    /**
+     * @brief Sub-batch queues for work stealing; reused across calls.
+     *
+     */
+    std::unique_ptr<WorkStealingPool> steal_pool;
+
     template <typename T, int R>
     using RepProto = Protocol<T, std::vector<T>, Vector<T>, EVector<T, R>>;
 
+    /**
+     * @brief A group of pending asynchronous operations which will be evaluated together.
+     *
+     */
+    struct PendingGroupBase {
+        virtual ~PendingGroupBase() = default;
+        virtual void dispatch(RunTime &rt) = 0;
+    };
+
+    /**
+     * @brief Pending calls to one binary primitive over one EVector type. On dispatch, all inputs
+     * are concatenated, the primitive is evaluated once (so each worker exchanges a single
+     * message per peer), and outputs are copied back into the callers' result vectors. The
+     * gather and the scatter each take one parallel pass over the whole group.
+     *
+     * Only calls to the same primitive are merged: each protocol runs its own exchange inside
+     * each primitive, so e.g. `multiply_a` and `and_b` calls form two groups and two rounds.
+     *
+     * @tparam EV
+     */
+    template <typename EV>
+    struct PendingGroup : PendingGroupBase {
+        using Func = std::function<void(EV &, EV &, EV &)>;
+
+        struct Op {
+            EV x, y, r;
+            std::shared_ptr<bool> done;
+        };
+
+        Func func;
+        std::vector<Op> ops;
+
+        PendingGroup(Func _func) : func(_func) {}
+
+        void dispatch(RunTime &rt) override {
+            if (ops.size() == 1) {
+                auto &op = ops.front();
+                func(op.x, op.y, op.r);
+                *op.done = true;
+                return;
+            }
+
+            // op `i` occupies `[offsets[i], offsets[i + 1])` of the concatenation
+            std::vector<size_t> offsets(ops.size() + 1, 0);
+            for (size_t i = 0; i < ops.size(); i++) {
+                offsets[i + 1] = offsets[i] + ops[i].x.size();
+            }
+            const size_t total = offsets.back();
+
+            // call `f(op, lo, hi, a, b)` for the part `[a, b)` of each op that falls at
+            // `[lo, hi)` of the concatenation, within `[start, end)`
+            auto segments = [&](const size_t start, const size_t end, auto f) {
+                size_t i = std::upper_bound(offsets.begin(), offsets.end(), start) -
+                           offsets.begin() - 1;
+                for (; i < ops.size() && offsets[i] < end; i++) {
+                    const size_t lo = std::max(start, offsets[i]);
+                    const size_t hi = std::min(end, offsets[i + 1]);
+                    if (lo < hi) {
+                        f(ops[i], lo, hi, lo - offsets[i], hi - offsets[i]);
+                    }
+                }
+            };
+
+            EV X(total), Y(total), Z(total);
+            if (total > 0) {
+                rt.execute_parallel_unsafe(total, [&](const size_t start, const size_t end) {
+                    segments(start, end, [&](Op &op, size_t lo, size_t hi, size_t a, size_t b) {
+                        X.slice(lo, hi) = op.x.slice(a, b);
+                        Y.slice(lo, hi) = op.y.slice(a, b);
+                    });
+                });
+
+                // one round for the whole group
+                func(X, Y, Z);
+
+                rt.execute_parallel_unsafe(total, [&](const size_t start, const size_t end) {
+                    segments(start, end, [&](Op &op, size_t lo, size_t hi, size_t a, size_t b) {
+                        op.r.slice(a, b) = Z.slice(lo, hi);
+                    });
+                });
+            }
+
+            for (auto &op : ops) {
+                *op.done = true;
+            }
+        }
+    };
+
+    /**
+     * @brief Pending asynchronous operations, grouped by function and type. Groups are kept in
+     * issue order so that all parties dispatch them in the same order.
+     *
+     */
+    std::vector<std::pair<std::string, std::unique_ptr<PendingGroupBase>>> pending_ops;
+
+    /**
+     * @brief Queue a binary primitive for evaluation at the next `flush()`.
+     *
+     * @tparam EV
+     * @param key identifies the function and type; calls with equal keys are merged
+     * @param x
+     * @param y
+     * @param r result vector (shallow copy); written during `flush()`
+     * @param func evaluates the primitive
+     * @return AsyncHandle
+     */
+    template <typename EV>
+    AsyncHandle enqueue_async(const std::string &key, const EV &x, const EV &y, const EV &r,
+                              typename PendingGroup<EV>::Func func) {
+        assert(x.size() == y.size() && x.size() == r.size());
+
+        PendingGroup<EV> *group = nullptr;
+        for (auto &[k, g] : pending_ops) {
+            if (k == key) {
+                group = static_cast<PendingGroup<EV> *>(g.get());
+                break;
+            }
+        }
+        if (group == nullptr) {
+            auto g = std::make_unique<PendingGroup<EV>>(func);
+            group = g.get();
+            pending_ops.emplace_back(key, std::move(g));
+        }
+
+        auto done = std::make_shared<bool>(false);
+        group->ops.push_back({x, y, r, done});
+        return AsyncHandle(done, this);
+    }
+
     /**
      * @brief Main thread waits for all workers to arrive at the barrier.
      *
@@ -264,6 +470,24 @@ class RunTime {
     void addTask(size_t size, F &&task_factory, std::optional<long> batch_size = std::nullopt) {
         auto boundaries = getThreadBatchBoundaries(size, batch_size);
 
+        if (work_stealing && num_threads > 1) {
+            // Local tasks don't touch the worker's communicator or PRG, so
+            // any worker can execute any batch. Fill every queue before
+            // dispatching so early workers can steal from late ones.
+            auto _batch_size = batch_size.value_or(getBatchSize());
+            for (int t = 0; t < num_threads; t++) {
+                auto [start, end] = boundaries[t];
+                steal_pool->push(t, start, end, _batch_size);
+            }
+
+            for (int t = 0; t < num_threads; t++) {
+                auto [start, end] = boundaries[t];
+                workers[t].addTask(
+                    std::make_unique<Task_Stealing>(task_factory(start, end), t, steal_pool.get()));
+            }
+            return;
+        }
+
         for (int t = 0; t < num_threads; t++) {
             auto [start, end] = boundaries[t];
 
@@ -277,6 +501,10 @@ class RunTime {
      * into the task. This is used for thread-specific functionality like MPC
      * protocol primitives and randomness generation
      *
+     * These tasks are never stolen: each batch must run on the worker whose
+     * communicator and PRGs are paired with the same worker on the other
+     * parties.
+     *
      * TODO: some clean way to combine these two versions?
      *
      * @tparam F
@@ -393,6 +621,8 @@ class RunTime {
 
         worker0 = &workers.front();
 
+        steal_pool = std::make_unique<WorkStealingPool>(num_threads);
+
         // wait until all thread have been initialized to return control from
         // this constructor
         barrier->arrive_and_wait();
@@ -419,6 +649,33 @@ class RunTime {
     runtime_declare_protocol_functions(int64_t);
     runtime_declare_protocol_functions(__int128_t);
 
+    /**
+     * @brief Evaluate all operations queued by `*_async` calls. Pending
+     * operations of the same function and type are merged into a single call
+     * (and therefore a single communication round); each distinct function
+     * and type still takes its own round. Inputs of pending operations must
+     * not be modified before they are flushed.
+     *
+     */
+    void flush() {
+        thread_stopwatch::InstrumentBlock _ib{};
+
+        // take ownership first so that the queue is empty during dispatch
+        auto groups = std::move(pending_ops);
+        pending_ops.clear();
+
+        for (auto &[key, group] : groups) {
+            group->dispatch(*this);
+        }
+    }
+
+    /**
+     * @brief Get the number of pending asynchronous operation groups
+     *
+     * @return size_t
+     */
+    size_t num_pending() const { return pending_ops.size(); }
+
     /**
      * @brief Execute a non-MPC parallel functionality over a vector which
      * puts the result into a new vector.
@@ -515,7 +772,7 @@ class RunTime {
      * @param range_size
      * @param func
      */
-    void execute_parallel_unsafe(const int &range_size,
+    void execute_parallel_unsafe(const size_t &range_size,
                                  std::function<void(const size_t, const size_t)> func) {
         thread_stopwatch::InstrumentBlock _ib{};
 
@@ -576,6 +833,37 @@ class RunTime {
         main_thread_wait();
     }
 
+    /**
+     * @brief Parallel evaluate `reshare_mixed` over a vector whose first `num_arithmetic`
+     * elements are arithmetic shares and the rest boolean shares.
+     *
+     * Each batch is passed the number of arithmetic shares within it.
+     *
+     * @tparam Proto
+     * @tparam ProtoObj
+     * @tparam EVector
+     * @param x
+     * @param group
+     * @param num_arithmetic
+     */
+    template <typename Proto, auto ProtoObj, typename EVector>
+    void eval_protocol_reshare_mixed(EVector &x, const std::set<int> &group,
+                                     const size_t num_arithmetic) {
+        thread_stopwatch::InstrumentBlock _ib{};
+
+        addTask(x.total_size(), [&](const size_t start, const size_t end, Worker &w) {
+            return std::make_unique<Task_0_void>(
+                start, end, batch_size, [&, this](const size_t _start, const size_t _end) {
+                    EVector _x = x;
+                    _x.set_batch(_start, _end);
+                    const size_t k = std::clamp(num_arithmetic, _start, _end) - _start;
+                    static_cast<Proto *>((w.*ProtoObj).get())->reshare_mixed(_x, group, k);
+                });
+        });
+
+        main_thread_wait();
+    }
+
     /**
      * @brief Evaluate a batched unary protocol function producing a
      * freshly-allocated OutT (e.g. secret sharing)
@@ -787,6 +1075,20 @@ class RunTime {
         main_thread_wait();
     }
 
+    /**
+     * @brief Free the `Vector` storage cached for reuse by every worker thread and by the calling
+     * thread (see `memory::VectorPool`). Call between queries to return the caches to the system.
+     */
+    void trim_memory() {
+        for (int t = 0; t < num_threads; ++t) {
+            workers[t].addTask(std::make_unique<Task_1_void_nobatch<int>>(
+                0, [](int &) { orq::memory::trim_thread(); }));
+        }
+
+        main_thread_wait();
+        orq::memory::trim_thread();
+    }
+
     /**
      * @brief Get this node's party ID (rank)
      *
@@ -848,6 +1150,21 @@ class RunTime {
         return old_batch_size;
     }
 
+    /**
+     * @brief Enable or disable work stealing for local (non-MPC) tasks.
+     *
+     * @param enable
+     */
+    void setWorkStealing(const bool enable) { work_stealing = enable; }
+
+    /**
+     * @brief Check whether work stealing is enabled
+     *
+     * @return true
+     * @return false
+     */
+    bool getWorkStealing() const { return work_stealing; }
+
     /**
      * @brief Get the number of worker threads
      *
@@ -926,7 +1243,7 @@ class RunTime {
                 const size_t triple_size = end - start;
                 return std::make_unique<Task_0_void>(
                     start, end, triple_size,
-                    [&, triple_size, this](const int &_start, const int &_end) {
+                    [&, triple_size, this](const size_t _start, const size_t _end) {
                         (w.getRandManager()->*func)(triple_size);
                     });
             },
@@ -957,6 +1274,15 @@ class RunTime {
 #endif
     }
 
+    /**
+     * Calls reserve_triples() to generate daBits ahead of time.
+     * @param n The number of daBits to generate.
+     */
+    template <typename T>
+    void reserve_dabits(size_t n) {
+        reserve_triples<T>(&orq::random::RandomnessManager::reserve_dabits<T>, n);
+    }
+
     bool malicious_check(bool should_abort = true) {
         // Check all threads, all protocols
         bool ok = true;
@@ -1014,6 +1340,12 @@ class RunTime {
     void print_statistics() { workers[0].print_statistics(); }
 };
 
+inline void AsyncHandle::wait() {
+    if (!ready()) {
+        rt->flush();
+    }
+}
+
 /**
  * @brief Static storage of the singleton runTime
  *
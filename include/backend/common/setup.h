@@ -143,3 +143,45 @@ namespace beaver_2pc {
 }  // namespace beaver_2pc
 #endif
 }  // namespace orq::service::nocopy_service
+
+namespace orq::service::shm_service {
+namespace fantastic_4pc {
+    init_mpc_types(int, orq::Vector, std::vector, orq::EVector, 3);
+    init_mpc_system(orq::SharedMemoryCommunicator, orq::random::PRGAlgorithm, orq::Fantastic_4PC,
+                    orq::Fantastic_4PC_Factory);
+    init_mpc_functions(3);
+
+    void orq_init(int argc, char** argv) {
+        std::vector<std::set<int>> groups = {{0, 1, 2}, {1, 2, 3}, {2, 3, 0}, {3, 0, 1}};
+        orq_runtime_init<ProtocolFactory, SharedMemoryCommunicatorFactory>(
+            argc, argv, Protocol_8::parties_num, groups);
+    }
+}  // namespace fantastic_4pc
+
+namespace replicated_3pc {
+    init_mpc_types(int, orq::Vector, std::vector, orq::EVector, 2);
+    init_mpc_system(orq::SharedMemoryCommunicator, orq::random::PRGAlgorithm, orq::Replicated_3PC,
+                    orq::Replicated_3PC_Factory);
+    init_mpc_functions(2);
+
+    void orq_init(int argc, char** argv) {
+        std::vector<std::set<int>> groups = orq::ProtocolBase::generateRandomnessGroups(3, 2, 1);
+        orq_runtime_init<ProtocolFactory, SharedMemoryCommunicatorFactory>(
+            argc, argv, Protocol_8::parties_num, groups);
+    }
+}  // namespace replicated_3pc
+#ifdef MPC_PROTOCOL_BEAVER_TWO
+namespace beaver_2pc {
+    init_mpc_types(int, orq::Vector, std::vector, orq::EVector, 1);
+    init_mpc_system(orq::SharedMemoryCommunicator, orq::random::PRGAlgorithm, orq::Beaver_2PC,
+                    orq::Beaver_2PC_Factory);
+    init_mpc_functions(1);
+
+    void orq_init(int argc, char** argv) {
+        std::vector<std::set<int>> groups = orq::ProtocolBase::generateRandomnessGroups(2, 2, 1);
+        orq_runtime_init<ProtocolFactory, SharedMemoryCommunicatorFactory>(
+            argc, argv, Protocol_8::parties_num, groups);
+    }
+}  // namespace beaver_2pc
+#endif
+}  // namespace orq::service::shm_service
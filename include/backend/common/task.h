@@ -84,9 +84,11 @@ class Task {
 
     /**
      * @brief Execute a series of batched tasks using calls to sub_execute.
+     * Overridden by tasks which draw their batches from elsewhere (e.g.
+     * `Task_Stealing`).
      *
      */
-    void execute() {
+    virtual void execute() {
         for (size_t i = start; i < end; i += batch_size) {
             size_t end_ = std::min(i + batch_size, end);
             sub_execute(i, end_);
@@ -0,0 +1,151 @@
+/**
+ * @file work_stealing.h
+ * @brief Per-worker batch queues which idle workers can steal from.
+ *
+ * Static partitioning (`RunTime::getThreadBatchBoundaries`) gives every
+ * worker one contiguous range, so a single slow worker makes all others idle
+ * at the barrier. With work stealing enabled, each worker's range is instead
+ * split into `MINIMUM_CHUNK_SIZE`-aligned sub-batches and pushed into that
+ * worker's queue. A worker drains its own queue from the front and, once
+ * empty, steals from the back of the other queues.
+ *
+ * Stealing is only applied to *local* tasks (those created without a
+ * `Worker &`). MPC primitives and randomness generation use the worker's own
+ * communicator and PRG streams, which must stay in lockstep with the
+ * corresponding worker on every other party; executing those batches on a
+ * different thread would desynchronize sockets and seeds across parties.
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "task.h"
+
+namespace orq::service {
+
+/**
+ * @brief A set of per-worker queues of `[start, end)` sub-batches.
+ *
+ * The pool is refilled by the main thread before each stealable call into the
+ * runtime; workers then consume it until all queues are empty. Since the main
+ * thread waits at the barrier before the next call, a single pool can be
+ * reused across calls.
+ */
+class WorkStealingPool {
+    using Batch = std::pair<size_t, size_t>;
+
+    /**
+     * @brief A single worker's queue. Aligned to avoid false sharing between
+     * neighboring locks.
+     */
+    struct alignas(64) BatchQueue {
+        std::mutex m;
+        std::deque<Batch> q;
+    };
+
+    std::vector<std::unique_ptr<BatchQueue>> queues;
+
+   public:
+    /**
+     * @brief Construct a new pool with one queue per worker.
+     *
+     * @param num_workers
+     */
+    WorkStealingPool(int num_workers) {
+        queues.reserve(num_workers);
+        for (int i = 0; i < num_workers; i++) {
+            queues.push_back(std::make_unique<BatchQueue>());
+        }
+    }
+
+    /**
+     * @brief Split `[start, end)` into sub-batches and assign them to worker
+     * `owner`. Negative batch sizes are resolved per-range exactly as in `Task`.
+     * Positive batch sizes are rounded up to a multiple of
+     * `MINIMUM_CHUNK_SIZE` so that every sub-batch boundary stays aligned.
+     *
+     * @param owner index of the worker which owns these batches
+     * @param start
+     * @param end
+     * @param batch_size
+     */
+    void push(int owner, size_t start, size_t end, ssize_t batch_size) {
+        if (batch_size < 0) {
+            batch_size = compute_equal_batches(start, end, batch_size);
+        } else {
+            batch_size = (batch_size + MINIMUM_CHUNK_SIZE - 1) / MINIMUM_CHUNK_SIZE *
+                         MINIMUM_CHUNK_SIZE;
+        }
+
+        auto &bq = *queues[owner];
+        std::lock_guard<std::mutex> lock(bq.m);
+        for (size_t i = start; i < end; i += batch_size) {
+            bq.q.emplace_back(i, std::min(i + batch_size, end));
+        }
+    }
+
+    /**
+     * @brief Get the next batch for worker `self`: first from its own queue,
+     * then stolen from the back of another worker's queue.
+     *
+     * @param self index of the calling worker
+     * @param batch output batch boundaries
+     * @return true if a batch was found
+     * @return false if all queues are empty
+     */
+    bool next(int self, Batch &batch) {
+        const int n = queues.size();
+        for (int k = 0; k < n; k++) {
+            auto &bq = *queues[(self + k) % n];
+            std::lock_guard<std::mutex> lock(bq.m);
+            if (bq.q.empty()) {
+                continue;
+            }
+
+            if (k == 0) {
+                batch = bq.q.front();
+                bq.q.pop_front();
+            } else {
+                batch = bq.q.back();
+                bq.q.pop_back();
+            }
+            return true;
+        }
+        return false;
+    }
+};
+
+/**
+ * A Task which wraps another task and executes batches drawn from a
+ * `WorkStealingPool` instead of its own fixed range. The wrapped task's
+ * `sub_execute` must be valid for any range of the input; this holds for all
+ * local tasks, which only set batch boundaries on their own copies of the
+ * input and output.
+ */
+class Task_Stealing : public Task {
+    std::unique_ptr<Task> task;
+    int worker_id;
+    WorkStealingPool *pool;
+
+   public:
+    Task_Stealing(std::unique_ptr<Task> &&_task, int _worker_id, WorkStealingPool *_pool)
+        : Task(0, 0, 1), task(std::move(_task)), worker_id(_worker_id), pool(_pool) {}
+
+    void sub_execute(size_t start, size_t end) override { task->sub_execute(start, end); }
+
+    /**
+     * @brief Execute batches until every queue in the pool is empty.
+     */
+    void execute() override {
+        std::pair<size_t, size_t> batch;
+        while (pool->next(worker_id, batch)) {
+            sub_execute(batch.first, batch.second);
+        }
+    }
+};
+
+}  // namespace orq::service
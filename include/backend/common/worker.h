@@ -42,6 +42,14 @@ class Worker {
         if (thread_.joinable()) {
             thread_.join();
         }
+
+        // Protocols refer to (and unregister their generators from) the randomness manager and
+        // the communicator, so destroy them first.
+        proto_8.reset();
+        proto_16.reset();
+        proto_32.reset();
+        proto_64.reset();
+        proto_128.reset();
     }
 
     void start() { thread_ = std::thread(&Worker::run, this); }
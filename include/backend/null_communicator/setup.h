@@ -28,7 +28,7 @@ namespace {
         // Setup dummy common PRG. Use seed of all zeros.
         auto zero_seed = std::vector<unsigned char>(crypto_aead_aes256gcm_KEYBYTES);
         std::unique_ptr<DeterministicPRGAlgorithm> prg_algorithm =
-            std::make_unique<orq::random::AESPRGAlgorithm>(zero_seed);
+            std::make_unique<orq::random::AESCTRPRGAlgorithm>(zero_seed);
         auto commonPRG = std::make_shared<orq::random::CommonPRG>(std::move(prg_algorithm), 0);
 
         // This fake common PRG applies to relative party 0 (ourself) as well as the
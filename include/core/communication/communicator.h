@@ -1,11 +1,24 @@
 #pragma once
 
+#include <limits>
+#include <type_traits>
+
 #include "core/containers/e_vector.h"
 #include "debug/orq_debug.h"
 
 namespace orq {
 typedef int PartyID;
 
+/**
+ * @brief Hint passed to the narrow transfer functions of `Communicator`: only
+ * the `bits` least significant bits of each element carry information. Sender
+ * and receiver must pass the same hint.
+ *
+ */
+struct SignificantBits {
+    int bits;
+};
+
 /**
  * @brief The base communicator class. All communicators must inherit from this
  * class.
@@ -21,6 +34,79 @@ class Communicator {
 
     size_t bytes_sent = 0;
 
+    /**
+     * @brief Whether a `bits`-bit hint saves anything for elements of type T.
+     *
+     */
+    template <typename T>
+    static bool is_narrow(const SignificantBits &width) {
+        return width.bits > 0 && width.bits < std::numeric_limits<std::make_unsigned_t<T>>::digits;
+    }
+
+    /**
+     * @brief Number of T words needed to hold `size` elements of `bits` bits.
+     *
+     */
+    template <typename T>
+    static size_t packed_size(const size_t &size, const int &bits) {
+        const size_t W = std::numeric_limits<std::make_unsigned_t<T>>::digits;
+        return (size * bits + W - 1) / W;
+    }
+
+    /**
+     * @brief Bit-pack the low `bits` bits of the first `size` elements of `x`.
+     * Element `i` occupies stream bits `[i * bits, (i + 1) * bits)`, and may
+     * straddle two words when `bits` does not divide the word size.
+     *
+     */
+    template <typename T>
+    static Vector<T> pack_bits(const Vector<T> &x, const size_t &size, const int &bits) {
+        using U = std::make_unsigned_t<T>;
+        const int W = std::numeric_limits<U>::digits;
+        const U mask = ((U)1 << bits) - 1;
+
+        Vector<T> packed(packed_size<T>(size, bits));
+        auto out = reinterpret_cast<U *>(packed.batch_span().data());
+
+        for (size_t i = 0; i < size; i++) {
+            U v = static_cast<U>(x[i]) & mask;
+            size_t pos = i * bits;
+            size_t w = pos / W;
+            int o = pos % W;
+            out[w] |= (U)(v << o);
+            if (o + bits > W) {
+                out[w + 1] |= (U)(v >> (W - o));
+            }
+        }
+        return packed;
+    }
+
+    /**
+     * @brief Inverse of `pack_bits`: expand `size` elements into `x`,
+     * zero-extending each to the full word.
+     *
+     */
+    template <typename T>
+    static void unpack_bits(const Vector<T> &packed, Vector<T> &x, const size_t &size,
+                            const int &bits) {
+        using U = std::make_unsigned_t<T>;
+        const int W = std::numeric_limits<U>::digits;
+        const U mask = ((U)1 << bits) - 1;
+
+        auto in = reinterpret_cast<const U *>(packed.batch_span().data());
+
+        for (size_t i = 0; i < size; i++) {
+            size_t pos = i * bits;
+            size_t w = pos / W;
+            int o = pos % W;
+            U v = in[w] >> o;
+            if (o + bits > W) {
+                v |= (U)(in[w + 1] << (W - o));
+            }
+            x[i] = static_cast<T>(v & mask);
+        }
+    }
+
    public:
     /**
      * Initializes the communicator base with the current party index.
@@ -180,6 +266,94 @@ class Communicator {
     virtual void exchangeShares(const std::vector<Vector<__int128_t>>& shares,
                                 std::vector<Vector<__int128_t>>& received_shares,
                                 std::vector<PartyID> to_id, std::vector<PartyID> from_id) = 0;
+
+    ////////////////////////////
+    /// Narrow-width transfers //
+    ////////////////////////////
+
+    // The functions below take a `SignificantBits` hint and bit-pack the
+    // elements before transmission, so a vector of single-bit shares costs
+    // one bit per element on the wire instead of a full word. The receiver
+    // zero-extends every element. They fall back to the plain transfers when
+    // the hint is not narrower than the element type.
+
+    /**
+     * Send a vector of `width.bits`-bit elements to a chosen party.
+     * @param shares The data elements to be sent to the party.
+     * @param id The index of the recipient party relative to the current party.
+     * @param size Number of data elements to be sent.
+     * @param width Number of significant bits per element.
+     */
+    template <typename T>
+    void sendShares(const Vector<T> &shares, PartyID id, size_t size, SignificantBits width) {
+        if (!is_narrow<T>(width)) {
+            sendShares(shares, id, size);
+            return;
+        }
+        auto packed = pack_bits(shares, size, width.bits);
+        sendShares(packed, id, packed.size());
+    }
+
+    /**
+     * Receive a vector of `width.bits`-bit elements from a chosen party.
+     * @param shares reference to vector to receive into
+     * @param id The index of the sending party relative to the current party.
+     * @param size Number of data elements to be received.
+     * @param width Number of significant bits per element.
+     */
+    template <typename T>
+    void receiveShares(Vector<T> &shares, PartyID id, size_t size, SignificantBits width) {
+        if (!is_narrow<T>(width)) {
+            receiveShares(shares, id, size);
+            return;
+        }
+        Vector<T> packed(packed_size<T>(size, width.bits));
+        receiveShares(packed, id, packed.size());
+        unpack_bits(packed, shares, size, width.bits);
+    }
+
+    /**
+     * Exchange vectors of `width.bits`-bit elements with the same party.
+     * @param sent_shares vector to send
+     * @param received_shares vector to receive into
+     * @param id The index of the other party relative to the current party.
+     * @param size Number of data elements to be sent and received.
+     * @param width Number of significant bits per element.
+     */
+    template <typename T>
+    void exchangeShares(Vector<T> sent_shares, Vector<T> &received_shares, PartyID id, size_t size,
+                        SignificantBits width) {
+        if (!is_narrow<T>(width)) {
+            exchangeShares(sent_shares, received_shares, id, size);
+            return;
+        }
+        auto packed = pack_bits(sent_shares, size, width.bits);
+        Vector<T> received(packed.size());
+        exchangeShares(packed, received, id, packed.size());
+        unpack_bits(received, received_shares, size, width.bits);
+    }
+
+    /**
+     * Exchange vectors of `width.bits`-bit elements with two different parties.
+     * @param sent_shares vector to send
+     * @param received_shares vector to receive into
+     * @param to_id relative ID of destination party
+     * @param from_id relative ID of source party
+     * @param size Number of data elements to be sent and received.
+     * @param width Number of significant bits per element.
+     */
+    template <typename T>
+    void exchangeShares(Vector<T> sent_shares, Vector<T> &received_shares, PartyID to_id,
+                        PartyID from_id, size_t size, SignificantBits width) {
+        if (!is_narrow<T>(width)) {
+            exchangeShares(sent_shares, received_shares, to_id, from_id, size);
+            return;
+        }
+        auto packed = pack_bits(sent_shares, size, width.bits);
+        Vector<T> received(packed.size());
+        exchangeShares(packed, received, to_id, from_id, packed.size());
+        unpack_bits(received, received_shares, size, width.bits);
+    }
 };
 
 }  // namespace orq
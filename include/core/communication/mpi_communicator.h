@@ -1,5 +1,9 @@
 #pragma once
 
+#include <limits>
+#include <span>
+#include <vector>
+
 #include "communicator.h"
 #include "communicator_factory.h"
 #include "debug/orq_debug.h"
@@ -85,6 +89,89 @@ class MPICommunicator : public Communicator {
 
     ~MPICommunicator() {}
 
+#if defined(MPC_USE_MPI_COMMUNICATOR)
+    /**
+     * @brief Post a nonblocking send or receive of words `[start, start + count)` of a Vector,
+     * where a word is one `MPI_type<T>::v` (half an element for 128-bit types). Mapped Vectors are
+     * not materialized: their runs of storage are described with an `hindexed` derived datatype,
+     * so MPI gathers from (or scatters into) the Vector's storage directly. The wire format is the
+     * same as for an unmapped Vector.
+     *
+     * @tparam T
+     * @param v
+     * @param start first word
+     * @param count number of words
+     * @param sending whether to post a send or a receive
+     * @param peer absolute party ID
+     * @param tag
+     * @param request
+     * @param types derived datatypes to free once the requests complete
+     */
+    template <typename T>
+    void post(const Vector<T> &v, size_t start, size_t count, bool sending, int peer, int tag,
+              MPI_Request *request, std::vector<MPI_Datatype> &types) {
+        constexpr size_t words = std::is_same_v<T, __int128_t> ? 2 : 1;
+        constexpr size_t word_bytes = sizeof(T) / words;
+
+        char *buffer = nullptr;
+        int n = count;
+        MPI_Datatype type = MPI_type<T>::v;
+
+        if (!v.has_mapping()) {
+            buffer = reinterpret_cast<char *>(const_cast<T *>(&v[0])) + start * word_bytes;
+        } else {
+            std::vector<std::span<T>> runs;
+            v.contiguous_runs(runs, std::numeric_limits<size_t>::max());
+
+            std::vector<int> lengths;
+            std::vector<MPI_Aint> displacements;
+            size_t skip = start, left = count;
+            for (auto &run : runs) {
+                if (left == 0) break;
+                size_t run_words = run.size() * words;
+                if (skip >= run_words) {
+                    skip -= run_words;
+                    continue;
+                }
+                size_t take = std::min(run_words - skip, left);
+                char *p = reinterpret_cast<char *>(run.data()) + skip * word_bytes;
+                if (buffer == nullptr) buffer = p;
+                lengths.push_back(take);
+                displacements.push_back(p - buffer);
+                skip = 0;
+                left -= take;
+            }
+
+            MPI_Type_create_hindexed(lengths.size(), lengths.data(), displacements.data(),
+                                     MPI_type<T>::v, &type);
+            MPI_Type_commit(&type);
+            types.push_back(type);
+            n = 1;
+        }
+
+        if (sending) {
+            MPI_Isend(buffer, n, type, peer, tag, MPI_COMM_WORLD, request);
+        } else {
+            MPI_Irecv(buffer, n, type, peer, tag, MPI_COMM_WORLD, request);
+        }
+    }
+
+    /**
+     * @brief Wait for all requests, then free the derived datatypes they used.
+     *
+     * @param requests
+     * @param types
+     */
+    static void complete(std::vector<MPI_Request> &requests, std::vector<MPI_Datatype> &types) {
+        for (size_t i = 0; i < requests.size(); ++i) {
+            MPI_Wait(&requests[i], MPI_STATUS_IGNORE);
+        }
+        for (auto &type : types) {
+            MPI_Type_free(&type);
+        }
+    }
+#endif
+
     template <typename T>
     void sendShare_impl(T share, PartyID _id) {
 #if defined(MPC_USE_MPI_COMMUNICATOR)
@@ -109,29 +196,23 @@ class MPICommunicator : public Communicator {
         bytes_sent += (sizeof(T) * _size);
         thread_stopwatch::InstrumentBlock _ib("comm");
         int to_ind = (numParties + _id + this->currentId) % numParties;
-        std::vector<MPI_Request> requests;
-
-        assert(!_shares.has_mapping());
+        std::vector<MPI_Request> requests(parallelism_factor);
+        std::vector<MPI_Datatype> types;
 
         if constexpr (std::is_same_v<T, __int128_t>) {
             _size *= 2;
         }
 
-        int start = 0;
+        size_t start = 0;
         size_t __size = _size / parallelism_factor;
         for (int i = 0; i < parallelism_factor; ++i) {
             size_t ___size = (i == parallelism_factor - 1) ? _size - start : __size;
 
-            requests.push_back(MPI_Request());
-
-            MPI_Isend(&_shares[start], ___size, MPI_type<T>::v, to_ind, msg_tag + i, MPI_COMM_WORLD,
-                      &requests[i]);
+            post(_shares, start, ___size, true, to_ind, msg_tag + i, &requests[i], types);
             start += ___size;
         }
 
-        for (size_t i = 0; i < requests.size(); ++i) {
-            MPI_Wait(&requests[i], MPI_STATUS_IGNORE);
-        }
+        complete(requests, types);
 #endif
     }
 
@@ -169,9 +250,8 @@ class MPICommunicator : public Communicator {
     void receiveShares_impl(Vector<T> &_shares, PartyID _id, size_t _size) {
 #if defined(MPC_USE_MPI_COMMUNICATOR)
         thread_stopwatch::InstrumentBlock _ib("comm");
-        std::vector<MPI_Request> requests;
-
-        assert(!_shares.has_mapping());
+        std::vector<MPI_Request> requests(parallelism_factor);
+        std::vector<MPI_Datatype> types;
 
         // Make sure we have enough room
         assert(_shares.size() >= _size);
@@ -186,16 +266,12 @@ class MPICommunicator : public Communicator {
         size_t __size = _size / parallelism_factor;
         for (size_t i = 0; i < parallelism_factor; ++i) {
             size_t ___size = (i == parallelism_factor - 1) ? _size - start : __size;
-            requests.push_back(MPI_Request());
 
-            MPI_Irecv(&_shares[start], ___size, MPI_type<T>::v, from_ind, msg_tag + i,
-                      MPI_COMM_WORLD, &requests[i]);
+            post(_shares, start, ___size, false, from_ind, msg_tag + i, &requests[i], types);
             start += ___size;
         }
 
-        for (size_t i = 0; i < requests.size(); ++i) {
-            MPI_Wait(&requests[i], MPI_STATUS_IGNORE);
-        }
+        complete(requests, types);
 #endif
     }
 
@@ -268,10 +344,9 @@ class MPICommunicator : public Communicator {
         int to_ind = (numParties + to_id + this->currentId) % numParties;
         int from_ind = (numParties + from_id + this->currentId) % numParties;
 
-        std::vector<MPI_Request> requests;
+        std::vector<MPI_Request> requests(2 * parallelism_factor);
+        std::vector<MPI_Datatype> types;
 
-        assert(!_shares.has_mapping());
-        assert(!received_shares.has_mapping());
         assert(received_shares.size() >= _size);
 
         if constexpr (std::is_same_v<T, __int128_t>) {
@@ -283,19 +358,13 @@ class MPICommunicator : public Communicator {
         for (size_t i = 0; i < parallelism_factor; ++i) {
             size_t ___size = (i == parallelism_factor - 1) ? _size - start : __size;
 
-            requests.push_back(MPI_Request());
-            requests.push_back(MPI_Request());
-
-            MPI_Irecv(&received_shares[start], ___size, MPI_type<T>::v, from_ind, msg_tag + i,
-                      MPI_COMM_WORLD, &requests[2 * i]);
-            MPI_Isend(&_shares[start], ___size, MPI_type<T>::v, to_ind, msg_tag + i, MPI_COMM_WORLD,
-                      &requests[2 * i + 1]);
+            post(received_shares, start, ___size, false, from_ind, msg_tag + i, &requests[2 * i],
+                 types);
+            post(_shares, start, ___size, true, to_ind, msg_tag + i, &requests[2 * i + 1], types);
             start += ___size;
         }
 
-        for (size_t i = 0; i < requests.size(); ++i) {
-            MPI_Wait(&requests[i], MPI_STATUS_IGNORE);
-        }
+        complete(requests, types);
 #endif
     }
 
@@ -337,17 +406,15 @@ class MPICommunicator : public Communicator {
             size_mul = 2;
         }
 
+        requests.resize(partyID.size());
+        std::vector<MPI_Datatype> types;
         for (size_t i = 0; i < partyID.size(); ++i) {
             int to_ind = (numParties + partyID[i] + this->currentId) % numParties;
-            requests.push_back(MPI_Request());
-            assert(!shares[i].has_mapping());
-            MPI_Isend(&shares[i][0], shares[i].size() * size_mul, MPI_type<T>::v, to_ind, msg_tag,
-                      MPI_COMM_WORLD, &requests[i]);
+            post(shares[i], 0, shares[i].size() * size_mul, true, to_ind, msg_tag, &requests[i],
+                 types);
         }
 
-        for (size_t i = 0; i < requests.size(); ++i) {
-            MPI_Wait(&requests[i], MPI_STATUS_IGNORE);
-        }
+        complete(requests, types);
 #endif
     }
 
@@ -389,17 +456,15 @@ class MPICommunicator : public Communicator {
             size_mul = 2;
         }
 
+        requests.resize(partyID.size());
+        std::vector<MPI_Datatype> types;
         for (size_t i = 0; i < partyID.size(); ++i) {
             int to_ind = (numParties + partyID[i] + this->currentId) % numParties;
-            requests.push_back(MPI_Request());
-            assert(!shares[i].has_mapping());
-            MPI_Irecv(&shares[i][0], shares[i].size() * size_mul, MPI_type<T>::v, to_ind, msg_tag,
-                      MPI_COMM_WORLD, &requests[i]);
+            post(shares[i], 0, shares[i].size() * size_mul, false, to_ind, msg_tag, &requests[i],
+                 types);
         }
 
-        for (size_t i = 0; i < requests.size(); ++i) {
-            MPI_Wait(&requests[i], MPI_STATUS_IGNORE);
-        }
+        complete(requests, types);
 #endif
     }
 
@@ -444,25 +509,21 @@ class MPICommunicator : public Communicator {
             size_mul = 2;
         }
 
+        requests.resize(from_id.size() + to_id.size());
+        std::vector<MPI_Datatype> types;
         for (size_t i = 0; i < from_id.size(); ++i) {
             int ind = (numParties + from_id[i] + this->currentId) % numParties;
-            requests.push_back(MPI_Request());
-            assert(!shares[i].has_mapping());
-            MPI_Isend(&shares[i][0], shares[i].size() * size_mul, MPI_type<T>::v, ind, msg_tag,
-                      MPI_COMM_WORLD, &requests.back());
+            post(shares[i], 0, shares[i].size() * size_mul, true, ind, msg_tag, &requests[i],
+                 types);
         }
 
         for (size_t i = 0; i < to_id.size(); ++i) {
             int ind = (numParties + to_id[i] + this->currentId) % numParties;
-            requests.push_back(MPI_Request());
-            assert(!received_shares[i].has_mapping());
-            MPI_Irecv(&received_shares[i][0], received_shares[i].size() * size_mul, MPI_type<T>::v,
-                      ind, msg_tag, MPI_COMM_WORLD, &requests.back());
+            post(received_shares[i], 0, received_shares[i].size() * size_mul, false, ind, msg_tag,
+                 &requests[from_id.size() + i], types);
         }
 
-        for (size_t i = 0; i < requests.size(); ++i) {
-            MPI_Wait(&requests[i], MPI_STATUS_IGNORE);
-        }
+        complete(requests, types);
 #endif
     }
 
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <limits.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
+#include <memory>
+#include <span>
 #include <unordered_map>
 
 #include "core/communication/communicator.h"
@@ -18,7 +22,31 @@ struct PartyInfoBasic {
 
     NoCopyRing sendRing;
 
+    // Send-thread state: bytes of the current ring entry already sent, and
+    // whether the socket is registered with the send thread's epoll instance
+    size_t sendOffset = 0;
+    bool sendPolled = false;
+
+    // Buffer that fragmented mapped Vectors are packed into before sending.
+    // Reused across sends; only touched again after the previous send is done.
+    std::unique_ptr<char[]> staging;
+    size_t stagingBytes = 0;
+
     PartyInfoBasic(int sockfd, int ringSize) : sockfd(sockfd), sendRing(ringSize) {}
+
+    /**
+     * @brief Get a staging buffer of at least `bytes` bytes.
+     *
+     * @param bytes
+     * @return char*
+     */
+    char* stagingBuffer(size_t bytes) {
+        if (bytes > stagingBytes) {
+            staging = std::make_unique<char[]>(bytes);
+            stagingBytes = bytes;
+        }
+        return staging.get();
+    }
 };
 
 namespace orq {
@@ -64,6 +92,149 @@ class NoCopyCommunicator : public Communicator {
 
     //////////////////// Generic Functions Begin ////////////////////
 
+    /**
+     * @brief Queue a Vector on a party's send ring without materializing it.
+     * Unmapped Vectors are a single entry. Mapped Vectors that break into a
+     * few long runs of storage are pushed as one entry per run, which the send
+     * thread gathers into a single `sendmsg`. Fragmented mappings are packed
+     * into the party's staging buffer chunk by chunk, and each chunk is pushed
+     * as soon as it is packed, so earlier chunks are already on the wire while
+     * later ones are being packed.
+     *
+     * Only the returned (last) push index may be waited on.
+     *
+     * @tparam T
+     * @param party destination party
+     * @param v the Vector to send
+     * @return int the push index of the last entry
+     */
+    template <typename T>
+    int pushVector(PartyInfoBasic& party, const Vector<T>& v) {
+        if (!v.has_mapping()) {
+            return party.sendRing.push(v);
+        }
+
+        size_t n = v.size();
+        if (n == 0) {
+            return party.sendRing.pushBytes(nullptr, 0);
+        }
+
+        // The ring is empty on entry, so this many pushes never block
+        const size_t max_entries = NOCOPY_COMMUNICATOR_RING_SIZE - 1;
+
+        std::vector<std::span<T>> runs;
+        size_t max_runs = std::min(max_entries, n / COMMUNICATOR_MIN_RUN_ELEMENTS);
+        if (v.contiguous_runs(runs, max_runs)) {
+            int pushIndex = -1;
+            for (auto& run : runs) {
+                pushIndex = party.sendRing.pushBytes(reinterpret_cast<const char*>(run.data()),
+                                                     run.size_bytes());
+            }
+            return pushIndex;
+        }
+
+        T* packed = reinterpret_cast<T*>(party.stagingBuffer(n * sizeof(T)));
+        size_t chunk = std::max(NOCOPY_COMMUNICATOR_PACK_BYTES / sizeof(T),
+                                (n + max_entries - 1) / max_entries);
+        int pushIndex = -1;
+        for (size_t start = 0; start < n; start += chunk) {
+            size_t end = std::min(n, start + chunk);
+            for (size_t i = start; i < end; i++) {
+                packed[i] = v[i];
+            }
+            pushIndex = party.sendRing.pushBytes(reinterpret_cast<const char*>(packed + start),
+                                                 (end - start) * sizeof(T));
+        }
+        return pushIndex;
+    }
+
+    /**
+     * @brief Receive exactly `bytes` bytes from a socket.
+     *
+     * @param sockfd
+     * @param buffer
+     * @param bytes
+     */
+    static void recvFully(int sockfd, char* buffer, size_t bytes) {
+        size_t bytesProcessed = 0;
+        while (bytesProcessed < bytes) {
+            ssize_t receivedBytes =
+                recv(sockfd, buffer + bytesProcessed, bytes - bytesProcessed, 0);
+
+            if (receivedBytes > 0) {
+                bytesProcessed += receivedBytes;
+            } else {
+                break;
+            }
+        }
+    }
+
+    /**
+     * @brief Receive `_size` elements from a socket directly into a Vector.
+     * Mapped Vectors are filled in place: long runs of storage are received
+     * with `recvmsg` scatter lists, and fragmented mappings are received in
+     * chunks that are scattered as they arrive.
+     *
+     * @tparam T
+     * @param sockfd
+     * @param v destination Vector
+     * @param _size number of elements to receive
+     */
+    template <typename T>
+    void recvVector(int sockfd, Vector<T>& v, size_t _size) {
+        if (!v.has_mapping()) {
+            recvFully(sockfd, reinterpret_cast<char*>(&v[0]), _size * sizeof(T));
+            return;
+        }
+
+        assert(_size == v.size());
+        if (_size == 0) {
+            return;
+        }
+
+        std::vector<std::span<T>> runs;
+        if (v.contiguous_runs(runs, _size / COMMUNICATOR_MIN_RUN_ELEMENTS)) {
+            std::vector<struct iovec> iov(runs.size());
+            for (size_t k = 0; k < runs.size(); k++) {
+                iov[k] = {runs[k].data(), runs[k].size_bytes()};
+            }
+
+            size_t first = 0;
+            while (first < iov.size()) {
+                struct msghdr msg = {};
+                msg.msg_iov = iov.data() + first;
+                msg.msg_iovlen = std::min<size_t>(iov.size() - first, IOV_MAX);
+
+                ssize_t receivedBytes = recvmsg(sockfd, &msg, 0);
+                if (receivedBytes <= 0) {
+                    break;
+                }
+
+                // Skip the filled runs and advance into a partially-filled one
+                size_t r = receivedBytes;
+                while (first < iov.size() && r >= iov[first].iov_len) {
+                    r -= iov[first].iov_len;
+                    first++;
+                }
+                if (first < iov.size()) {
+                    iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + r;
+                    iov[first].iov_len -= r;
+                }
+            }
+            return;
+        }
+
+        size_t chunk = std::min(_size, NOCOPY_COMMUNICATOR_PACK_BYTES / sizeof(T));
+        std::vector<T> buffer(chunk);
+        for (size_t start = 0; start < _size; start += chunk) {
+            size_t end = std::min(_size, start + chunk);
+            recvFully(sockfd, reinterpret_cast<char*>(buffer.data()), (end - start) * sizeof(T));
+            for (size_t i = start; i < end; i++) {
+                v[i] = buffer[i - start];
+            }
+        }
+    }
+
     /**
      * @brief Generic function to print a string along with a type
      *
@@ -132,11 +303,9 @@ class NoCopyCommunicator : public Communicator {
         int to_id =
             (numParties + _id + this->currentId) % numParties;  // Convert relative ID to PartyID
 
-        assert(!_shares.has_mapping());
-
         printType<T>("sendSharesVector", "To: " + std::to_string(to_id));
 
-        int pushIndex = get_party(to_id).sendRing.push(_shares);
+        int pushIndex = pushVector(get_party(to_id), _shares);
 
         get_party(to_id).sendRing.wait(pushIndex);
 #endif
@@ -186,28 +355,9 @@ class NoCopyCommunicator : public Communicator {
         int from_id =
             (numParties + _id + this->currentId) % numParties;  // Convert relative ID to PartyID
 
-        assert(!_shareVector.has_mapping());
-
         printType<T>("receiveSharesVector", "From: " + std::to_string(from_id));
 
-        int sockfd = get_party(from_id).sockfd;
-
-        size_t totalBytes = _size * sizeof(T);
-        size_t bytesProcessed = 0;
-
-        while (bytesProcessed < totalBytes) {
-            size_t remainingBytes = totalBytes - bytesProcessed;
-
-            char* dataPtr = reinterpret_cast<char*>(&_shareVector[0]) + bytesProcessed;
-
-            ssize_t receivedBytes = recv(sockfd, dataPtr, remainingBytes, 0);
-
-            if (receivedBytes > 0) {
-                bytesProcessed += receivedBytes;
-            } else {
-                break;
-            }
-        }
+        recvVector(get_party(from_id).sockfd, _shareVector, _size);
 #endif
     }
 
@@ -234,32 +384,12 @@ class NoCopyCommunicator : public Communicator {
         int to_id = (numParties + _to_id + this->currentId) % numParties;
         int from_id = (numParties + _from_id + this->currentId) % numParties;
 
-        assert(!sent_shares.has_mapping());
-        assert(!received_shares.has_mapping());
-
         printType<T>("exchangeShares",
                      "To: " + std::to_string(to_id) + " | From: " + std::to_string(from_id));
 
-        int pushIndex = get_party(to_id).sendRing.push(sent_shares);
+        int pushIndex = pushVector(get_party(to_id), sent_shares);
 
-        size_t totalBytes = _size * sizeof(T);
-        size_t bytesProcessed = 0;
-
-        int sockfd = get_party(from_id).sockfd;
-
-        while (bytesProcessed < totalBytes) {
-            size_t remainingBytes = totalBytes - bytesProcessed;
-
-            char* dataPtr = reinterpret_cast<char*>(&received_shares[0]) + bytesProcessed;
-
-            ssize_t receivedBytes = recv(sockfd, dataPtr, remainingBytes, 0);
-
-            if (receivedBytes > 0) {
-                bytesProcessed += receivedBytes;
-            } else {
-                break;
-            }
-        }
+        recvVector(get_party(from_id).sockfd, received_shares, _size);
 
         get_party(to_id).sendRing.wait(pushIndex);
 #endif
@@ -283,7 +413,6 @@ class NoCopyCommunicator : public Communicator {
         std::vector<int> pushIndices(shares.size());
         for (int party_idx = 0; party_idx < partyID.size(); ++party_idx) {
             printType<T>("SendingMultipleVectors", "To: " + std::to_string(partyID[party_idx]));
-            assert(!shares[party_idx].has_mapping());
 
             auto size = shares[party_idx].size();
             bytes_sent += (sizeof(T) * size);
@@ -292,7 +421,7 @@ class NoCopyCommunicator : public Communicator {
             int to_id = (numParties + partyID[party_idx] + this->currentId) % numParties;
 
             // Push the shares to the send ring
-            pushIndices[party_idx] = get_party(to_id).sendRing.push(shares[party_idx]);
+            pushIndices[party_idx] = pushVector(get_party(to_id), shares[party_idx]);
         }
 
         for (int party_idx = 0; party_idx < partyID.size(); ++party_idx) {
@@ -326,35 +455,8 @@ class NoCopyCommunicator : public Communicator {
             // Convert relative ID to PartyID
             int from_id = (numParties + partyID[party_idx] + this->currentId) % numParties;
 
-            int sockfd = get_party(from_id).sockfd;
-
-            auto size = shares[party_idx].size();
-
-            size_t totalBytes = size * sizeof(T);
-            size_t bytesProcessed = 0;
-
-            assert(!shares[party_idx].has_mapping());
-
-            std::vector<T> temp_recv_vector(size);
-
-            while (bytesProcessed < totalBytes) {
-                size_t remainingBytes = totalBytes - bytesProcessed;
-                size_t bytesToCopy = std::min(remainingBytes, SOCKET_COMMUNICATOR_BUFFER_SIZE);
-
-                char* dataPtr = reinterpret_cast<char*>(temp_recv_vector.data()) + bytesProcessed;
-
-                ssize_t receivedBytes = recv(sockfd, dataPtr, bytesToCopy, 0);
-
-                if (receivedBytes > 0) {
-                    bytesProcessed += receivedBytes;
-                } else {
-                    break;
-                }
-            }
-
-            for (size_t i = 0; i < shares[party_idx].size(); i++) {
-                shares[party_idx][i] = temp_recv_vector[i];
-            }
+            // Received in place, including into mapped Vectors
+            recvVector(get_party(from_id).sockfd, shares[party_idx], shares[party_idx].size());
         }
 #endif
     }
@@ -382,7 +484,6 @@ class NoCopyCommunicator : public Communicator {
         std::vector<int> pushIndices(shares.size());
         for (int party_idx = 0; party_idx < to_id.size(); ++party_idx) {
             printType<T>("SendingMultipleVectors", "To: " + std::to_string(to_id[party_idx]));
-            assert(!shares[party_idx].has_mapping());
 
             auto size = shares[party_idx].size();
             bytes_sent += (sizeof(T) * size);
@@ -391,7 +492,7 @@ class NoCopyCommunicator : public Communicator {
             int ind = (numParties + to_id[party_idx] + this->currentId) % numParties;
 
             // Push the shares to the send ring
-            pushIndices[party_idx] = get_party(ind).sendRing.push(shares[party_idx]);
+            pushIndices[party_idx] = pushVector(get_party(ind), shares[party_idx]);
         }
 
         // Now, let's receive the shares
@@ -1,5 +1,12 @@
 #pragma once
 
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <cerrno>
+
 #include "backend/nocopy_communicator/startmpc/startmpc.h"
 #include "core/communication/communicator.h"
 #include "core/communication/communicator_factory.h"
@@ -17,8 +24,63 @@ namespace service {
 namespace {
 #if defined(MPC_USE_NO_COPY_COMMUNICATOR)
     /**
-     * @brief Function executed by each `nocopy` send thread. Continuously get
-     * entries off the ring buffer and send them out.
+     * @brief Send as much of a party's ring as the socket accepts without
+     * blocking. Up to `NOCOPY_COMMUNICATOR_MAX_IOV` queued entries are
+     * gathered into a single `sendmsg`; fully-sent entries are popped.
+     *
+     * @param party the destination party's ring and socket
+     * @return int 1 if data was sent, 0 if the ring is empty, -1 if the socket
+     * would block
+     */
+    int send_ring_nonblocking(PartyInfoBasic& party) {
+        auto& ring = party.sendRing;
+        int n = std::min(ring.count(), NOCOPY_COMMUNICATOR_MAX_IOV);
+        if (n == 0) {
+            return 0;
+        }
+
+        struct iovec iov[NOCOPY_COMMUNICATOR_MAX_IOV];
+        size_t offset = party.sendOffset;
+        for (int k = 0; k < n; k++) {
+            NoCopyRingEntry* entry = ring.entryAt(k);
+            iov[k].iov_base = const_cast<char*>(entry->buffer) + offset;
+            iov[k].iov_len = entry->buffer_size - offset;
+            offset = 0;
+        }
+
+        struct msghdr msg = {};
+        msg.msg_iov = iov;
+        msg.msg_iovlen = n;
+
+        ssize_t r = sendmsg(party.sockfd, &msg, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (r < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                return -1;
+            }
+            throw std::runtime_error("send_ring_nonblocking: Send failed");
+        }
+
+        // Retire the entries that went out completely
+        size_t sent = party.sendOffset + r;
+        for (int k = 0; k < n; k++) {
+            NoCopyRingEntry* entry = ring.currentEntry();
+            if (sent < entry->buffer_size) {
+                break;
+            }
+            sent -= entry->buffer_size;
+            ring.pop(entry);
+        }
+        party.sendOffset = sent;
+
+        return 1;
+    }
+
+    /**
+     * @brief Function executed by each `nocopy` send thread. Sends queued ring
+     * entries with non-blocking, batched writes, and sleeps in `epoll_wait`
+     * whenever there is nothing to do. The thread is woken by the rings'
+     * doorbell (an eventfd written on every push) or by a blocked socket
+     * becoming writable.
      *
      * @param rank party ID of this node.
      * @param communicator_index_list a list mapping worker threads to
@@ -42,26 +104,84 @@ namespace {
                 service::runTime->workers[communicator_index_list[i]].getCommunicator()));
         }
 
+        int doorbell = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        int epfd = epoll_create1(EPOLL_CLOEXEC);
+        if (doorbell < 0 || epfd < 0) {
+            throw std::runtime_error("send_communication_thread: epoll setup failed");
+        }
+
+        struct epoll_event ev = {};
+        ev.events = EPOLLIN;
+        ev.data.fd = doorbell;
+        if (epoll_ctl(epfd, EPOLL_CTL_ADD, doorbell, &ev) < 0) {
+            throw std::runtime_error("send_communication_thread: epoll_ctl failed on the doorbell");
+        }
+
+        // Pushes made before this point are picked up by the first sweep
+        for (auto* communicator : communicator_list) {
+            for (int j = 0; j < host_count; j++) {
+                if (j == rank) continue;
+                communicator->get_party(j).sendRing.setDoorbell(doorbell);
+            }
+        }
+
+        struct epoll_event events[NOCOPY_COMMUNICATOR_MAX_IOV];
+
         // Terminate when service::runTime exits
         while (service::RunTimeRunning()) {
-            for (auto* communicator : communicator_list) {
-                for (int j = 0; j < host_count; j++) {
-                    if (j == rank) continue;
-
-                    auto& partyInfo = communicator->get_party(j);
-                    if (!partyInfo.sendRing.isRingEmpty()) {
-                        NoCopyRingEntry* entry = partyInfo.sendRing.currentEntry();
-                        size_t r =
-                            send_wrapper(partyInfo.sockfd, entry->buffer, entry->buffer_size);
-                        assert(r == entry->buffer_size);
-                        partyInfo.sendRing.pop(entry);
+            // Sweep all rings until no more progress can be made
+            bool progress = true;
+            while (progress) {
+                progress = false;
+                for (auto* communicator : communicator_list) {
+                    for (int j = 0; j < host_count; j++) {
+                        if (j == rank) continue;
+
+                        auto& partyInfo = communicator->get_party(j);
+                        int status = send_ring_nonblocking(partyInfo);
+                        if (status > 0) {
+                            progress = true;
+                        } else if (status < 0) {
+                            // Wake up once the socket drains
+                            struct epoll_event out = {};
+                            out.events = EPOLLOUT | EPOLLONESHOT;
+                            out.data.fd = partyInfo.sockfd;
+                            if (epoll_ctl(epfd,
+                                          partyInfo.sendPolled ? EPOLL_CTL_MOD : EPOLL_CTL_ADD,
+                                          partyInfo.sockfd, &out) < 0) {
+                                throw std::runtime_error(
+                                    "send_communication_thread: epoll_ctl failed on a socket");
+                            }
+                            partyInfo.sendPolled = true;
+                        }
                     }
-
-                    if (!service::RunTimeRunning()) return;
                 }
-                if (!service::RunTimeRunning()) return;
+                if (!service::RunTimeRunning()) break;
+            }
+
+            // Sleep until a push or a writable socket; the timeout only bounds
+            // how long shutdown takes to notice.
+            if (epoll_wait(epfd, events, NOCOPY_COMMUNICATOR_MAX_IOV,
+                           SOCKET_COMMUNICATOR_WAIT_MS) < 0 &&
+                errno != EINTR) {
+                throw std::runtime_error("send_communication_thread: epoll_wait failed");
+            }
+
+            // Reset the doorbell; it is non-blocking, so EAGAIN only means there were no pushes
+            eventfd_t pushes;
+            if (eventfd_read(doorbell, &pushes) < 0 && errno != EAGAIN) {
+                throw std::runtime_error("send_communication_thread: eventfd_read failed");
+            }
+        }
+
+        for (auto* communicator : communicator_list) {
+            for (int j = 0; j < host_count; j++) {
+                if (j == rank) continue;
+                communicator->get_party(j).sendRing.setDoorbell(-1);
             }
         }
+        close(epfd);
+        close(doorbell);
     }
 
     /**
@@ -1,3 +1,7 @@
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <atomic>
 #include <chrono>
 #include <cstring>
 #include <iostream>
@@ -24,6 +28,10 @@ struct NoCopyRingEntry {
  * read index cannot be incremented, the buffer is empty. If the write index
  * cannot be incremented, the buffer is full.
  *
+ * Threads never spin on the indices: producers and waiters block on the
+ * atomics (`std::atomic::wait`), and every push rings an optional doorbell
+ * (an eventfd) so the send thread can sleep in `epoll_wait` while idle.
+ *
  */
 class NoCopyRing {
     // NOTE: these should be implemented as lock-free atomics.
@@ -33,6 +41,9 @@ class NoCopyRing {
     int ring_size;
     NoCopyRingEntry* ring_array;
 
+    // eventfd signalled on every push, or -1
+    std::atomic<int> doorbell = -1;
+
    public:
     NoCopyRing(int);
     ~NoCopyRing();
@@ -43,11 +54,16 @@ class NoCopyRing {
     int nextIndex(int) const;
     bool isRingFull() const;
     bool isRingEmpty() const;
+    int count() const;
+
+    void setDoorbell(int);
 
     template <typename T>
     int push(const orq::Vector<T>&);
+    int pushBytes(const char*, size_t);
 
     NoCopyRingEntry* currentEntry() const;
+    NoCopyRingEntry* entryAt(int) const;
 
     void pop(NoCopyRingEntry*);
 
@@ -96,6 +112,20 @@ bool NoCopyRing::isRingFull() const { return nextIndex(writeIndex) == readIndex;
  */
 bool NoCopyRing::isRingEmpty() const { return writeIndex == readIndex; }
 
+/**
+ * @brief The number of entries waiting to be sent.
+ *
+ * @return int
+ */
+int NoCopyRing::count() const { return (writeIndex - readIndex + ring_size) % ring_size; }
+
+/**
+ * @brief Set the eventfd to signal after each push.
+ *
+ * @param fd
+ */
+void NoCopyRing::setDoorbell(int fd) { doorbell = fd; }
+
 /**
  * @brief Push a (pointer to a) Vector onto the buffer. Be careful about data
  * lifetimes: if the passed vectorData goes out of scope in the caller,
@@ -113,21 +143,38 @@ int NoCopyRing::push(const orq::Vector<T>& vectorData) {
                       std::is_same<T, __int128_t>::value,
                   "Ring::push: Invalid type");
 
+    return pushBytes(reinterpret_cast<const char*>(&vectorData[0]), vectorData.size() * sizeof(T));
+}
+
+/**
+ * @brief Push a raw byte range onto the buffer. The same lifetime rules as
+ * `push` apply: the bytes must stay valid and unmodified until they are sent.
+ *
+ * @param buffer
+ * @param bytes
+ * @return int
+ */
+int NoCopyRing::pushBytes(const char* buffer, size_t bytes) {
     int pushIndex;
-    size_t totalBytes = vectorData.size() * sizeof(T);
 
-    while (isRingFull()) {
+    // Block while ring is full. The read index is loaded once per check, and `wait` only sleeps
+    // while it still has that value, so a pop between the check and the wait is not missed.
+    for (uint32_t r = readIndex; nextIndex(writeIndex) == (int)r; r = readIndex) {
+        readIndex.wait(r);
     }
 
-    const auto dataPtr = &vectorData[0];
-
-    ring_array[writeIndex].buffer = reinterpret_cast<const char*>(dataPtr);
-    ring_array[writeIndex].buffer_size = totalBytes;
+    ring_array[writeIndex].buffer = buffer;
+    ring_array[writeIndex].buffer_size = bytes;
 
     pushIndex = writeIndex;
 
     // TODO: Switch to proper atomic increment?
     writeIndex = nextIndex(writeIndex);
+    writeIndex.notify_all();
+
+    if (int fd = doorbell; fd >= 0) {
+        eventfd_write(fd, 1);
+    }
 
     return pushIndex;
 }
@@ -139,8 +186,9 @@ int NoCopyRing::push(const orq::Vector<T>& vectorData) {
  * @return NoCopyRingEntry*
  */
 NoCopyRingEntry* NoCopyRing::currentEntry() const {
-    // Block while ring is empty
-    while (isRingEmpty()) {
+    // Block while ring is empty (see `pushBytes`)
+    for (uint32_t w = writeIndex; w == readIndex; w = writeIndex) {
+        writeIndex.wait(w);
     }
 
     NoCopyRingEntry* entry = &(ring_array[readIndex]);
@@ -148,14 +196,26 @@ NoCopyRingEntry* NoCopyRing::currentEntry() const {
     return entry;
 }
 
+/**
+ * @brief Return a pointer to the entry `k` places after the read index. The
+ * caller must ensure that `k < count()`.
+ *
+ * @param k
+ * @return NoCopyRingEntry*
+ */
+NoCopyRingEntry* NoCopyRing::entryAt(int k) const {
+    return &(ring_array[(readIndex + k) % ring_size]);
+}
+
 /**
  * @brief Remove the first element (at readIndex) from the ring buffer.
  *
  * @param entry
  */
 void NoCopyRing::pop(NoCopyRingEntry* entry) {
-    // Block while ring is empty
-    while (isRingEmpty()) {
+    // Block while ring is empty (see `pushBytes`)
+    for (uint32_t w = writeIndex; w == readIndex; w = writeIndex) {
+        writeIndex.wait(w);
     }
 
     NoCopyRingEntry* currEntry = &(ring_array[readIndex]);
@@ -171,6 +231,7 @@ void NoCopyRing::pop(NoCopyRingEntry* entry) {
     // Increment read index
     // TODO: Switch to proper atomic increment?
     readIndex = nextIndex(readIndex);
+    readIndex.notify_all();
 }
 
 /**
@@ -180,6 +241,7 @@ void NoCopyRing::pop(NoCopyRingEntry* entry) {
  */
 void NoCopyRing::wait(int pushIndex) const {
     // Wait until the read index crosses the index at which the data was pushed
-    while (readIndex != nextIndex(pushIndex)) {
+    for (uint32_t r = readIndex; r != nextIndex(pushIndex); r = readIndex) {
+        readIndex.wait(r);
     }
 }
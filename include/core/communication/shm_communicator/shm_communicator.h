@@ -0,0 +1,592 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "core/communication/communicator.h"
+#include "debug/orq_debug.h"
+#include "shm_ring.h"
+
+namespace orq {
+
+/**
+ * @brief An in-flight transfer between user memory and a shared-memory ring:
+ * the byte ranges still to be written (or read), in order.
+ *
+ */
+struct ShmTransfer {
+    ShmRing* ring;
+    std::vector<std::span<char>> segments;
+    size_t next = 0;
+
+    bool done() const { return next == segments.size(); }
+};
+
+/**
+ * @brief Contiguous buffers for mapped Vectors too fragmented to transfer in
+ * place. Outgoing Vectors are packed when the transfer is set up; incoming
+ * ones are scattered to their destinations once it completes.
+ *
+ * @tparam T
+ */
+template <typename T>
+struct ShmStaging {
+    std::vector<std::vector<T>> buffers;
+    std::vector<std::pair<Vector<T>*, size_t>> scatter;
+
+    void unpack() {
+        for (auto& [dst, b] : scatter) {
+            auto& buffer = buffers[b];
+            for (size_t i = 0; i < buffer.size(); i++) {
+                (*dst)[i] = buffer[i];
+            }
+        }
+    }
+};
+
+/**
+ * @brief Shared-memory communicator for parties running on the same host.
+ * Each ORQ thread owns one SPSC ring per ordered pair of parties: it writes
+ * into its outgoing ring for every peer and reads from the peer's ring
+ * towards it. A contiguous `Vector` is moved with a single `memcpy` into the
+ * ring and a single `memcpy` out (two when the ring wraps); there are no
+ * sockets, system calls, or communication threads on the fast path. Mapped
+ * Vectors are copied run by run straight from (or into) their storage.
+ *
+ * All operations drive their sends and receives together until both finish,
+ * so exchanges larger than the ring never deadlock on a full ring.
+ *
+ */
+class SharedMemoryCommunicator : public Communicator {
+   public:
+    /**
+     * @brief Construct a new Shared Memory Communicator
+     *
+     * @param _currentId party ID of this node
+     * @param sendRings rings towards each party, indexed by party ID. The
+     * entry for `_currentId` is ignored.
+     * @param receiveRings rings from each party, indexed by party ID
+     * @param _numParties The number of parties in this execution
+     */
+    SharedMemoryCommunicator(const int& _currentId,
+                             std::vector<std::unique_ptr<ShmRing>> sendRings,
+                             std::vector<std::unique_ptr<ShmRing>> receiveRings,
+                             const int& _numParties)
+        : Communicator(_currentId),
+          numParties(_numParties),
+          _send_rings(std::move(sendRings)),
+          _receive_rings(std::move(receiveRings)) {}
+
+    //////////////////// Generic Functions Begin ////////////////////
+
+    /**
+     * @brief Move data between user memory and rings until every transfer is
+     * complete. Spins briefly when stalled, then sleeps on a pending ring.
+     *
+     * @param sends transfers from user memory into rings
+     * @param receives transfers from rings into user memory
+     */
+    static void progress(std::span<ShmTransfer> sends, std::span<ShmTransfer> receives) {
+        int spins = 0;
+        while (true) {
+            bool done = true;
+            bool moved = false;
+
+            auto step = [&](ShmTransfer& t, bool sending) {
+                while (!t.done()) {
+                    auto& segment = t.segments[t.next];
+                    size_t n = sending ? t.ring->write(segment.data(), segment.size())
+                                       : t.ring->read(segment.data(), segment.size());
+                    moved |= n > 0;
+                    segment = segment.subspan(n);
+                    if (!segment.empty()) {
+                        break;
+                    }
+                    t.next++;
+                }
+                done &= t.done();
+            };
+            for (auto& s : sends) step(s, true);
+            for (auto& r : receives) step(r, false);
+
+            if (done) {
+                return;
+            }
+            if (moved || ++spins < SHM_COMMUNICATOR_SPIN) {
+                if (moved) spins = 0;
+                continue;
+            }
+
+            // Stalled: sleep on the first pending receive, or else on the
+            // first pending send
+            spins = 0;
+            auto pending = std::find_if(receives.begin(), receives.end(),
+                                        [](auto& t) { return !t.done(); });
+            if (pending != receives.end()) {
+                pending->ring->waitReadable();
+                continue;
+            }
+            std::find_if(sends.begin(), sends.end(), [](auto& t) {
+                return !t.done();
+            })->ring->waitWritable();
+        }
+    }
+
+    /**
+     * @brief Set up the transfer of the first `_size` elements of a Vector.
+     * Unmapped Vectors are one segment, mapped Vectors with long runs are one
+     * segment per run, and fragmented mappings go through a staging buffer.
+     *
+     * @tparam T
+     * @param ring
+     * @param v
+     * @param _size number of elements
+     * @param staging staging buffers for this operation
+     * @param sending whether `v` is being sent (packed now) or received
+     * (scattered after the transfer)
+     * @return ShmTransfer
+     */
+    template <typename T>
+    static ShmTransfer transferOf(ShmRing& ring, Vector<T>& v, size_t _size,
+                                  ShmStaging<T>& staging, bool sending) {
+        ShmTransfer t = {&ring};
+        if (_size == 0) {
+            return t;
+        }
+        if (!v.has_mapping()) {
+            t.segments.emplace_back(reinterpret_cast<char*>(&v[0]), sizeof(T) * _size);
+            return t;
+        }
+
+        assert(_size == v.size());
+
+        std::vector<std::span<T>> runs;
+        if (v.contiguous_runs(runs, _size / COMMUNICATOR_MIN_RUN_ELEMENTS)) {
+            for (auto& run : runs) {
+                t.segments.emplace_back(reinterpret_cast<char*>(run.data()), run.size_bytes());
+            }
+            return t;
+        }
+
+        auto& buffer = staging.buffers.emplace_back(_size);
+        if (sending) {
+            for (size_t i = 0; i < _size; i++) {
+                buffer[i] = v[i];
+            }
+        } else {
+            staging.scatter.push_back({&v, staging.buffers.size() - 1});
+        }
+        t.segments.emplace_back(reinterpret_cast<char*>(buffer.data()), sizeof(T) * _size);
+        return t;
+    }
+
+    /**
+     * @brief Send a single generic share.
+     *
+     * @tparam T type of the share
+     * @param share
+     * @param _id relative destination party
+     */
+    template <typename T>
+    void sendShareGeneric(T share, PartyID _id) {
+        bytes_sent += sizeof(T);
+        thread_stopwatch::InstrumentBlock _ib("comm");
+
+        int to_id = (numParties + _id + this->currentId) % numParties;
+
+        ShmTransfer send = {&send_ring(to_id), {{reinterpret_cast<char*>(&share), sizeof(T)}}};
+        progress({&send, 1}, {});
+    }
+
+    /**
+     * @brief Send a shared vector.
+     *
+     * @tparam T underlying type of the shared vector
+     * @param _shares
+     * @param _id relative destination party. +1 is the next party, -1 is the
+     * previous.
+     * @param _size size of the vector
+     */
+    template <typename T>
+    void sendSharesGeneric(const Vector<T>& _shares, PartyID _id, size_t _size) {
+        bytes_sent += (sizeof(T) * _size);
+        thread_stopwatch::InstrumentBlock _ib("comm");
+
+        int to_id = (numParties + _id + this->currentId) % numParties;
+
+        // Shallow copy: the transfer only reads through it
+        Vector<T> shares = _shares;
+        ShmStaging<T> staging;
+        ShmTransfer send = transferOf(send_ring(to_id), shares, _size, staging, true);
+        progress({&send, 1}, {});
+    }
+
+    /**
+     * @brief Receive a single share.
+     *
+     * @tparam T
+     * @param _share
+     * @param _id relative source party
+     */
+    template <typename T>
+    void receiveShareGeneric(T& _share, PartyID _id) {
+        thread_stopwatch::InstrumentBlock _ib("comm");
+
+        int from_id = (numParties + _id + this->currentId) % numParties;
+
+        ShmTransfer receive = {&receive_ring(from_id),
+                               {{reinterpret_cast<char*>(&_share), sizeof(T)}}};
+        progress({}, {&receive, 1});
+    }
+
+    /**
+     * @brief Receive a shared vector.
+     *
+     * @tparam T underlying type of the shared vector
+     * @param _shareVector
+     * @param _id relative source party. +1 is the next party, -1 is the
+     * previous.
+     * @param _size number of elements to receive
+     */
+    template <typename T>
+    void receiveSharesGeneric(Vector<T>& _shareVector, PartyID _id, size_t _size) {
+        thread_stopwatch::InstrumentBlock _ib("comm");
+
+        int from_id = (numParties + _id + this->currentId) % numParties;
+
+        ShmStaging<T> staging;
+        ShmTransfer receive =
+            transferOf(receive_ring(from_id), _shareVector, _size, staging, false);
+        progress({}, {&receive, 1});
+        staging.unpack();
+    }
+
+    /**
+     * @brief Concurrently send and receive two vectors.
+     *
+     * @tparam T
+     * @param sent_shares
+     * @param received_shares
+     * @param _to_id relative destination party. +1 is the next party, -1 is the
+     * previous.
+     * @param _from_id relative source party
+     * @param _size number of elements in each vector
+     */
+    template <typename T>
+    void exchangeSharesGeneric(Vector<T> sent_shares, Vector<T>& received_shares, PartyID _to_id,
+                               PartyID _from_id, size_t _size) {
+        bytes_sent += (sizeof(T) * _size);
+        thread_stopwatch::InstrumentBlock _ib("comm");
+
+        int to_id = (numParties + _to_id + this->currentId) % numParties;
+        int from_id = (numParties + _from_id + this->currentId) % numParties;
+
+        ShmStaging<T> staging;
+        ShmTransfer send = transferOf(send_ring(to_id), sent_shares, _size, staging, true);
+        ShmTransfer receive =
+            transferOf(receive_ring(from_id), received_shares, _size, staging, false);
+        progress({&send, 1}, {&receive, 1});
+        staging.unpack();
+    }
+
+    /**
+     * @brief Send shares to multiple parties. `shares` and `partyID` must be
+     * vectors of the same length.
+     *
+     * @tparam T
+     * @param shares vector of Vectors; one for each party.
+     * @param partyID vector of relative party IDs to send to.
+     */
+    template <typename T>
+    void sendSharesGeneric(const std::vector<Vector<T>>& shares, std::vector<PartyID> partyID) {
+        thread_stopwatch::InstrumentBlock _ib("comm");
+
+        assert(shares.size() == partyID.size());
+
+        ShmStaging<T> staging;
+        std::vector<ShmTransfer> sends;
+        for (int party_idx = 0; party_idx < partyID.size(); ++party_idx) {
+            Vector<T> v = shares[party_idx];
+            bytes_sent += (sizeof(T) * v.size());
+            int to_id = (numParties + partyID[party_idx] + this->currentId) % numParties;
+            sends.push_back(transferOf(send_ring(to_id), v, v.size(), staging, true));
+        }
+        progress(sends, {});
+    }
+
+    /**
+     * @brief Receive shares from multiple parties. `shares` and `partyID` must
+     * be vectors of the same length.
+     *
+     * @tparam T
+     * @param shares vector of Vectors to receive into
+     * @param partyID relative source party IDs
+     */
+    template <typename T>
+    void receiveBroadcastGeneric(std::vector<Vector<T>>& shares, std::vector<PartyID> partyID) {
+        thread_stopwatch::InstrumentBlock _ib("comm");
+
+        assert(shares.size() == partyID.size());
+
+        ShmStaging<T> staging;
+        std::vector<ShmTransfer> receives;
+        for (int party_idx = 0; party_idx < partyID.size(); ++party_idx) {
+            auto& v = shares[party_idx];
+            int from_id = (numParties + partyID[party_idx] + this->currentId) % numParties;
+            receives.push_back(transferOf(receive_ring(from_id), v, v.size(), staging, false));
+        }
+        progress({}, receives);
+        staging.unpack();
+    }
+
+    /**
+     * @brief Exchange shares to and from multiple parties. `shares` and `to_id`
+     * must have the same length, as should `received_shares` and `from_id`.
+     *
+     * @tparam T
+     * @param shares vector of Vectors to send
+     * @param received_shares vector of Vectors to receive into
+     * @param to_id relative destination IDs
+     * @param from_id relative source IDs
+     */
+    template <typename T>
+    void exchangeSharesGeneric(const std::vector<Vector<T>>& shares,
+                               std::vector<Vector<T>>& received_shares, std::vector<PartyID> to_id,
+                               std::vector<PartyID> from_id) {
+        thread_stopwatch::InstrumentBlock _ib("comm");
+
+        assert(shares.size() == to_id.size());
+        assert(received_shares.size() == from_id.size());
+
+        ShmStaging<T> staging;
+        std::vector<ShmTransfer> sends;
+        for (int party_idx = 0; party_idx < to_id.size(); ++party_idx) {
+            Vector<T> v = shares[party_idx];
+            bytes_sent += (sizeof(T) * v.size());
+            int ind = (numParties + to_id[party_idx] + this->currentId) % numParties;
+            sends.push_back(transferOf(send_ring(ind), v, v.size(), staging, true));
+        }
+
+        std::vector<ShmTransfer> receives;
+        for (int party_idx = 0; party_idx < from_id.size(); ++party_idx) {
+            auto& v = received_shares[party_idx];
+            int ind = (numParties + from_id[party_idx] + this->currentId) % numParties;
+            receives.push_back(transferOf(receive_ring(ind), v, v.size(), staging, false));
+        }
+
+        progress(sends, receives);
+        staging.unpack();
+    }
+
+    ///////////////////// Generic Functions End /////////////////////
+
+    void sendShare(int8_t share, PartyID _id) { sendShareGeneric(share, _id); }
+
+    void sendShare(int16_t share, PartyID _id) { sendShareGeneric(share, _id); }
+
+    void sendShare(int32_t share, PartyID _id) { sendShareGeneric(share, _id); }
+
+    void sendShare(int64_t share, PartyID _id) { sendShareGeneric(share, _id); }
+
+    void sendShares(const Vector<int8_t>& _shares, PartyID _id, size_t _size) {
+        sendSharesGeneric(_shares, _id, _size);
+    }
+
+    void sendShares(const Vector<int16_t>& _shares, PartyID _id, size_t _size) {
+        sendSharesGeneric(_shares, _id, _size);
+    }
+
+    void sendShares(const Vector<int32_t>& _shares, PartyID _id, size_t _size) {
+        sendSharesGeneric(_shares, _id, _size);
+    }
+
+    void sendShares(const Vector<int64_t>& _shares, PartyID _id, size_t _size) {
+        sendSharesGeneric(_shares, _id, _size);
+    }
+
+    void sendShares(const Vector<__int128_t>& _shares, PartyID _id, size_t _size) {
+        sendSharesGeneric(_shares, _id, _size);
+    }
+
+    void receiveShare(int8_t& _share, PartyID _id) { receiveShareGeneric(_share, _id); }
+
+    void receiveShare(int16_t& _share, PartyID _id) { receiveShareGeneric(_share, _id); }
+
+    void receiveShare(int32_t& _share, PartyID _id) { receiveShareGeneric(_share, _id); }
+
+    void receiveShare(int64_t& _share, PartyID _id) { receiveShareGeneric(_share, _id); }
+
+    void receiveShares(Vector<int8_t>& _shareVector, PartyID _id, size_t _size) {
+        receiveSharesGeneric(_shareVector, _id, _size);
+    }
+
+    void receiveShares(Vector<int16_t>& _shareVector, PartyID _id, size_t _size) {
+        receiveSharesGeneric(_shareVector, _id, _size);
+    }
+
+    void receiveShares(Vector<int32_t>& _shareVector, PartyID _id, size_t _size) {
+        receiveSharesGeneric(_shareVector, _id, _size);
+    }
+
+    void receiveShares(Vector<int64_t>& _shareVector, PartyID _id, size_t _size) {
+        receiveSharesGeneric(_shareVector, _id, _size);
+    }
+
+    void receiveShares(Vector<__int128_t>& _shareVector, PartyID _id, size_t _size) {
+        receiveSharesGeneric(_shareVector, _id, _size);
+    }
+
+    void exchangeShares(Vector<int8_t> sent_shares, Vector<int8_t>& received_shares, PartyID _id,
+                        size_t _size) {
+        exchangeShares(sent_shares, received_shares, _id, _id, _size);
+    }
+
+    void exchangeShares(Vector<int16_t> sent_shares, Vector<int16_t>& received_shares, PartyID _id,
+                        size_t _size) {
+        exchangeShares(sent_shares, received_shares, _id, _id, _size);
+    }
+
+    void exchangeShares(Vector<int32_t> sent_shares, Vector<int32_t>& received_shares, PartyID _id,
+                        size_t _size) {
+        exchangeShares(sent_shares, received_shares, _id, _id, _size);
+    }
+
+    void exchangeShares(Vector<int64_t> sent_shares, Vector<int64_t>& received_shares, PartyID _id,
+                        size_t _size) {
+        exchangeShares(sent_shares, received_shares, _id, _id, _size);
+    }
+
+    void exchangeShares(Vector<__int128_t> sent_shares, Vector<__int128_t>& received_shares,
+                        PartyID _id, size_t _size) {
+        exchangeShares(sent_shares, received_shares, _id, _id, _size);
+    }
+
+    void exchangeShares(Vector<int8_t> sent_shares, Vector<int8_t>& received_shares, PartyID to_id,
+                        PartyID from_id, size_t _size) {
+        exchangeSharesGeneric(sent_shares, received_shares, to_id, from_id, _size);
+    }
+
+    void exchangeShares(Vector<int16_t> sent_shares, Vector<int16_t>& received_shares,
+                        PartyID to_id, PartyID from_id, size_t _size) {
+        exchangeSharesGeneric(sent_shares, received_shares, to_id, from_id, _size);
+    }
+
+    void exchangeShares(Vector<int32_t> sent_shares, Vector<int32_t>& received_shares,
+                        PartyID to_id, PartyID from_id, size_t _size) {
+        exchangeSharesGeneric(sent_shares, received_shares, to_id, from_id, _size);
+    }
+
+    void exchangeShares(Vector<int64_t> sent_shares, Vector<int64_t>& received_shares,
+                        PartyID to_id, PartyID from_id, size_t _size) {
+        exchangeSharesGeneric(sent_shares, received_shares, to_id, from_id, _size);
+    }
+
+    void exchangeShares(Vector<__int128_t> sent_shares, Vector<__int128_t>& received_shares,
+                        PartyID to_id, PartyID from_id, size_t _size) {
+        exchangeSharesGeneric(sent_shares, received_shares, to_id, from_id, _size);
+    }
+
+    void sendShares(const std::vector<Vector<int8_t>>& shares, std::vector<PartyID> partyID) {
+        sendSharesGeneric(shares, partyID);
+    }
+
+    void sendShares(const std::vector<Vector<int16_t>>& shares, std::vector<PartyID> partyID) {
+        sendSharesGeneric(shares, partyID);
+    }
+
+    void sendShares(const std::vector<Vector<int32_t>>& shares, std::vector<PartyID> partyID) {
+        sendSharesGeneric(shares, partyID);
+    }
+
+    void sendShares(const std::vector<Vector<int64_t>>& shares, std::vector<PartyID> partyID) {
+        sendSharesGeneric(shares, partyID);
+    }
+
+    void sendShares(const std::vector<Vector<__int128_t>>& shares, std::vector<PartyID> partyID) {
+        sendSharesGeneric(shares, partyID);
+    }
+
+    void receiveBroadcast(std::vector<Vector<int8_t>>& shares, std::vector<PartyID> partyID) {
+        receiveBroadcastGeneric(shares, partyID);
+    }
+
+    void receiveBroadcast(std::vector<Vector<int16_t>>& shares, std::vector<PartyID> partyID) {
+        receiveBroadcastGeneric(shares, partyID);
+    }
+
+    void receiveBroadcast(std::vector<Vector<int32_t>>& shares, std::vector<PartyID> partyID) {
+        receiveBroadcastGeneric(shares, partyID);
+    }
+
+    void receiveBroadcast(std::vector<Vector<int64_t>>& shares, std::vector<PartyID> partyID) {
+        receiveBroadcastGeneric(shares, partyID);
+    }
+
+    void receiveBroadcast(std::vector<Vector<__int128_t>>& shares, std::vector<PartyID> partyID) {
+        receiveBroadcastGeneric(shares, partyID);
+    }
+
+    void exchangeShares(const std::vector<Vector<int8_t>>& shares,
+                        std::vector<Vector<int8_t>>& received_shares, std::vector<PartyID> to_id,
+                        std::vector<PartyID> from_id) {
+        exchangeSharesGeneric(shares, received_shares, to_id, from_id);
+    }
+
+    void exchangeShares(const std::vector<Vector<int16_t>>& shares,
+                        std::vector<Vector<int16_t>>& received_shares, std::vector<PartyID> to_id,
+                        std::vector<PartyID> from_id) {
+        exchangeSharesGeneric(shares, received_shares, to_id, from_id);
+    }
+
+    void exchangeShares(const std::vector<Vector<int32_t>>& shares,
+                        std::vector<Vector<int32_t>>& received_shares, std::vector<PartyID> to_id,
+                        std::vector<PartyID> from_id) {
+        exchangeSharesGeneric(shares, received_shares, to_id, from_id);
+    }
+
+    void exchangeShares(const std::vector<Vector<int64_t>>& shares,
+                        std::vector<Vector<int64_t>>& received_shares, std::vector<PartyID> to_id,
+                        std::vector<PartyID> from_id) {
+        exchangeSharesGeneric(shares, received_shares, to_id, from_id);
+    }
+
+    void exchangeShares(const std::vector<Vector<__int128_t>>& shares,
+                        std::vector<Vector<__int128_t>>& received_shares,
+                        std::vector<PartyID> to_id, std::vector<PartyID> from_id) {
+        exchangeSharesGeneric(shares, received_shares, to_id, from_id);
+    }
+
+    /**
+     * @brief Get the ring towards the given (absolute) party.
+     *
+     * @param id
+     * @return ShmRing&
+     */
+    ShmRing& send_ring(int id) {
+        assert(id >= 0 && id < numParties);
+        assert(_send_rings[id] != nullptr);
+
+        return *_send_rings[id];
+    }
+
+    /**
+     * @brief Get the ring from the given (absolute) party.
+     *
+     * @param id
+     * @return ShmRing&
+     */
+    ShmRing& receive_ring(int id) {
+        assert(id >= 0 && id < numParties);
+        assert(_receive_rings[id] != nullptr);
+
+        return *_receive_rings[id];
+    }
+
+   private:
+    int numParties;
+    std::vector<std::unique_ptr<ShmRing>> _send_rings;
+    std::vector<std::unique_ptr<ShmRing>> _receive_rings;
+};
+}  // namespace orq
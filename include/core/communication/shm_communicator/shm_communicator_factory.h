@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstdlib>
+#include <string>
+
+#include "core/communication/communicator.h"
+#include "core/communication/communicator_factory.h"
+#include "shm_communicator.h"
+
+namespace orq {
+
+/**
+ * @brief Factory for the shared-memory communicator to interface with the
+ * `CommunicatorFactory` API.
+ *
+ * Parties are launched with `startmpc` in local mode, which exports
+ * `STARTMPC_HOST_RANK`, `STARTMPC_HOST_COUNT` and a per-launch random
+ * `STARTMPC_BASE_PORT`. The latter is used as a job identifier in the segment
+ * names, so concurrent local runs do not collide:
+ *
+ *     /orq-shm-<job>-<thread>-<from party>-<to party>
+ *
+ * Every party creates its outgoing rings, attaches to its incoming rings, and
+ * unlinks its outgoing segments once the peers have attached.
+ */
+class SharedMemoryCommunicatorFactory : public CommunicatorFactory<SharedMemoryCommunicatorFactory> {
+   public:
+    SharedMemoryCommunicatorFactory(int argc, char** argv, int numParties, int threadsNum)
+        : threadsNum_(threadsNum), numParties_(numParties) {
+        const char* host_count_env = std::getenv("STARTMPC_HOST_COUNT");
+        const char* host_rank_env = std::getenv("STARTMPC_HOST_RANK");
+        const char* job_env = std::getenv("STARTMPC_BASE_PORT");
+
+        int host_count = host_count_env ? std::atoi(host_count_env) : -1;
+        partyId_ = host_rank_env ? std::atoi(host_rank_env) : -1;
+        std::string job = job_env ? job_env : "0";
+
+        if (host_count != numParties_) {
+            throw std::runtime_error("Invalid host count provided for " +
+                                     std::to_string(numParties_) + "pc");
+        }
+        if (partyId_ < 0 || partyId_ >= numParties_) {
+            throw std::runtime_error("SharedMemoryCommunicatorFactory: Invalid party rank");
+        }
+
+        orq::benchmarking::stopwatch::partyID = partyId_;
+
+        auto segment = [&](int thread, int from, int to) {
+            return "/orq-shm-" + job + "-" + std::to_string(thread) + "-" + std::to_string(from) +
+                   "-" + std::to_string(to);
+        };
+
+        sendRings_.resize(threadsNum_);
+        receiveRings_.resize(threadsNum_);
+
+        // Create every outgoing ring before waiting on any incoming one
+        for (int t = 0; t < threadsNum_; t++) {
+            sendRings_[t].resize(numParties_);
+            for (int p = 0; p < numParties_; p++) {
+                if (p == partyId_) continue;
+                sendRings_[t][p] = std::make_unique<ShmRing>();
+                sendRings_[t][p]->create(segment(t, partyId_, p), SHM_COMMUNICATOR_RING_BYTES);
+            }
+        }
+
+        for (int t = 0; t < threadsNum_; t++) {
+            receiveRings_[t].resize(numParties_);
+            for (int p = 0; p < numParties_; p++) {
+                if (p == partyId_) continue;
+                receiveRings_[t][p] = std::make_unique<ShmRing>();
+                receiveRings_[t][p]->attach(segment(t, p, partyId_), SHM_COMMUNICATOR_RING_BYTES);
+            }
+        }
+
+        for (int t = 0; t < threadsNum_; t++) {
+            for (int p = 0; p < numParties_; p++) {
+                if (p == partyId_) continue;
+                sendRings_[t][p]->awaitAttachedAndUnlink();
+            }
+        }
+    }
+
+    std::unique_ptr<Communicator> create() {
+        static int instanceCount = 0;
+
+        // Create a new communicator instance
+        auto communicator = std::make_unique<SharedMemoryCommunicator>(
+            partyId_, std::move(sendRings_[instanceCount]),
+            std::move(receiveRings_[instanceCount]), numParties_);
+
+        // Increment the instance count for the next communicator
+        instanceCount++;
+
+        return communicator;
+    }
+
+    void start() {
+        // No communication threads: workers copy into and out of the rings
+    }
+
+    int getPartyId() const { return partyId_; }
+
+    int getNumParties() const { return numParties_; }
+
+    void blockingReady() {
+        // No additional setup needed for SharedMemoryCommunicator
+    }
+
+   private:
+    int partyId_;
+
+    const int threadsNum_;
+    const int numParties_;
+
+    /**
+     * @brief Rings for each ORQ thread, indexed by party ID:
+     *
+     * sendRings_[Thread #][Party ID] -> ring to that party
+     * receiveRings_[Thread #][Party ID] -> ring from that party
+     */
+    std::vector<std::vector<std::unique_ptr<ShmRing>>> sendRings_;
+    std::vector<std::vector<std::unique_ptr<ShmRing>>> receiveRings_;
+};
+
+}  // namespace orq
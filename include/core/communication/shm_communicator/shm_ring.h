@@ -0,0 +1,308 @@
+#pragma once
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "debug/orq_debug.h"
+
+/**
+ * @brief Control block at the start of every shared-memory ring segment. The
+ * producer and consumer indices live on separate cache lines so that the two
+ * processes do not false-share.
+ *
+ * `head` and `tail` count bytes written and read since the ring was created;
+ * the ring holds `head - tail` bytes. `dataSeq` and `spaceSeq` are futex words
+ * bumped whenever data is published or space is released, and the `*Waiters`
+ * counters let the other side skip the wake-up syscall when nobody sleeps.
+ */
+struct ShmRingControl {
+    alignas(64) std::atomic<uint32_t> ready;
+    std::atomic<uint32_t> attached;
+    uint64_t capacity;
+
+    alignas(64) std::atomic<uint64_t> head;
+    std::atomic<uint32_t> dataSeq;
+    std::atomic<uint32_t> dataWaiters;
+
+    alignas(64) std::atomic<uint64_t> tail;
+    std::atomic<uint32_t> spaceSeq;
+    std::atomic<uint32_t> spaceWaiters;
+};
+static_assert(std::atomic<uint64_t>::is_always_lock_free &&
+              std::atomic<uint32_t>::is_always_lock_free);
+
+#define SHM_RING_MAGIC 0x4f525152U  // "ORQR"
+
+namespace orq {
+
+/**
+ * @brief Single-producer, single-consumer byte ring in a POSIX shared-memory
+ * segment. One process maps the segment as the producer and the other as the
+ * consumer; no locks are taken on either side.
+ *
+ * Writes and reads are non-blocking and move as many bytes as fit, with at
+ * most two `memcpy` calls (one when the range does not wrap). Callers that
+ * cannot make progress sleep on the matching futex word with `waitReadable`
+ * or `waitWritable`.
+ */
+class ShmRing {
+    ShmRingControl* control = nullptr;
+    char* data = nullptr;
+    size_t capacity = 0;
+    size_t mappedBytes = 0;
+
+    std::string name;
+
+    static long futex(std::atomic<uint32_t>* word, int op, uint32_t value,
+                      const struct timespec* timeout) {
+        // Shared (non-private) futex: the word is mapped in two processes
+        return syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), op, value, timeout, nullptr,
+                       0);
+    }
+
+    static void wake(std::atomic<uint32_t>& seq, std::atomic<uint32_t>& waiters) {
+        seq.fetch_add(1);
+        if (waiters.load() > 0) {
+            futex(&seq, FUTEX_WAKE, INT32_MAX, nullptr);
+        }
+    }
+
+    template <typename Ready>
+    static void sleep(std::atomic<uint32_t>& seq, std::atomic<uint32_t>& waiters, Ready ready) {
+        waiters.fetch_add(1);
+        uint32_t observed = seq.load();
+        if (!ready()) {
+            // The timeout only bounds how long a missed wake-up can stall us
+            struct timespec timeout = {0, SHM_COMMUNICATOR_WAIT_US * 1000L};
+            futex(&seq, FUTEX_WAIT, observed, &timeout);
+        }
+        waiters.fetch_sub(1);
+    }
+
+    void map(int fd) {
+        void* base = mmap(nullptr, mappedBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (base == MAP_FAILED) {
+            throw std::runtime_error("ShmRing: Unable to map segment " + name);
+        }
+        control = static_cast<ShmRingControl*>(base);
+        data = static_cast<char*>(base) + sizeof(ShmRingControl);
+    }
+
+   public:
+    /**
+     * @brief Bytes needed for a segment holding a ring of `capacity` bytes.
+     *
+     */
+    static size_t segmentSize(size_t capacity) { return sizeof(ShmRingControl) + capacity; }
+
+    /**
+     * @brief Create the producer side of a ring. Any stale segment left behind
+     * by a crashed run with the same name is removed first.
+     *
+     * @param _name segment name, as passed to `shm_open`
+     * @param _capacity ring size in bytes; must be a power of two
+     */
+    void create(const std::string& _name, size_t _capacity) {
+        name = _name;
+        capacity = _capacity;
+        mappedBytes = segmentSize(capacity);
+
+        if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+            throw std::runtime_error("ShmRing: Capacity must be a power of two");
+        }
+
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0 && errno == EEXIST) {
+            shm_unlink(name.c_str());
+            fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        }
+        if (fd < 0) {
+            throw std::runtime_error("ShmRing: Unable to create segment " + name + ": " +
+                                     std::strerror(errno));
+        }
+        if (ftruncate(fd, mappedBytes) != 0) {
+            ::close(fd);
+            throw std::runtime_error("ShmRing: Unable to size segment " + name);
+        }
+        map(fd);
+        ::close(fd);
+
+        // ftruncate zero-fills, so the indices and counters already start at 0
+        control->capacity = capacity;
+        control->ready.store(SHM_RING_MAGIC, std::memory_order_release);
+    }
+
+    /**
+     * @brief Attach to the consumer side of a ring created by another process,
+     * waiting for the producer to create and initialize it.
+     *
+     * @param _name segment name, as passed to `shm_open`
+     * @param _capacity expected ring size in bytes
+     */
+    void attach(const std::string& _name, size_t _capacity) {
+        name = _name;
+        capacity = _capacity;
+        mappedBytes = segmentSize(capacity);
+
+        auto deadline =
+            std::chrono::steady_clock::now() + std::chrono::seconds(SHM_COMMUNICATOR_CONNECT_S);
+        auto expired = [&]() { return std::chrono::steady_clock::now() > deadline; };
+        auto pause = [] { std::this_thread::sleep_for(std::chrono::milliseconds(1)); };
+
+        int fd;
+        struct stat st;
+        while (true) {
+            fd = shm_open(name.c_str(), O_RDWR, 0600);
+            if (fd >= 0) {
+                if (fstat(fd, &st) == 0 && (size_t)st.st_size == mappedBytes) {
+                    break;
+                }
+                ::close(fd);
+            }
+            if (expired()) {
+                throw std::runtime_error("ShmRing: Timed out waiting for segment " + name);
+            }
+            pause();
+        }
+        map(fd);
+        ::close(fd);
+
+        while (control->ready.load(std::memory_order_acquire) != SHM_RING_MAGIC) {
+            if (expired()) {
+                throw std::runtime_error("ShmRing: Timed out waiting for segment " + name);
+            }
+            pause();
+        }
+        if (control->capacity != capacity) {
+            throw std::runtime_error("ShmRing: Capacity mismatch on segment " + name);
+        }
+        control->attached.store(1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Producer side: wait until the consumer has attached, then remove
+     * the segment name. The mapping stays valid in both processes, and nothing
+     * is left behind in `/dev/shm` once they exit.
+     *
+     */
+    void awaitAttachedAndUnlink() {
+        auto deadline =
+            std::chrono::steady_clock::now() + std::chrono::seconds(SHM_COMMUNICATOR_CONNECT_S);
+        while (control->attached.load(std::memory_order_acquire) == 0) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                throw std::runtime_error("ShmRing: Timed out waiting for peer on " + name);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        shm_unlink(name.c_str());
+    }
+
+    ShmRing() = default;
+    ShmRing(const ShmRing&) = delete;
+    ShmRing& operator=(const ShmRing&) = delete;
+
+    ~ShmRing() {
+        if (control != nullptr) {
+            munmap(control, mappedBytes);
+        }
+    }
+
+    /**
+     * @brief Bytes available to the consumer.
+     *
+     */
+    size_t readable() const {
+        return control->head.load(std::memory_order_acquire) -
+               control->tail.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Free bytes available to the producer.
+     *
+     */
+    size_t writable() const {
+        return capacity - (control->head.load(std::memory_order_relaxed) -
+                           control->tail.load(std::memory_order_acquire));
+    }
+
+    /**
+     * @brief Copy up to `bytes` bytes into the ring without blocking.
+     *
+     * @param src
+     * @param bytes
+     * @return size_t the number of bytes written
+     */
+    size_t write(const char* src, size_t bytes) {
+        size_t n = std::min(bytes, writable());
+        if (n == 0) {
+            return 0;
+        }
+
+        uint64_t head = control->head.load(std::memory_order_relaxed);
+        size_t offset = head & (capacity - 1);
+        size_t first = std::min(n, capacity - offset);
+        std::memcpy(data + offset, src, first);
+        std::memcpy(data, src + first, n - first);
+
+        control->head.store(head + n, std::memory_order_release);
+        wake(control->dataSeq, control->dataWaiters);
+        return n;
+    }
+
+    /**
+     * @brief Copy up to `bytes` bytes out of the ring without blocking.
+     *
+     * @param dst
+     * @param bytes
+     * @return size_t the number of bytes read
+     */
+    size_t read(char* dst, size_t bytes) {
+        size_t n = std::min(bytes, readable());
+        if (n == 0) {
+            return 0;
+        }
+
+        uint64_t tail = control->tail.load(std::memory_order_relaxed);
+        size_t offset = tail & (capacity - 1);
+        size_t first = std::min(n, capacity - offset);
+        std::memcpy(dst, data + offset, first);
+        std::memcpy(dst + first, data, n - first);
+
+        control->tail.store(tail + n, std::memory_order_release);
+        wake(control->spaceSeq, control->spaceWaiters);
+        return n;
+    }
+
+    /**
+     * @brief Consumer side: sleep until the ring is non-empty (or the wait
+     * times out).
+     *
+     */
+    void waitReadable() {
+        sleep(control->dataSeq, control->dataWaiters, [this] { return readable() > 0; });
+    }
+
+    /**
+     * @brief Producer side: sleep until the ring has free space (or the wait
+     * times out).
+     *
+     */
+    void waitWritable() {
+        sleep(control->spaceSeq, control->spaceWaiters, [this] { return writable() > 0; });
+    }
+};
+
+}  // namespace orq
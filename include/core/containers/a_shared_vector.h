@@ -132,7 +132,7 @@ class ASharedVector : public SharedVector<Share, EVector> {
      * of their additive shares, then uses a boolean addition circuit to "add" those shares back
      * together. In the end we are left with an XOR-sharing of the same value.
      *
-     * Other protocols, such as using preprocessed shared bits, are possible.
+     * See `a2b_edabit()` for a variant using preprocessed shared bits.
      *
      */
     std::unique_ptr<B> a2b() const {
@@ -143,6 +143,20 @@ class ASharedVector : public SharedVector<Share, EVector> {
         return res;
     }
 
+    /**
+     * @brief Convert from ASharedVector to BSharedVector using preprocessed daBits. The input is
+     * masked with an edaBit \f$r\f$ and opened, and the boolean sharing of \f$r\f$ is then
+     * added to the public result with the boolean adder circuit. Same circuit as `a2b()`, but
+     * replaces the redistribution of shares with a single opening.
+     *
+     */
+    std::unique_ptr<B> a2b_edabit() const {
+        std::pair<B, B> v = service::runTime->edabit_shares_b(this->vector);
+        auto res = v.first + v.second;
+        res->setPrecision(this->getPrecision());
+        return res;
+    }
+
     // **************************************** //
     //           Arithmetic operators           //
     // **************************************** //
@@ -54,6 +54,9 @@ namespace operators {
 template <typename S, typename E>
 using unique_B = std::unique_ptr<BSharedVector<S, E>>;
 
+template <typename Share, typename EVector>
+class PackedBSharedVector;
+
 /**
  * A SharedVector that contains boolean shares and supports secure boolean operations.
  * @tparam Share Share data type.
@@ -69,6 +72,12 @@ class BSharedVector : public SharedVector<Share, EVector> {
    public:
     using SharedVector_t = SharedVector<Share, EVector>;
 
+    /**
+     * @brief Single-bit vector type, packed `MAX_BITS_NUMBER` bits per share. See
+     * `packed_b_shared_vector.h`.
+     */
+    using Packed = PackedBSharedVector<Share, EVector>;
+
     /**
      * @brief Bit packing. Operates in place by packing the bit at index `position`
      * from BSharedVector `source` into `this` BSharedVector.
@@ -288,12 +297,15 @@ class BSharedVector : public SharedVector<Share, EVector> {
      * each bit individually using `b2a_bit`, and then sums the results. \f$O(\ell^2)\f$ total
      * communication over \f$\ell\f$ rounds.
      *
-     * TODO: we could do all calls to `b2a_bit` in a single round with \f$\ell\times\f$
-     * communication, and the multiplication should be public.
+     * With `USE_DABIT_B2A`, uses `b2a_dabit()` instead, which batches all \f$\ell\f$ bits into
+     * one `b2a_bit` call (while generating the daBits) and a single opening.
      *
      * @return auto
      */
     auto b2a() const {
+#ifdef USE_DABIT_B2A
+        return b2a_dabit();
+#else
         // vector to store the result, initialized to 0
         auto res = std::make_unique<ASharedVector<Share, EVector>>(this->size());
 
@@ -324,6 +336,22 @@ class BSharedVector : public SharedVector<Share, EVector> {
             *res += *bit_arith;
         }
 
+        res->setPrecision(this->getPrecision());
+        return res;
+#endif
+    }
+
+    /**
+     * @brief Full-width conversion from BSharedVector to ASharedVector using preprocessed daBits
+     * (see `Protocol::b2a_dabit`). The online phase is a single opening of the masked input;
+     * daBits which were not reserved ahead of time (`RunTime::reserve_dabits`) are generated on
+     * demand with one batched `b2a_bit` call.
+     *
+     * @return std::unique_ptr<ASharedVector<Share, EVector>>
+     */
+    std::unique_ptr<ASharedVector<Share, EVector>> b2a_dabit() const {
+        auto res = std::make_unique<ASharedVector<Share, EVector>>(this->size());
+        service::runTime->b2a_dabit(this->vector, res->vector);
         res->setPrecision(this->getPrecision());
         return res;
     }
@@ -463,6 +491,31 @@ class BSharedVector : public SharedVector<Share, EVector> {
         orq::service::runTime->modify_parallel(this->vector, &EVector::mask, n);
     }
 
+    /**
+     * @brief AND `other` into `this` vector, treating both as `bits`-bit values (e.g., `bits = 1`
+     * for flags and comparison results). Only `bits` bits per element are communicated, and the
+     * higher bits of the result are cleared.
+     *
+     * @param other
+     * @param bits The number of significant bits per element.
+     */
+    void and_low_bits(const BSharedVector &other, const int &bits) {
+        assert(this->size() == other.size());
+        orq::service::runTime->and_b(this->vector, other.vector, this->vector, bits);
+    }
+
+    /**
+     * @brief Open the `bits` least significant bits of each element, sending only those bits.
+     * The higher bits of the output are zero.
+     *
+     * @param bits The number of significant bits per element.
+     * @return Vector<Share>
+     */
+    Vector<Share> open_low_bits(const int &bits) const {
+        auto v = this->vector;
+        return orq::service::runTime->open_shares_b(v, bits);
+    }
+
     /**
      * Sets the bits of each element in `this` vector by doing a bitwise logical OR with `n`
      * @param n The element that encodes the bits to set.
@@ -166,10 +166,10 @@ class Vector {
     using Unsigned_type = typename std::make_unsigned<T>::type;
 
     // The start index of the batch that is currently being processed
-    int batch_start = 0;
+    VectorSizeType batch_start = 0;
 
     //  The end index of the batch that is currently being processed
-    int batch_end = 0;
+    VectorSizeType batch_end = 0;
 
     const int MAX_BITS_NUMBER = std::numeric_limits<Unsigned_type>::digits;
 
@@ -335,7 +335,7 @@ class Vector {
      * @param _start_ind The index of the first element in the current batch.
      * @param _end_ind The index of the last element in the current batch.
      */
-    void set_batch(const int &_start_ind, const int &_end_ind) {
+    void set_batch(const VectorSizeType &_start_ind, const VectorSizeType &_end_ind) {
         batch_start = (_start_ind >= 0) ? _start_ind : 0;
         batch_end = (_end_ind <= this->total_size()) ? _end_ind : this->total_size();
     }
@@ -1162,7 +1162,7 @@ class Vector {
      *
      * NOTE: This method works relatively to the current batch.
      */
-    inline T &operator[](const int &index) { return (*data.get())[batch_start + index]; }
+    inline T &operator[](const VectorSizeType &index) { return (*data.get())[batch_start + index]; }
 
     /**
      * Returns an immutable reference of the element at the given `index`.
@@ -1171,7 +1171,7 @@ class Vector {
      *
      * NOTE: This method works relatively to the current batch.
      */
-    inline const T &operator[](const int &index) const {
+    inline const T &operator[](const VectorSizeType &index) const {
         return (*data.get())[batch_start + index];
     }
 
@@ -184,6 +184,15 @@ class Vector {
 
     Vector chunkedSum(const VectorSizeType aggSize = 0) const { return *this; }
 
+    template <typename... V>
+    void fma_accumulate(const V &...v) {}
+
+    template <typename... V>
+    void xor_and_accumulate(const V &...v) {}
+
+    template <typename... V>
+    void dot_product_accumulate(const VectorSizeType aggSize, const V &...v) {}
+
     Vector simple_subset(const VectorSizeType &start, const VectorSizeType &step,
                          const VectorSizeType &end) const {
         VectorSizeType res_size = end - start + 1;
@@ -196,8 +205,7 @@ class Vector {
 
     inline VectorSizeType total_size() const { return length; }
 
-    using IteratorType = MappedIterator<T, typename std::vector<T>::iterator,
-                                        typename std::vector<VectorSizeType>::iterator>;
+    using IteratorType = MappedIterator<T, typename std::vector<T>::iterator>;
 
     // TODO these need to work, somehow
     IteratorType begin() const { return {}; }
@@ -231,6 +239,11 @@ class Vector {
 
     bool has_mapping() const { return false; }
 
+    bool contiguous_runs(std::vector<std::span<T>> &runs, size_t max_runs) const {
+        runs.clear();
+        return true;
+    }
+
     /**
      * @brief Return a dummy vector of the correct size
      *
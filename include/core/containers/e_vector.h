@@ -44,6 +44,15 @@
         }                                                   \
     }
 
+#define define_apply_inputs_to_replicated(_func_)      \
+    template <typename... E>                           \
+        requires(std::same_as<E, EVector> && ...)      \
+    void _func_(const E &...inputs) {                  \
+        for (int i = 0; i < ReplicationNumber; ++i) {  \
+            contents[i]._func_(inputs.contents[i]...); \
+        }                                              \
+    }
+
 #define define_apply_input_to_replicated_const(_func_)      \
     template <typename... T>                                \
     void _func_(EVector &other, T... args) const {          \
@@ -327,7 +336,7 @@ class EVector {
 
         // Read the input file
         std::string line;
-        int i = 0;
+        size_t i = 0;
         while (std::getline(input_file, line) && i < size) {
             // replace ',' with ' ' to allow for both csv and space separated files
             std::replace(line.begin(), line.end(), ',', ' ');
@@ -384,6 +393,10 @@ class EVector {
     define_apply_input_to_replicated(alternating_bit_decompress);
     define_apply_input_to_replicated(simple_bit_decompress);
 
+    // Functions which take any number of constant-reference EVectors as input
+    define_apply_inputs_to_replicated(fma_accumulate);
+    define_apply_inputs_to_replicated(xor_and_accumulate);
+
     // Functions which return an EVector
     define_apply_return_to_replicated(alternating_bit_compress);
     define_apply_return_to_replicated(alternating_subset_reference);
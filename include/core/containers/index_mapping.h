@@ -0,0 +1,231 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+namespace orq {
+
+/**
+ * @brief Evaluates the index mapping of a `Vector` view: element `i` of the view is element
+ * `(*this)(i)` of the underlying storage.
+ *
+ * Regular access patterns are described symbolically, in one of two forms:
+ * - `AFFINE`: `offset + i * step` (slices, strided subsets, reversal);
+ * - `BLOCKED`: with `q = i / repeat`, `offset + (q % block) * step + (q / block) * block_step`
+ *   (repeated, cyclic, and alternating subsets).
+ *
+ * If `indices` is set, the symbolic index is looked up in it, which covers data-dependent
+ * mappings. This struct is trivially copyable, so iterators carry their own copy; the index array
+ * is owned by the `IndexMapping` it came from.
+ */
+struct IndexMap {
+    enum Kind : uint8_t { AFFINE, BLOCKED };
+
+    // `block` value of a BLOCKED map which never wraps around
+    static constexpr VectorSizeType NO_WRAP = std::numeric_limits<VectorSizeType>::max();
+
+    Kind kind = AFFINE;
+    int64_t offset = 0;
+    int64_t step = 1;
+    VectorSizeType repeat = 1;
+    VectorSizeType block = NO_WRAP;
+    int64_t block_step = 0;
+    const VectorSizeType *indices = nullptr;
+
+    /**
+     * @brief The symbolic part of the mapping, before the lookup in `indices`.
+     *
+     * @param i index into the view
+     * @return VectorSizeType
+     */
+    inline VectorSizeType symbolic(const VectorSizeType i) const {
+        if (kind == AFFINE) {
+            return offset + (int64_t)i * step;
+        }
+        // skip the divisions the common patterns do not need
+        const VectorSizeType q = (repeat == 1) ? i : i / repeat;
+        if (block == NO_WRAP) {
+            return offset + (int64_t)q * step;
+        }
+        return offset + (int64_t)(q % block) * step + (int64_t)(q / block) * block_step;
+    }
+
+    /**
+     * @param i index into the view
+     * @return VectorSizeType the index into the underlying storage
+     */
+    inline VectorSizeType operator()(const VectorSizeType i) const {
+        const VectorSizeType j = symbolic(i);
+        return indices ? indices[j] : j;
+    }
+
+    /**
+     * @return true if the map is `offset + i` without an index array, i.e., a contiguous range
+     */
+    inline bool is_contiguous() const { return kind == AFFINE && step == 1 && !indices; }
+};
+
+/**
+ * @brief The index mapping of a `Vector` view: an `IndexMap` over `size()` elements, plus
+ * ownership of its index array, if any.
+ *
+ * Taking a view of a view composes the two mappings. `compose` keeps the result symbolic whenever
+ * it has one of the `IndexMap` forms (always, if the outer mapping is affine), and otherwise
+ * writes out a new index array. A slice of an index array shares the array rather than copying
+ * it, since the slice is absorbed into the symbolic part.
+ */
+class IndexMapping {
+    IndexMap map;
+    VectorSizeType length = 0;
+    std::shared_ptr<const std::vector<VectorSizeType>> storage;
+
+   public:
+    IndexMapping() = default;
+
+    /**
+     * @brief A symbolic mapping (without an index array).
+     *
+     * @param _map the mapping; `_map.indices` must be null
+     * @param _length number of elements in the view
+     */
+    IndexMapping(const IndexMap &_map, const VectorSizeType _length)
+        : map(_map), length(_length) {}
+
+    /**
+     * @brief An explicit mapping: element `i` of the view is storage element `indices[i]`.
+     *
+     * @param indices the index array
+     */
+    explicit IndexMapping(std::vector<VectorSizeType> &&indices)
+        : length(indices.size()),
+          storage(std::make_shared<const std::vector<VectorSizeType>>(std::move(indices))) {
+        map.indices = storage->data();
+    }
+
+    /**
+     * @brief `offset + i * step`, for `i` in `[0, length)`.
+     */
+    static IndexMapping affine(const int64_t offset, const int64_t step,
+                               const VectorSizeType length) {
+        IndexMap m;
+        m.offset = offset;
+        m.step = step;
+        return IndexMapping(m, length);
+    }
+
+    /**
+     * @brief `offset + (q % block) * step + (q / block) * block_step` where `q = i / repeat`, for
+     * `i` in `[0, length)`.
+     */
+    static IndexMapping blocked(const int64_t offset, const int64_t step,
+                                const VectorSizeType repeat, const VectorSizeType block,
+                                const int64_t block_step, const VectorSizeType length) {
+        IndexMap m;
+        m.kind = IndexMap::BLOCKED;
+        m.offset = offset;
+        m.step = step;
+        m.repeat = std::max<VectorSizeType>(repeat, 1);
+        m.block = std::max<VectorSizeType>(block, 1);
+        m.block_step = block_step;
+        return IndexMapping(m, length);
+    }
+
+    inline VectorSizeType operator()(const VectorSizeType i) const { return map(i); }
+
+    inline const IndexMap &get_map() const { return map; }
+
+    inline VectorSizeType size() const { return length; }
+
+    /**
+     * @brief Whether the mapping uses an index array (rather than being purely symbolic).
+     */
+    inline bool is_explicit() const { return map.indices != nullptr; }
+
+    /**
+     * @brief Write out the mapping as an index array.
+     *
+     * @return std::vector<VectorSizeType>
+     */
+    std::vector<VectorSizeType> to_vector() const {
+        std::vector<VectorSizeType> result(length);
+        if (map.is_contiguous()) {
+            std::iota(result.begin(), result.end(), (VectorSizeType)map.offset);
+        } else {
+            for (VectorSizeType i = 0; i < length; i++) {
+                result[i] = map(i);
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Compose with a symbolic mapping `g` into this view: the result maps `i` to
+     * `(*this)(g(i))`.
+     *
+     * @param g a symbolic mapping, whose indices must all be below `size()`
+     * @return IndexMapping
+     */
+    IndexMapping compose(const IndexMapping &g) const {
+        const IndexMap &gm = g.map;
+        IndexMapping result = *this;
+        result.length = g.length;
+        IndexMap &r = result.map;
+
+        if (map.kind == IndexMap::AFFINE) {
+            // offset + g(i) * step, which scales every term of g
+            r = gm;
+            r.offset = map.offset + gm.offset * map.step;
+            r.step = gm.step * map.step;
+            r.block_step = gm.block_step * map.step;
+            r.indices = map.indices;
+            return result;
+        }
+
+        if (gm.kind == IndexMap::AFFINE && gm.step == 1) {
+            // a slice starting at a repetition (or, if this wraps, block) boundary
+            if (map.block == IndexMap::NO_WRAP && gm.offset % map.repeat == 0) {
+                r.offset += gm.offset / map.repeat * map.step;
+                return result;
+            }
+            const VectorSizeType period = map.repeat * map.block;
+            if (map.block != IndexMap::NO_WRAP && gm.offset % period == 0) {
+                r.offset += gm.offset / period * map.block_step;
+                return result;
+            }
+        }
+        if (gm.kind == IndexMap::BLOCKED && gm.offset == 0 && gm.step == 1 &&
+            gm.block == IndexMap::NO_WRAP) {
+            // each element repeated gm.repeat times
+            r.repeat *= gm.repeat;
+            return result;
+        }
+
+        // no symbolic form; write out the composition
+        std::vector<VectorSizeType> indices(g.length);
+        for (VectorSizeType i = 0; i < g.length; i++) {
+            indices[i] = map(gm(i));
+        }
+        return IndexMapping(std::move(indices));
+    }
+
+    /**
+     * @brief Compose with an explicit list of indices into this view: the result maps `i` to
+     * `(*this)(selection[i])`.
+     *
+     * @param selection indices into this view
+     * @return IndexMapping
+     */
+    template <typename S>
+    IndexMapping gather(const std::vector<S> &selection) const {
+        std::vector<VectorSizeType> indices(selection.size());
+        for (VectorSizeType i = 0; i < selection.size(); i++) {
+            indices[i] = map(selection[i]);
+        }
+        return IndexMapping(std::move(indices));
+    }
+};
+
+}  // namespace orq
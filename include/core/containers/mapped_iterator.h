@@ -3,16 +3,26 @@
 
 #include <iterator>
 #include <memory>
+#include <optional>
 #include <vector>
 
+#include "index_mapping.h"
+
 namespace orq {
-template <typename T, std::random_access_iterator D, std::random_access_iterator M>
-    requires std::convertible_to<std::iter_value_t<D>, T> &&
-             std::convertible_to<std::iter_value_t<M>, std::iter_difference_t<D>>
+/**
+ * @brief Random access iterator over a (possibly mapped) `Vector`. Holds the position in the view
+ * and a copy of the view's `IndexMap`, if any.
+ */
+template <typename T, std::random_access_iterator D>
+    requires std::convertible_to<std::iter_value_t<D>, T>
 class MappedIterator {
    private:
     D dataIter;
-    std::optional<M> mappingIter;
+    std::optional<IndexMap> map;
+    std::ptrdiff_t pos = 0;
+
+    MappedIterator(D _dataIter, const std::optional<IndexMap> &_map, std::ptrdiff_t _pos)
+        : dataIter(_dataIter), map(_map), pos(_pos) {}
 
    public:
     using difference_type = std::ptrdiff_t;
@@ -20,34 +30,29 @@ class MappedIterator {
 
     MappedIterator() {}
 
-    MappedIterator(std::vector<T>::iterator _dataIter,
-                   std::vector<VectorSizeType>::iterator _mappingIter)
-        : dataIter(_dataIter), mappingIter(_mappingIter) {}
+    MappedIterator(D _dataIter, const IndexMap &_map, difference_type _pos)
+        : dataIter(_dataIter), map(_map), pos(_pos) {}
 
-    MappedIterator(std::vector<T>::iterator _dataIter) : dataIter(_dataIter) {}
+    MappedIterator(D _dataIter, difference_type _pos = 0) : dataIter(_dataIter), pos(_pos) {}
 
     T& operator*() const {
-        if (mappingIter) {
-            return dataIter[*(*mappingIter)];
+        if (map) {
+            return dataIter[(*map)(pos)];
         } else {
-            return *dataIter;
+            return dataIter[pos];
         }
     }
 
     T& operator[](difference_type i) const {
-        if (mappingIter) {
-            return dataIter[(*mappingIter)[i]];
+        if (map) {
+            return dataIter[(*map)(pos + i)];
         } else {
-            return dataIter[i];
+            return dataIter[pos + i];
         }
     }
 
     MappedIterator& operator++() {
-        if (mappingIter) {
-            ++(*mappingIter);
-        } else {
-            ++dataIter;
-        }
+        ++pos;
         return *this;
     }
 
@@ -58,11 +63,7 @@ class MappedIterator {
     }
 
     MappedIterator& operator--() {
-        if (mappingIter) {
-            --(*mappingIter);
-        } else {
-            --dataIter;
-        }
+        --pos;
         return *this;
     }
 
@@ -73,20 +74,12 @@ class MappedIterator {
     }
 
     MappedIterator& operator+=(difference_type n) {
-        if (mappingIter) {
-            *mappingIter += n;
-        } else {
-            dataIter += n;
-        }
+        pos += n;
         return *this;
     }
 
     MappedIterator operator+(difference_type n) const {
-        if (mappingIter) {
-            return MappedIterator(dataIter, *mappingIter + n);
-        } else {
-            return MappedIterator(dataIter + n);
-        }
+        return MappedIterator(dataIter, map, pos + n);
     }
 
     friend MappedIterator operator+(difference_type n, const MappedIterator& other) {
@@ -94,37 +87,17 @@ class MappedIterator {
     }
 
     MappedIterator& operator-=(difference_type n) {
-        if (mappingIter) {
-            *mappingIter -= n;
-        } else {
-            dataIter -= n;
-        }
+        pos -= n;
         return *this;
     }
 
     MappedIterator operator-(difference_type n) const {
-        if (mappingIter) {
-            return MappedIterator(dataIter, *mappingIter - n);
-        } else {
-            return MappedIterator(dataIter - n);
-        }
+        return MappedIterator(dataIter, map, pos - n);
     }
 
-    difference_type operator-(const MappedIterator& other) const {
-        if (mappingIter && other.mappingIter) {
-            return *mappingIter - *other.mappingIter;
-        } else {
-            return dataIter - other.dataIter;
-        }
-    }
+    difference_type operator-(const MappedIterator& other) const { return pos - other.pos; }
 
-    bool operator<(const MappedIterator& other) const {
-        if (mappingIter && other.mappingIter) {
-            return *mappingIter < *other.mappingIter;
-        } else {
-            return dataIter < other.dataIter;
-        }
-    }
+    bool operator<(const MappedIterator& other) const { return pos < other.pos; }
 
     bool operator>(const MappedIterator& other) const { return other < *this; }
 
@@ -132,17 +105,10 @@ class MappedIterator {
 
     bool operator>=(const MappedIterator& other) const { return !(*this < other); }
 
-    bool operator==(const MappedIterator& other) const {
-        if (mappingIter && other.mappingIter) {
-            return *mappingIter == *other.mappingIter;
-        } else {
-            return dataIter == other.dataIter;
-        }
-    }
+    bool operator==(const MappedIterator& other) const { return pos == other.pos; }
 };
 }  // namespace orq
 
-static_assert(std::random_access_iterator<
-              orq::MappedIterator<int, std::vector<int>::iterator, std::vector<int>::iterator>>);
+static_assert(std::random_access_iterator<orq::MappedIterator<int, std::vector<int>::iterator>>);
 
 #endif  // MAPPED_ITERATOR_H
@@ -1,12 +1,16 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <iostream>
 #include <limits>
 #include <memory>
 #include <numeric>
+#include <optional>
 #include <ranges>
 #include <span>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 #ifdef __BMI__
@@ -16,7 +20,10 @@
 #include <cmath>
 
 #include "debug/orq_debug.h"
+#include "index_mapping.h"
 #include "mapped_iterator.h"
+#include "vector_kernels.h"
+#include "vector_pool.h"
 
 template <typename T>
 concept arithmetic = std::integral<T> or std::floating_point<T>;
@@ -25,75 +32,60 @@ concept arithmetic = std::integral<T> or std::floating_point<T>;
  * @brief Define a binary operation between two vectors, such as `a - b`.
  *
  */
-#define define_binary_vector_op(_op_)                    \
-    inline Vector operator _op_(const Vector &y) const { \
-        VectorSizeType size = this->size();              \
-        Vector res = this->construct_like();             \
-        for (VectorSizeType i = 0; i < size; ++i) {      \
-            res[i] = (*this)[i] _op_ y[i];               \
-        }                                                \
-        res.setPrecision(this->getPrecision());          \
-        return res;                                      \
+#define define_binary_vector_op(_op_)                                                   \
+    inline Vector operator _op_(const Vector &y) const {                                \
+        Vector res = uninitialized(this->size());                                       \
+        res.apply_kernel(*this, y, [](const T a, const T b) -> T { return a _op_ b; }); \
+        res.setPrecision(this->getPrecision());                                         \
+        return res;                                                                     \
     }
 
 /**
  * @brief Define a unary operation with one vector, such as `~a`.
  *
  */
-#define define_unary_vector_op(_op_)                \
-    inline Vector operator _op_() const {           \
-        VectorSizeType size = this->size();         \
-        Vector res = this->construct_like();        \
-        for (VectorSizeType i = 0; i < size; ++i) { \
-            res[i] = _op_(*this)[i];                \
-        }                                           \
-        res.setPrecision(this->getPrecision());     \
-        return res;                                 \
+#define define_unary_vector_op(_op_)                                    \
+    inline Vector operator _op_() const {                               \
+        Vector res = uninitialized(this->size());                       \
+        res.apply_kernel(*this, [](const T a) -> T { return _op_ a; }); \
+        res.setPrecision(this->getPrecision());                         \
+        return res;                                                     \
     }
 
 /**
  * @brief Define a binary operation with a vector and an element, such as `a * 2`.
  *
  */
-#define define_binary_vector_element_op(_op_)          \
-    template <typename S>                              \
-        requires arithmetic<S>                         \
-    inline Vector operator _op_(const S other) const { \
-        VectorSizeType size = this->size();            \
-        Vector res = this->construct_like();           \
-        for (VectorSizeType i = 0; i < size; ++i) {    \
-            res[i] = (*this)[i] _op_ other;            \
-        }                                              \
-        res.setPrecision(this->getPrecision());        \
-        return res;                                    \
+#define define_binary_vector_element_op(_op_)                                      \
+    template <typename S>                                                          \
+        requires arithmetic<S>                                                     \
+    inline Vector operator _op_(const S other) const {                             \
+        Vector res = uninitialized(this->size());                                  \
+        res.apply_kernel(*this, [other](const T a) -> T { return a _op_ other; }); \
+        res.setPrecision(this->getPrecision());                                    \
+        return res;                                                                \
     }
 
 /**
  * @brief Define a Vector assignment operator with a Vector, such as `a &= b`.
  *
  */
-#define define_binary_vector_assignment_op(_op_)       \
-    inline Vector operator _op_(const Vector &other) { \
-        VectorSizeType size = this->size();            \
-        for (VectorSizeType i = 0; i < size; i++) {    \
-            (*this)[i] _op_ other[i];                  \
-        }                                              \
-        return *this;                                  \
+#define define_binary_vector_assignment_op(_op_)                                  \
+    inline Vector operator _op_(const Vector &other) {                            \
+        apply_kernel(*this, other, [](T a, const T b) -> T { return a _op_ b; }); \
+        return *this;                                                             \
     }
 
 /**
  * @brief Define a Vector assignment operator with an element, such as `a += 1`.
  *
  */
-#define define_binary_vector_element_assignment_op(_op_) \
-    template <typename S>                                \
-        requires arithmetic<S>                           \
-    Vector operator _op_(const S other) {                \
-        VectorSizeType size = this->size();              \
-        for (VectorSizeType i = 0; i < size; i++) {      \
-            (*this)[i] _op_ other;                       \
-        }                                                \
-        return *this;                                    \
+#define define_binary_vector_element_assignment_op(_op_)                 \
+    template <typename S>                                                \
+        requires arithmetic<S>                                           \
+    Vector operator _op_(const S other) {                                \
+        apply_kernel(*this, [other](T a) -> T { return a _op_ other; }); \
+        return *this;                                                    \
     }
 
 namespace orq {
@@ -233,17 +225,117 @@ class Vector {
      * A (shared) pointer to the actual vector contents. NOTE: Shallow copying of this object
      * creates two instances that share the same data.
      */
-    std::shared_ptr<std::vector<T>> data;
+    std::shared_ptr<memory::Storage<T>> data;
 
     /**
-     * A (shared) pointer to the vector storing the index mapping for this vector. Can be null, in
-     * which case the mapping is defaulted to the identity mapping
+     * The index mapping of this vector, stored symbolically where possible (see `IndexMapping`).
+     * Can be empty, in which case the mapping is defaulted to the identity mapping
      */
-    std::shared_ptr<std::vector<VectorSizeType>> mapping;
+    std::optional<IndexMapping> mapping;
 
     // Fixed-point precision
     size_t precision = 0;
 
+    /**
+     * @brief Get the base pointer and stride of the current batch, if it is an affine view
+     * (`base + i * stride`) of the storage: without a mapping (stride 1), through an affine mapping
+     * without an index array, or repeating a single element (stride 0).
+     *
+     * @return true if the batch is non-empty and affine
+     */
+    inline bool affine_batch(T *&base, int64_t &stride) const {
+        if (size() == 0) {
+            return false;
+        }
+        if (!has_mapping()) {
+            base = data->data() + batch_start;
+            stride = 1;
+            return true;
+        }
+        const IndexMap &m = mapping->get_map();
+        if (m.indices) {
+            return false;
+        }
+        if (m.kind == IndexMap::AFFINE || (m.block == IndexMap::NO_WRAP && m.repeat == 1)) {
+            stride = m.step;
+        } else if (m.block == IndexMap::NO_WRAP &&
+                   m.symbolic(batch_start) == m.symbolic(batch_end - 1)) {
+            stride = 0;
+        } else {
+            return false;
+        }
+        base = data->data() + m(batch_start);
+        return true;
+    }
+
+    /**
+     * @brief Set the current batch to `f(x[i])`, with `kernels::unary` if both batches are affine.
+     */
+    template <typename S, typename F>
+    inline void apply_kernel(const Vector<S> &x, F f) {
+        T *out;
+        S *px;
+        int64_t so, sx;
+        if (affine_batch(out, so) && x.affine_batch(px, sx)) {
+            kernels::unary(px, sx, out, so, size(), f);
+        } else {
+            for (VectorSizeType i = 0; i < size(); i++) {
+                (*this)[i] = f(x[i]);
+            }
+        }
+    }
+
+    /**
+     * @brief Set the current batch to `f(x[i], y[i])`, with `kernels::binary` if all three batches
+     * are affine.
+     */
+    template <typename F>
+    inline void apply_kernel(const Vector &x, const Vector &y, F f) {
+        T *out, *px, *py;
+        int64_t so, sx, sy;
+        if (affine_batch(out, so) && x.affine_batch(px, sx) && y.affine_batch(py, sy)) {
+            kernels::binary(px, sx, py, sy, out, so, size(), f);
+        } else {
+            for (VectorSizeType i = 0; i < size(); i++) {
+                (*this)[i] = f(x[i], y[i]);
+            }
+        }
+    }
+
+    /**
+     * @brief Get the current batches of `x...` as `kernels::Strided` inputs, if they (and this
+     * Vector's batch, returned in `out` and `so`) are all affine.
+     */
+    template <typename... V>
+    inline bool strided_batches(T *&out, int64_t &so,
+                                std::array<kernels::Strided<T>, sizeof...(V)> &in,
+                                const V &...x) const {
+        bool affine = affine_batch(out, so);
+        size_t k = 0;
+        ((affine = affine && x.affine_batch(in[k].base, in[k].stride), k++), ...);
+        return affine;
+    }
+
+    /**
+     * @brief Set the current batch to `f((*this)[i], x[i]...)` in a single pass, with
+     * `kernels::accumulate` if all batches are affine.
+     */
+    template <typename F, typename... V>
+    inline void accumulate_kernel(F f, const V &...x) {
+        T *out;
+        int64_t so;
+        std::array<kernels::Strided<T>, sizeof...(V)> in;
+        if (strided_batches(out, so, in, x...)) {
+            [&]<size_t... I>(std::index_sequence<I...>) {
+                kernels::accumulate(out, so, size(), f, in[I]...);
+            }(std::index_sequence_for<V...>{});
+        } else {
+            for (VectorSizeType i = 0; i < size(); i++) {
+                (*this)[i] = f((*this)[i], x[i]...);
+            }
+        }
+    }
+
    public:
     // Accessible via orq::Vector<T>::value_type
     using value_type = T;
@@ -254,24 +346,39 @@ class Vector {
      *
      * Default mapping is the identity (null pointer)
      */
-    Vector(std::shared_ptr<std::vector<T>> _data,
+    Vector(std::shared_ptr<memory::Storage<T>> _data,
            std::shared_ptr<std::vector<VectorSizeType>> _mapping = nullptr)
         : data(_data),
-          mapping(_mapping),
           batch_start(0),
-          batch_end(_mapping ? _mapping.get()->size() : _data.get()->size()) {}
+          batch_end(_mapping ? _mapping.get()->size() : _data.get()->size()) {
+        if (_mapping) {
+            mapping.emplace(std::vector<VectorSizeType>(*_mapping));
+        }
+    }
 
     /**
-     * Move constructor
-     * @param _other The std::vector<T> whose elements will be moved to the new Vector.
+     * Construct a view of specific data through an index mapping
+     * Mostly used internally
      */
-    Vector(std::vector<T> &&_other) : Vector(std::make_shared<std::vector<T>>(std::move(_other))) {}
+    Vector(std::shared_ptr<memory::Storage<T>> _data, IndexMapping _mapping)
+        : data(_data), mapping(std::move(_mapping)) {
+        batch_end = mapping->size();
+    }
+
+    /**
+     * Construction from a temporary vector is deleted: pooled storage cannot take over a
+     * `std::vector` buffer, so it would silently copy. Copy explicitly from an lvalue, or fill a
+     * Vector directly.
+     */
+    Vector(std::vector<T> &&_other) = delete;
 
     /**
      * Copy constructor from vector
      * @param _other The std::vector<T> whose elements will be copied to the new Vector.
      */
-    Vector(std::vector<T> &_other) : Vector(std::make_shared<std::vector<T>>(_other)) {}
+    Vector(std::vector<T> &_other) : Vector(memory::VectorPool<T>::make(_other.size())) {
+        std::copy(_other.begin(), _other.end(), data->begin());
+    }
 
     /**
      * Creates a Vector of `size` values initialize to `init_val` (0 by default).
@@ -279,21 +386,31 @@ class Vector {
      * @param _init_val default-initialized value
      */
     Vector(VectorSizeType _size, T _init_val = 0)
-        : Vector(std::make_shared<std::vector<T>>(_size, _init_val)) {}
+        : Vector(memory::VectorPool<T>::make(_size, _init_val)) {}
+
+    /**
+     * Creates a Vector of `size` values with unspecified contents, for outputs that are overwritten
+     * anyway. Skips initializing storage reused from the pool (see `memory::VectorPool`).
+     * @param _size The size of the new Vector.
+     */
+    static Vector uninitialized(const VectorSizeType _size) {
+        return Vector(memory::VectorPool<T>::make(_size));
+    }
 
     /**
      * Constructs a new Vector from a list of `T` elements.
      * @param elements The list of elements of the new Vector.
      */
     Vector(std::initializer_list<T> &&elements)
-        : Vector(std::make_shared<std::vector<T>>(elements)) {}
+        : Vector(memory::VectorPool<T>::adopt(memory::Storage<T>(elements))) {}
 
     /**
      * Copy constructor from range
      * @param _other The input_range whose elements will be copied to the new Vector.
      */
     template <std::ranges::input_range IR>
-    Vector(IR _other) : Vector(std::make_shared<std::vector<T>>(_other.begin(), _other.end())) {}
+    Vector(IR _other)
+        : Vector(memory::VectorPool<T>::adopt(memory::Storage<T>(_other.begin(), _other.end()))) {}
 
     /**
      * This is a shallow copy constructor.
@@ -374,12 +491,8 @@ class Vector {
      * NOTE: This method works relatively to the current batch.
      */
     inline Vector bit_arithmetic_right_shift(const int &shift_size) const {
-        VectorSizeType size = this->size();
-        Vector res = this->construct_like();
-        for (VectorSizeType i = 0; i < size; ++i) {
-            res[i] = ((*this)[i]) >> shift_size;
-        }
-
+        Vector res = uninitialized(this->size());
+        res.apply_kernel(*this, [shift_size](const T a) -> T { return a >> shift_size; });
         return res;
     }
 
@@ -393,12 +506,9 @@ class Vector {
      * NOTE: This method works relatively to the current batch.
      */
     inline Vector bit_logical_right_shift(const int &shift_size) const {
-        VectorSizeType size = this->size();
-        Vector res = this->construct_like();
-        for (VectorSizeType i = 0; i < size; ++i) {
-            res[i] = ((Unsigned_type)(*this)[i]) >> shift_size;
-        }
-
+        Vector res = uninitialized(this->size());
+        res.apply_kernel(*this,
+                         [shift_size](const T a) -> T { return (Unsigned_type)a >> shift_size; });
         return res;
     }
 
@@ -411,12 +521,9 @@ class Vector {
      * NOTE: This method works relatively to the current batch.
      */
     inline Vector bit_left_shift(const int &shift_size) const {
-        VectorSizeType size = this->size();
-        Vector res = this->construct_like();
-        for (VectorSizeType i = 0; i < size; ++i) {
-            res[i] = ((Unsigned_type)(*this)[i]) << shift_size;
-        }
-
+        Vector res = uninitialized(this->size());
+        res.apply_kernel(*this,
+                         [shift_size](const T a) -> T { return (Unsigned_type)a << shift_size; });
         return res;
     }
 
@@ -428,13 +535,9 @@ class Vector {
      * NOTE: This method works relatively to the current batch.
      */
     inline Vector bit_xor() const {
-        VectorSizeType size = this->size();
-        Vector res = this->construct_like();
-
-        for (VectorSizeType i = 0; i < size; ++i) {
-            res[i] = std::popcount(static_cast<Unsigned_type>((*this)[i])) & 1;
-        }
-
+        Vector res = uninitialized(this->size());
+        res.apply_kernel(
+            *this, [](const T a) -> T { return std::popcount(static_cast<Unsigned_type>(a)) & 1; });
         return res;
     }
 
@@ -496,21 +599,78 @@ class Vector {
         const VectorSizeType aggSize_ = (aggSize == 0) ? this->size() : aggSize;
 
         assert(this->size() == other.size());
-        const VectorSizeType s = this->size();
-        const VectorSizeType newSize = div_ceil(s, aggSize_);
+        const VectorSizeType newSize = div_ceil(this->size(), aggSize_);
 
         Vector res(newSize);
-        VectorSizeType j = 0;
-        for (VectorSizeType i = 0; i < newSize; ++i) {
-            T sum = 0;
-            const VectorSizeType end = std::min(j + aggSize_, s);
-            for (; j < end; ++j) {
-                sum += (*this)[j] * other[j];
-            }
-            res[i] = sum;
+        res.dot_product_accumulate(aggSize_, *this, other);
+        return res;
+    }
+
+    /**
+     * Fused multiply-accumulate: adds `a0 * b0 + a1 * b1 + ...` to this Vector, for any number of
+     * operand pairs, in a single pass and without temporary Vectors.
+     * @param v The operands, in pairs.
+     *
+     * NOTE: This method works relatively to the current batch.
+     */
+    template <typename... V>
+        requires(sizeof...(V) % 2 == 0 && (std::same_as<V, Vector> && ...))
+    void fma_accumulate(const V &...v) {
+        accumulate_kernel(
+            [](const T acc, const auto... e) -> T { return acc + kernels::sum_of_products(e...); },
+            v...);
+    }
+
+    /**
+     * Fused AND-XOR: XORs `(a0 & b0) ^ (a1 & b1) ^ ...` into this Vector, for any number of
+     * operand pairs, in a single pass and without temporary Vectors.
+     * @param v The operands, in pairs.
+     *
+     * NOTE: This method works relatively to the current batch.
+     */
+    template <typename... V>
+        requires(sizeof...(V) % 2 == 0 && (std::same_as<V, Vector> && ...))
+    void xor_and_accumulate(const V &...v) {
+        accumulate_kernel(
+            [](const T acc, const auto... e) -> T { return acc ^ kernels::xor_of_ands(e...); },
+            v...);
+    }
+
+    /**
+     * Fused dot product: adds `a0 * b0 + a1 * b1 + ...`, summed over each `aggSize` consecutive
+     * elements of the operands, to the corresponding element of this Vector.
+     * @param aggSize The number of operand elements per element of this Vector.
+     * @param v The operands, in pairs, all of the same size.
+     *
+     * NOTE: This method works relatively to the current batch.
+     */
+    template <typename... V>
+        requires(sizeof...(V) % 2 == 0 && (std::same_as<V, Vector> && ...))
+    void dot_product_accumulate(const VectorSizeType aggSize, const V &...v) {
+        const VectorSizeType n = std::get<0>(std::tie(v...)).size();
+        assert(aggSize > 0 && this->size() == div_ceil(n, aggSize));
+        auto f = [](const T acc, const auto... e) -> T {
+            return acc + kernels::sum_of_products(e...);
+        };
+
+        T *out;
+        int64_t so;
+        std::array<kernels::Strided<T>, sizeof...(V)> in;
+        if (strided_batches(out, so, in, v...)) {
+            [&]<size_t... I>(std::index_sequence<I...>) {
+                kernels::aggregate(out, so, n, aggSize, f, in[I]...);
+            }(std::index_sequence_for<V...>{});
+            return;
         }
 
-        return res;
+        for (VectorSizeType i = 0, j = 0; j < n; i++) {
+            T sum = (*this)[i];
+            const VectorSizeType end = std::min(j + aggSize, n);
+            for (; j < end; j++) {
+                sum = f(sum, v[j]...);
+            }
+            (*this)[i] = sum;
+        }
     }
 
     // TODO: check for a (different by one index) bug for `end`.
@@ -569,8 +729,7 @@ class Vector {
         }
     }
 
-    using IteratorType = MappedIterator<T, typename std::vector<T>::iterator,
-                                        typename std::vector<VectorSizeType>::iterator>;
+    using IteratorType = MappedIterator<T, typename memory::Storage<T>::iterator>;
 
     /**
      * @return An iterator pointing to the first element.
@@ -579,7 +738,7 @@ class Vector {
      */
     inline IteratorType begin() const {
         if (has_mapping()) {
-            return IteratorType(data->begin(), mapping->begin());
+            return IteratorType(data->begin(), mapping->get_map(), 0);
         } else {
             return IteratorType(data->begin());
         }
@@ -592,9 +751,9 @@ class Vector {
      */
     inline IteratorType end() const {
         if (has_mapping()) {
-            return IteratorType(data->begin(), mapping->end());
+            return IteratorType(data->begin(), mapping->get_map(), mapping->size());
         } else {
-            return IteratorType(data->end());
+            return IteratorType(data->begin(), data->size());
         }
     }
 
@@ -611,7 +770,7 @@ class Vector {
      *
      * @return std::vector<T>
      */
-    std::vector<T> _get_internal_data() const { return *data; }
+    std::vector<T> _get_internal_data() const { return std::vector<T>(data->begin(), data->end()); }
 
     /**
      * @brief Return a span with a view of the underlying data
@@ -648,7 +807,32 @@ class Vector {
      * @return true if the Vector has a mapping
      * @return false if it does not
      */
-    bool has_mapping() const { return mapping != nullptr; }
+    bool has_mapping() const { return mapping.has_value(); }
+
+    /**
+     * @brief Create a view of the same storage through `g`, composed with this Vector's mapping.
+     *
+     * @param g symbolic mapping into this Vector
+     * @return Vector
+     */
+    Vector compose_reference(const IndexMapping &g) const {
+        return Vector<T>(data, has_mapping() ? mapping->compose(g) : g);
+    }
+
+    /**
+     * @brief Create a view of the elements of this Vector at the given indices.
+     *
+     * @param selection indices into this Vector
+     * @return Vector
+     */
+    template <typename S>
+    Vector gather_reference(const std::vector<S> &selection) const {
+        if (has_mapping()) {
+            return Vector<T>(data, mapping->gather(selection));
+        }
+        std::vector<VectorSizeType> indices(selection.begin(), selection.end());
+        return Vector<T>(data, IndexMapping(std::move(indices)));
+    }
 
     /**
      * @brief Remaps the vector to reference a subset of the original vector. Returned Vector points
@@ -669,13 +853,7 @@ class Vector {
         }
 
         VectorSizeType size = std::min(this->total_size(), (_end_index - _start_index) / _step + 1);
-        auto new_mapping = std::make_shared<std::vector<VectorSizeType>>(size);
-        for (VectorSizeType i = 0, j = _start_index; i < size; ++i, j += _step) {
-            // TODO: try moving the if outside the for loop
-            (*new_mapping)[i] = mapping ? (*mapping)[j] : j;
-        }
-
-        return Vector<T>(data, new_mapping);
+        return compose_reference(IndexMapping::affine(_start_index, _step, size));
     }
 
     /**
@@ -718,13 +896,7 @@ class Vector {
      */
     Vector slice(const size_t start, const size_t end) const {
         size_t n = std::min(end - start, size());
-        auto new_mapping = std::make_shared<std::vector<VectorSizeType>>(n);
-        if (has_mapping()) {
-            std::copy(mapping->begin() + start, mapping->begin() + end, new_mapping->begin());
-        } else {
-            std::iota(new_mapping->begin(), new_mapping->end(), start);
-        }
-        return Vector<T>(data, new_mapping);
+        return compose_reference(IndexMapping::affine(start, 1, n));
     }
 
     /**
@@ -759,19 +931,19 @@ class Vector {
         // We won't need the entire thing, so resize after: but don't know
         // a priori how large the output is.
         VectorSizeType upper_bound_size = std::min(this->total_size(), flag.total_size());
-        auto new_mapping = std::make_shared<std::vector<VectorSizeType>>(upper_bound_size);
+        std::vector<VectorSizeType> new_mapping(upper_bound_size);
 
         VectorSizeType mi = 0;
         for (VectorSizeType fi = 0; fi < upper_bound_size; fi++) {
             if (flag[fi] != 0) {
-                (*new_mapping)[mi++] = mapping ? (*mapping)[fi] : fi;
+                new_mapping[mi++] = mapping ? (*mapping)(fi) : fi;
             }
         }
 
         // We only used `mi` indices of the mapping; resize it.
-        new_mapping->resize(mi);
+        new_mapping.resize(mi);
 
-        return Vector<T>(data, new_mapping);
+        return Vector<T>(data, IndexMapping(std::move(new_mapping)));
     }
 
     /**
@@ -796,17 +968,9 @@ class Vector {
                 (_subset_included_size) +
             std::min(_subset_included_size,
                      this->total_size() % (_subset_included_size + _subset_excluded_size));
-        auto new_mapping = std::make_shared<std::vector<VectorSizeType>>(size);
         auto chunk_size = _subset_included_size + _subset_excluded_size;
-        VectorSizeType i = 0;
-        VectorSizeType j = 0;
-        while (i < size) {
-            for (VectorSizeType k = 0; i < size && k < _subset_included_size; ++k) {
-                (*new_mapping)[i++] = mapping ? (*mapping)[j + k] : j + k;
-            }
-            j += chunk_size;
-        }
-        return Vector<T>(data, new_mapping);
+        return compose_reference(
+            IndexMapping::blocked(0, 1, 1, _subset_included_size, chunk_size, size));
     }
 
     /**
@@ -828,20 +992,28 @@ class Vector {
             std::min(_subset_included_size,
                      this->total_size() % (_subset_included_size + _subset_excluded_size));
         VectorSizeType size = full_chunks * _subset_included_size + last_chunk_size;
-        auto new_mapping = std::make_shared<std::vector<VectorSizeType>>(size);
+        if (last_chunk_size == 0) {
+            // every chunk is read backwards from its last included element
+            return compose_reference(IndexMapping::blocked(_subset_included_size - 1, -1, 1,
+                                                           _subset_included_size, chunk_size,
+                                                           size));
+        }
+
+        // the last (partial) chunk is read backwards from the end of the Vector instead
+        std::vector<VectorSizeType> new_mapping(size);
         VectorSizeType i = 0;
         VectorSizeType chunk_end = _subset_included_size - 1;
         for (VectorSizeType chunk = 0; chunk < full_chunks; ++chunk) {
             for (VectorSizeType j = 0; j < _subset_included_size; ++j) {
-                (*new_mapping)[i++] = mapping ? (*mapping)[chunk_end - j] : chunk_end - j;
+                new_mapping[i++] = chunk_end - j;
             }
             chunk_end += chunk_size;
         }
         chunk_end = this->total_size() - 1;
         for (VectorSizeType j = 0; j < last_chunk_size; ++j) {
-            (*new_mapping)[i++] = mapping ? (*mapping)[chunk_end - j] : chunk_end - j;
+            new_mapping[i++] = chunk_end - j;
         }
-        return Vector<T>(data, new_mapping);
+        return gather_reference(new_mapping);
     }
 
     /**
@@ -853,16 +1025,8 @@ class Vector {
      */
     Vector repeated_subset_reference(const VectorSizeType _subset_repetition) const {
         VectorSizeType size = this->total_size() * _subset_repetition;
-        auto new_mapping = std::make_shared<std::vector<VectorSizeType>>(size);
-        auto orig_size = this->total_size();
-        auto i = 0;
-        for (auto j = 0; j < orig_size; ++j) {
-            for (auto k = 0; k < _subset_repetition; ++k) {
-                (*new_mapping)[i++] = mapping ? (*mapping)[j] : j;
-            }
-        }
-
-        return Vector<T>(data, new_mapping);
+        return compose_reference(
+            IndexMapping::blocked(0, 1, _subset_repetition, IndexMap::NO_WRAP, 0, size));
     }
 
     /**
@@ -874,16 +1038,7 @@ class Vector {
      */
     Vector cyclic_subset_reference(const VectorSizeType _subset_cycles) const {
         VectorSizeType size = this->total_size() * _subset_cycles;
-        auto new_mapping = std::make_shared<std::vector<VectorSizeType>>(size);
-        auto orig_size = this->total_size();
-        auto i = 0;
-        for (auto j = 0; j < _subset_cycles; ++j) {
-            for (auto k = 0; k < orig_size; ++k) {
-                (*new_mapping)[i++] = mapping ? (*mapping)[k] : k;
-            }
-        }
-
-        return Vector<T>(data, new_mapping);
+        return compose_reference(IndexMapping::blocked(0, 1, 1, this->total_size(), 0, size));
     }
 
     /**
@@ -895,11 +1050,7 @@ class Vector {
     Vector directed_subset_reference(const int _subset_direction) const {
         if (_subset_direction == -1) {
             size_t size = this->total_size();
-            auto new_mapping = std::make_shared<std::vector<VectorSizeType>>(size);
-            for (size_t i = 0, j = size - 1; i < size; ++i, --j) {
-                (*new_mapping)[i] = mapping ? (*mapping)[j] : j;
-            }
-            return Vector<T>(data, new_mapping);
+            return compose_reference(IndexMapping::affine((int64_t)size - 1, -1, size));
         } else {
             return *this;
         }
@@ -976,6 +1127,13 @@ class Vector {
         const VectorSizeType total_bits =
             std::min(this->size() * MAX_BITS_NUMBER, source.size() - base_index);
 
+        T *out, *in;
+        int64_t so, si;
+        if (affine_batch(out, so) && so == 1 && source.affine_batch(in, si) && si == 1) {
+            kernels::pack_bits(in + base_index, out, total_bits, position);
+            return;
+        }
+
         for (VectorSizeType i = 0, j = 0; j < total_bits; i++, j += MAX_BITS_NUMBER) {
             T r = 0;
             // auto r = &res[i];
@@ -1004,6 +1162,13 @@ class Vector {
         assert(batch_start % MAX_BITS_NUMBER == 0);
         const VectorSizeType base_index = batch_start / MAX_BITS_NUMBER;
 
+        T *out, *in;
+        int64_t so, si;
+        if (affine_batch(out, so) && so == 1 && source.affine_batch(in, si) && si == 1) {
+            kernels::unpack_bits(in + base_index, out, total_bits, position);
+            return;
+        }
+
         for (VectorSizeType i = 0, j = 0; j < total_bits; i++, j += MAX_BITS_NUMBER) {
             auto r = source[i + base_index];
             for (VectorSizeType k = j, p = 0; p < MAX_BITS_NUMBER && k < total_bits; k++, p++) {
@@ -1114,7 +1279,7 @@ class Vector {
      */
     Vector<T> materialize() const {
         if (has_mapping()) {
-            Vector<T> res = this->construct_like();
+            Vector<T> res = uninitialized(this->size());
             res = *this;
             return res;
         } else {
@@ -1132,7 +1297,7 @@ class Vector {
      */
     void materialize_inplace() {
         if (has_mapping()) {
-            Vector<T> res = this->construct_like();
+            Vector<T> res = uninitialized(this->size());
             res = *this;
             data = std::move(res.data);
             // Goodbye mapping
@@ -1141,6 +1306,54 @@ class Vector {
         }
     }
 
+    /**
+     * @brief Decompose the current batch into maximal runs of consecutive storage, in element
+     * order. Communicators use this to send and receive mapped Vectors in place: slices and
+     * alternating subsets break into a few long runs, which can be handed to the network as a
+     * gather list instead of being materialized first.
+     *
+     * @param runs output; cleared, then filled with one span per run
+     * @param max_runs give up once more than this many runs are needed
+     * @return true if the batch fits in `max_runs` runs
+     * @return false if the mapping is too fragmented; `runs` is then unspecified and the caller
+     * should pack the elements instead
+     */
+    bool contiguous_runs(std::vector<std::span<T>> &runs, size_t max_runs) const {
+        runs.clear();
+        size_t n = size();
+        if (n == 0) {
+            return true;
+        }
+        if (!has_mapping()) {
+            runs.emplace_back(data->data() + batch_start, n);
+            return max_runs >= 1;
+        }
+
+        const IndexMap &m = mapping->get_map();
+        if (m.is_contiguous()) {
+            runs.emplace_back(data->data() + m(batch_start), n);
+            return max_runs >= 1;
+        }
+
+        size_t run_start = m(batch_start);
+        size_t run_length = 1;
+        for (size_t i = 1; i < n; i++) {
+            size_t index = m(batch_start + i);
+            if (index == run_start + run_length) {
+                run_length++;
+                continue;
+            }
+            if (runs.size() + 1 >= max_runs) {
+                return false;
+            }
+            runs.emplace_back(data->data() + run_start, run_length);
+            run_start = index;
+            run_length = 1;
+        }
+        runs.emplace_back(data->data() + run_start, run_length);
+        return runs.size() <= max_runs;
+    }
+
     /**
      * @brief Create a mapping reference, where the std::vector argument `map` will become the new
      * map. Not allowed if a mapping is already applied.
@@ -1150,8 +1363,7 @@ class Vector {
      */
     Vector mapping_reference(std::vector<VectorSizeType> map) const {
         assert(!has_mapping());
-        auto new_mapping = std::make_shared<std::vector<VectorSizeType>>(std::move(map));
-        return Vector<T>(data, new_mapping);
+        return Vector<T>(data, IndexMapping(std::move(map)));
     }
 
     /**
@@ -1164,9 +1376,7 @@ class Vector {
     template <typename S>
     Vector mapping_reference(std::vector<S> map) const {
         assert(!has_mapping());
-        auto new_mapping = std::make_shared<std::vector<VectorSizeType>>(map.size());
-        std::copy(map.begin(), map.end(), new_mapping->begin());
-        return Vector<T>(data, new_mapping);
+        return gather_reference(map);
     }
 
     /**
@@ -1179,9 +1389,8 @@ class Vector {
     template <typename S>
     Vector mapping_reference(Vector<S> map) const {
         assert(!has_mapping());
-        auto new_mapping = std::make_shared<std::vector<VectorSizeType>>(map.size());
-        std::copy(map.begin(), map.end(), new_mapping->begin());
-        return Vector<T>(data, new_mapping);
+        std::vector<VectorSizeType> indices(map.begin(), map.end());
+        return Vector<T>(data, IndexMapping(std::move(indices)));
     }
 
     /**
@@ -1206,26 +1415,21 @@ class Vector {
         // Make sure we're not expanding by accident
         assert(size <= this->size());
 
-        // If no mapping yet, just use what was passed if same type, or seed with iota
+        // If no mapping yet, just use what was passed if same type, or copy it
         if (!has_mapping()) {
             if constexpr (std::is_same_v<S, VectorSizeType>) {
-                mapping = std::make_shared<std::vector<VectorSizeType>>(std::move(new_mapping));
+                mapping.emplace(std::move(new_mapping));
             } else {
                 // different type
-                mapping = std::make_shared<std::vector<VectorSizeType>>(size);
-                std::copy(new_mapping.begin(), new_mapping.end(), mapping->begin());
+                std::vector<VectorSizeType> indices(new_mapping.begin(), new_mapping.end());
+                mapping.emplace(std::move(indices));
             }
             return;
         }
 
-        // Already a mapping, so we need to compose. Need a temporary so we don't clobber existing
+        // Already a mapping, so we need to compose.
         // This is basically permutation composition.
-        auto temp = std::make_shared<std::vector<VectorSizeType>>(size);
-
-        for (int i = 0; i < size; i++) {
-            (*temp)[i] = (*mapping)[new_mapping[i]];
-        }
-        mapping = std::move(temp);
+        mapping = mapping->gather(new_mapping);
     }
 
     /**
@@ -1244,11 +1448,8 @@ class Vector {
      * NOTE: This method works relatively to the current batch.
      */
     Vector &operator=(const Vector &&other) {
-        VectorSizeType size = this->size();
-        assert(size == other.size());
-        for (VectorSizeType i = 0; i < size; ++i) {
-            (*this)[i] = other[i];
-        }
+        assert(this->size() == other.size());
+        apply_kernel(other, [](const T a) -> T { return a; });
         precision = other.getPrecision();
         return *this;
     }
@@ -1261,11 +1462,8 @@ class Vector {
      * @return A reference to `this` Vector after modification.
      */
     Vector &operator=(const Vector &other) {
-        VectorSizeType size = this->size();
-        assert(size == other.size());
-        for (VectorSizeType i = 0; i < size; ++i) {
-            (*this)[i] = other[i];
-        }
+        assert(this->size() == other.size());
+        apply_kernel(other, [](const T a) -> T { return a; });
         precision = other.getPrecision();
         return *this;
     }
@@ -1277,11 +1475,8 @@ class Vector {
      */
     template <typename OtherT>
     Vector &operator=(const Vector<OtherT> &other) {
-        VectorSizeType size = this->size();
-        assert(size == other.size());
-        for (VectorSizeType i = 0; i < size; i++) {
-            (*this)[i] = (T)other[i];
-        }
+        assert(this->size() == other.size());
+        apply_kernel(other, [](const OtherT a) -> T { return (T)a; });
         precision = other.getPrecision();
         return *this;
     }
@@ -1305,25 +1500,15 @@ class Vector {
 
     /**
      * Masks each element in `this` vector by doing a bitwise logical AND with `n`.
-     * TODO: factor out into common macro for other operations using
-     * define_binary_vector_element_assignment_op
      * @param n The mask.
      */
-    void mask(const T &n) {
-        for (VectorSizeType i = 0; i < this->size(); ++i) {
-            (*this)[i] &= n;
-        }
-    }
+    void mask(const T &n) { apply_kernel(*this, [n](const T a) -> T { return a & n; }); }
 
     /**
      * Sets the bits of each element in `this` vector by doing a bitwise logical OR with `n`
      * @param n The element that encodes the bits to set.
      */
-    void set_bits(const T &n) {
-        for (VectorSizeType i = 0; i < this->size(); ++i) {
-            (*this)[i] |= n;
-        }
-    }
+    void set_bits(const T &n) { apply_kernel(*this, [n](const T a) -> T { return a | n; }); }
 
     /**
      * Sets every element of this vector to zero. Don't modify the mapping.
@@ -1353,20 +1538,25 @@ class Vector {
     void resize(size_t n) {
         if (has_mapping()) {
             size_t old_size = total_size();
-            mapping->resize(n);
             int64_t n_new_elm = n - old_size;
 
             if (n_new_elm > 0) {
                 // grew - need to add this many new elements to data
                 size_t data_old_size = data->size();
-                data->resize(data_old_size + n_new_elm);
+                data->resize(data_old_size + n_new_elm, T());
 
                 // new indices for mapping point to the newly added elements.
-                std::iota(mapping->begin() + old_size, mapping->end(), data_old_size);
+                std::vector<VectorSizeType> new_mapping = mapping->to_vector();
+                new_mapping.resize(n);
+                std::iota(new_mapping.begin() + old_size, new_mapping.end(), data_old_size);
+                mapping.emplace(std::move(new_mapping));
+            } else {
+                // shrank - keep a prefix of the mapping
+                mapping = mapping->compose(IndexMapping::affine(0, 1, n));
             }
         } else {
             // no mapping, just change data
-            data->resize(n);
+            data->resize(n, T());
         }
 
         reset_batch();
@@ -1384,7 +1574,7 @@ class Vector {
         auto n_remove = total_size() - n;
 
         if (has_mapping()) {
-            mapping->erase(mapping->begin(), mapping->begin() + n_remove);
+            mapping = mapping->compose(IndexMapping::affine(n_remove, 1, n));
         } else {
             // no mapping. can actually erase data
             data->erase(data->begin(), data->begin() + n_remove);
@@ -1526,11 +1716,8 @@ class Vector {
      * Elementwise plaintext less-than-zero comparison.
      */
     inline Vector ltz() const {
-        VectorSizeType size = this->size();
-        Vector res = this->construct_like();
-        for (VectorSizeType i = 0; i < size; i++) {
-            res[i] = ((*this)[i] < (T)0);
-        }
+        Vector res = uninitialized(this->size());
+        res.apply_kernel(*this, [](const T a) -> T { return a < (T)0; });
         return res;
     }
 
@@ -1539,10 +1726,9 @@ class Vector {
      * Note: this is only makes sense for bit shares.
      */
     inline Vector extend_lsb() const {
-        VectorSizeType size = this->size();
-        Vector res = this->construct_like();
-        for (VectorSizeType i = 0; i < size; i++)
-            res[i] = -((*this)[i] & 1);  // Relies on two's complement
+        Vector res = uninitialized(this->size());
+        // Relies on two's complement
+        res.apply_kernel(*this, [](const T a) -> T { return -(a & 1); });
         return res;
     }
 
@@ -1555,10 +1741,15 @@ class Vector {
      */
     inline Vector extract_valid(Vector valid) {
         assert(this->size() == valid.size());
-        std::vector<T> r;
+        VectorSizeType count = 0;
+        for (VectorSizeType i = 0; i < valid.size(); i++) {
+            count += (valid[i] != 0);
+        }
+        Vector r = uninitialized(count);
+        VectorSizeType j = 0;
         for (VectorSizeType i = 0; i < valid.size(); i++) {
             if (valid[i] != 0) {
-                r.push_back((*this)[i]);
+                r[j++] = (*this)[i];
             }
         }
         return r;
@@ -1590,7 +1781,7 @@ class Vector {
      */
     inline T &operator[](const VectorSizeType &index) {
         if (has_mapping()) {
-            return (*data)[(*mapping)[batch_start + index]];
+            return (*data)[(*mapping)(batch_start + index)];
         } else {
             return (*data)[batch_start + index];
         }
@@ -1605,7 +1796,7 @@ class Vector {
      */
     inline const T &operator[](const VectorSizeType &index) const {
         if (has_mapping()) {
-            return (*data)[(*mapping)[batch_start + index]];
+            return (*data)[(*mapping)(batch_start + index)];
         } else {
             return (*data)[batch_start + index];
         }
@@ -1693,6 +1884,9 @@ class Vector {
 
     template <typename InputType>
     friend class orq::service::Task_ARGS_VOID_2;
+
+    template <typename U>
+    friend class Vector;
 };
 
 /**
@@ -0,0 +1,224 @@
+#pragma once
+
+#include <limits>
+
+#include "b_shared_vector.h"
+
+namespace orq {
+
+/**
+ * A boolean-shared vector of single bits, packed `MAX_BITS_NUMBER` per share.
+ *
+ * Comparison results, validity flags, and grouping bits are single-bit values, but are usually
+ * stored as full-width BSharedVectors (with `mask(1)` applied), so every AND on them sends a whole
+ * `Share` per bit. A PackedBSharedVector stores the same bits densely; element `i` is bit `i %
+ * MAX_BITS_NUMBER` of packed share `i / MAX_BITS_NUMBER`. Since all operations are bitwise, they
+ * can be applied directly to the packed shares, using `MAX_BITS_NUMBER` times less bandwidth.
+ *
+ * Conversion to and from BSharedVector is local (`pack_from` / `unpack_from`) and only touches
+ * a single bit position of the unpacked vector.
+ *
+ * @tparam Share Share data type.
+ * @tparam EVector Share container type.
+ */
+template <typename Share, typename EVector>
+class PackedBSharedVector {
+    static const uint MAX_BITS_NUMBER = std::numeric_limits<std::make_unsigned_t<Share>>::digits;
+
+    using B = BSharedVector<Share, EVector>;
+    using unique_P = std::unique_ptr<PackedBSharedVector>;
+
+    // The number of (logical) bits
+    size_t bits;
+
+    /**
+     * Creates a packed vector from already-packed shares.
+     * @param _bits The number of logical bits.
+     * @param _packed The packed shares.
+     */
+    PackedBSharedVector(const size_t &_bits, B &&_packed) : bits(_bits), packed(_packed) {
+        assert(packed.size() == packed_size(bits));
+    }
+
+   public:
+    /**
+     * The packed shares.
+     */
+    B packed;
+
+    /**
+     * @brief The number of packed shares needed to hold `n` bits.
+     *
+     * @param n
+     * @return size_t
+     */
+    static size_t packed_size(const size_t &n) {
+        return n / MAX_BITS_NUMBER + (n % MAX_BITS_NUMBER > 0);
+    }
+
+    /**
+     * Creates a PackedBSharedVector of `_bits` bits, initialized with zeros.
+     * @param _bits The number of bits.
+     */
+    explicit PackedBSharedVector(const size_t &_bits) : bits(_bits), packed(packed_size(_bits)) {}
+
+    /**
+     * Packs bit `position` of every element of `source`.
+     * @param source The vector to pack.
+     * @param position The bit position to take from each element.
+     */
+    explicit PackedBSharedVector(const B &source, const int &position = 0)
+        : bits(source.size()), packed(packed_size(source.size())) {
+        packed.pack_from(source, position);
+    }
+
+    /**
+     * Move constructor from a unique pointer to a PackedBSharedVector.
+     * @param other The pointer whose contents will be moved to the new vector.
+     */
+    PackedBSharedVector(unique_P &&other) : bits(other->bits), packed(other->packed) {}
+
+    PackedBSharedVector(const PackedBSharedVector &other) = default;
+    PackedBSharedVector &operator=(const PackedBSharedVector &other) = default;
+
+    /**
+     * @return The number of bits in this vector.
+     */
+    size_t size() const { return bits; }
+
+    /**
+     * @brief Pack bit `position` of every element of `source` into this vector.
+     *
+     * @param source
+     * @param position
+     */
+    void pack_from(const B &source, const int &position = 0) {
+        assert(source.size() == bits);
+        packed.pack_from(source, position);
+    }
+
+    /**
+     * @brief Unpack into bit `position` of every element of `dest`. Other bits of `dest` are
+     * unchanged.
+     *
+     * @param dest
+     * @param position
+     */
+    void unpack_into(B &dest, const int &position = 0) const {
+        assert(dest.size() == bits);
+        dest.unpack_from(packed, position);
+    }
+
+    /**
+     * @brief Unpack into a new single-bit BSharedVector (all higher bits are zero).
+     *
+     * @return B
+     */
+    B unpack() const {
+        B res(bits);
+        unpack_into(res);
+        return res;
+    }
+
+    /**
+     * @brief Open the bits to all parties.
+     *
+     * @return Vector<Share> with one element (0 or 1) per bit
+     */
+    Vector<Share> open() const { return unpack().open(); }
+
+    /**
+     * Elementwise secure XOR. Local.
+     */
+    unique_P operator^(const PackedBSharedVector &other) const {
+        assert(bits == other.bits);
+        return unique_P(new PackedBSharedVector(bits, packed ^ other.packed));
+    }
+
+    /**
+     * Elementwise secure AND.
+     */
+    unique_P operator&(const PackedBSharedVector &other) const {
+        assert(bits == other.bits);
+        return unique_P(new PackedBSharedVector(bits, packed & other.packed));
+    }
+
+    /**
+     * Elementwise secure OR.
+     */
+    unique_P operator|(const PackedBSharedVector &other) const {
+        assert(bits == other.bits);
+        return unique_P(new PackedBSharedVector(bits, packed | other.packed));
+    }
+
+    /**
+     * Elementwise secure complement. Local. Padding bits in the last packed share are also
+     * flipped, but are never unpacked.
+     */
+    unique_P operator~() const { return unique_P(new PackedBSharedVector(bits, ~packed)); }
+
+    PackedBSharedVector &operator^=(const PackedBSharedVector &other) {
+        assert(bits == other.bits);
+        packed ^= other.packed;
+        return *this;
+    }
+
+    PackedBSharedVector &operator&=(const PackedBSharedVector &other) {
+        assert(bits == other.bits);
+        packed &= other.packed;
+        return *this;
+    }
+
+    PackedBSharedVector &operator|=(const PackedBSharedVector &other) {
+        assert(bits == other.bits);
+        packed |= other.packed;
+        return *this;
+    }
+
+    /**
+     * @brief Complement in place. Local.
+     */
+    void inplace_invert() { packed.inplace_invert(); }
+};
+
+}  // namespace orq
+
+namespace orq::operators {
+
+/**
+ * @brief Conditional selection between two packed bit vectors. Returns a if sel is false, b if sel
+ * is true. Bits are already aligned, so no extension of the selector is needed.
+ *
+ * @tparam Share The underlying data type of the shared vectors.
+ * @tparam EVector Share container type.
+ * @param sel Packed selector bits.
+ * @param a First input vector (returned when sel is false).
+ * @param b Second input vector (returned when sel is true).
+ * @return The multiplexed result vector.
+ */
+template <typename Share, typename EVector>
+static PackedBSharedVector<Share, EVector> multiplex(const PackedBSharedVector<Share, EVector>& sel,
+                                                     const PackedBSharedVector<Share, EVector>& a,
+                                                     const PackedBSharedVector<Share, EVector>& b) {
+    PackedBSharedVector<Share, EVector> res = a ^ (sel & (b ^ a));
+    return res;
+}
+
+/**
+ * @brief Conditional selection between two boolean shared vectors using a packed selector.
+ *
+ * @tparam Share The underlying data type of the shared vectors.
+ * @tparam EVector Share container type.
+ * @param sel Packed selector bits.
+ * @param a First input vector (returned when sel is false).
+ * @param b Second input vector (returned when sel is true).
+ * @return The multiplexed result vector.
+ */
+template <typename Share, typename EVector>
+static BSharedVector<Share, EVector> multiplex(const PackedBSharedVector<Share, EVector>& sel,
+                                               const BSharedVector<Share, EVector>& a,
+                                               const BSharedVector<Share, EVector>& b) {
+    return multiplex(sel.unpack(), a, b);
+}
+
+}  // namespace orq::operators
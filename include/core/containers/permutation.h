@@ -11,7 +11,7 @@
 namespace orq {
 // type definitions
 using Group = std::set<int>;
-using LocalPermutation = std::vector<int>;
+using LocalPermutation = std::vector<IndexType>;
 
 // forward class declarations
 template <typename EVector>
@@ -37,9 +37,11 @@ namespace operators {
 template <typename EVector>
 class ElementwisePermutation {
     // type definitions
-    using SharedPerm = SharedVector<int, orq::EVector<int, EVector::replicationNumber>>;
-    using ASharedPerm = ASharedVector<int, orq::EVector<int, EVector::replicationNumber>>;
-    using BSharedPerm = BSharedVector<int, orq::EVector<int, EVector::replicationNumber>>;
+    using SharedPerm = SharedVector<IndexType, orq::EVector<IndexType, EVector::replicationNumber>>;
+    using ASharedPerm =
+        ASharedVector<IndexType, orq::EVector<IndexType, EVector::replicationNumber>>;
+    using BSharedPerm =
+        BSharedVector<IndexType, orq::EVector<IndexType, EVector::replicationNumber>>;
 
    public:
     // the underlying SharedVector for the permutation
@@ -60,7 +62,7 @@ class ElementwisePermutation {
      * @param encoding The encoding type of the underlying SharedVector (arithmetic or binary).
      */
     ElementwisePermutation(size_t size, Encoding encoding) : sharedVector(size, encoding) {
-        Vector<int> identity(size);
+        Vector<IndexType> identity(size);
         std::iota(identity.begin(), identity.end(), 0);
 
         // public sharing does the same thing for AShared and BShared
@@ -81,15 +83,15 @@ class ElementwisePermutation {
      * @param v The SharedVector to copy.
      *
      * The second template argument is named argEVector to distinguish it from the EVector that this
-     * class is templated by. This function copies the underlying data to a 32 bit SharedVector,
-     * which requires that the input vector has a bitwidth <= 32.
+     * class is templated by. This function copies the underlying data to an IndexType
+     * SharedVector, which requires that the input vector is no wider than IndexType.
      */
     template <typename Share, typename argEVector>
     ElementwisePermutation(const SharedVector<Share, argEVector> &v)
         : sharedVector(v.vector, v.encoding) {
-        // ensure we're not discarding data when converting to 32 bits
+        // ensure we're not discarding data when converting to IndexType
         const int bit_length = std::numeric_limits<std::make_unsigned_t<Share>>::digits;
-        static_assert(bit_length <= 32);
+        static_assert(bit_length <= std::numeric_limits<std::make_unsigned_t<IndexType>>::digits);
     }
 
     /**
@@ -111,8 +113,8 @@ class ElementwisePermutation {
      * @param other The SharedVector to copy.
      *
      * The second template argument is named argEVector to distinguish it from the EVector that this
-     * class is templated by. This function copies the underlying data to a 32 bit SharedVector,
-     * which requires that the input vector has a bitwidth <= 32.
+     * class is templated by. This function copies the underlying data to an IndexType
+     * SharedVector, keeping the low bits of wider inputs.
      */
     template <typename Share, typename argEVector>
     ElementwisePermutation &operator=(const SharedVector<Share, argEVector> &other) {
@@ -152,8 +154,8 @@ class ElementwisePermutation {
     /**
      * Open the underlying SharedVector.
      */
-    Vector<int> open() {
-        Vector<int> opened = sharedVector.open();
+    Vector<IndexType> open() {
+        Vector<IndexType> opened = sharedVector.open();
         return opened;
     }
 
@@ -177,8 +179,8 @@ class ElementwisePermutation {
     ElementwisePermutation reverse() {
         assert(sharedVector.encoding == Encoding::AShared);
 
-        Vector<int> negative_one_plaintext = {-1};
-        Vector<int> additive_constant_plaintext = {static_cast<int>(size()) - 1};
+        Vector<IndexType> negative_one_plaintext = {-1};
+        Vector<IndexType> additive_constant_plaintext = {static_cast<IndexType>(size()) - 1};
 
         ASharedPerm negative_one =
             orq::service::runTime->public_share<EVector::replicationNumber>(negative_one_plaintext)
@@ -237,13 +239,13 @@ class ElementwisePermutation {
         ElementwisePermutation<EVector> permutation(*this);
 
         // generate a random sharded permutation
-        auto pi = random::PermutationManager::get()->getNext<int>(size(), Encoding::BShared);
+        auto pi = random::PermutationManager::get()->getNext<IndexType>(size(), Encoding::BShared);
 
         // shuffle the permutation according to pi
         orq::operators::oblivious_apply_sharded_perm(permutation.sharedVector, pi);
 
         // open pi(perm)
-        Vector<int> pi_perm = permutation.open();
+        Vector<IndexType> pi_perm = permutation.open();
 
         ASharedPerm ret = orq::service::runTime->public_share<EVector::replicationNumber>(pi_perm);
 
@@ -266,7 +268,7 @@ class ElementwisePermutation {
      *      shift down by 1 (0 to n-1).
      */
     ElementwisePermutation negate() {
-        Vector<int> negative_one_plaintext = {-1};
+        Vector<IndexType> negative_one_plaintext = {-1};
 
         ASharedPerm negative_one =
             orq::service::runTime->public_share<EVector::replicationNumber>(negative_one_plaintext)
@@ -120,9 +120,9 @@ class SharedVector : public EncodedVector {
      * @return The opened (plaintext) vector.
      */
     Vector<T> open() const {
-        // Not allowed to open non-materialized vectors, since communicators
-        // don't support access patterns. If no mapping, this is a nop.
-        auto v = this->vector.has_mapping() ? this->vector.materialize() : this->vector;
+        // Communicators send and receive mapped vectors in place, so views are
+        // opened without materializing them first.
+        auto v = this->vector;
 
         return [&, this] {
             if (this->encoding == Encoding::BShared) {
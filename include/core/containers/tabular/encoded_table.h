@@ -14,8 +14,10 @@
 #include "core/operators/sorting.h"
 #include "core/operators/streaming.h"
 #include "encoded_column.h"
+#include "lazy_column.h"
 #include "profiling/stopwatch.h"
 #include "profiling/utils.h"
+#include "share_file.h"
 #include "shared_column.h"
 
 /**
@@ -149,6 +151,9 @@ class EncodedTable {
     // The number of rows in the table
     size_t rows;
 
+    // Declared public domains of key columns (see `setDomain`)
+    std::map<std::string, std::vector<Share>> domains;
+
     Share MASK_VALUE = std::numeric_limits<Share>::max();
 
     using LabeledDataTable = std::pair<DataTable, std::vector<std::string>>;
@@ -227,6 +232,20 @@ class EncodedTable {
     EncodedTable _join(EncodedTable &right, std::vector<std::string> keys, AggregationSpec agg_spec,
                        JoinOptions opt);
 
+    /**
+     * @brief Internal oblivious expansion, used by `many_to_many_join`.
+     */
+    EncodedTable _distribute(A start, A total, const std::vector<std::string> &columns,
+                             size_t bound);
+
+    /**
+     * @brief Check and invert opened output positions, used by `_distribute` and
+     * `many_to_many_join`.
+     */
+    static std::vector<VectorSizeType> _output_permutation(
+        const Vector<Share> &positions, const std::vector<VectorSizeType> &sources,
+        const std::string &op);
+
    public:
     /**
      * @brief Name of this table. Used for output and organization.
@@ -297,7 +316,12 @@ class EncodedTable {
      */
     template <typename T>
     void filter(T &&e) {
-        (*this)[ENC_TABLE_VALID] &= std::forward<T>(e);
+        if constexpr (std::is_same_v<std::decay_t<T>, typename SharedColumn::Lazy>) {
+            // evaluate the whole predicate (fused), then AND into valid
+            and_valid(*e.materialize());
+        } else {
+            and_valid(e);
+        }
     }
 
     /**
@@ -310,7 +334,7 @@ class EncodedTable {
      */
     template <typename T>
     void filter(std::unique_ptr<T> e) {
-        (*this)[ENC_TABLE_VALID] &= std::forward<T>(*e);
+        and_valid(*e);
     }
 
     /**
@@ -339,6 +363,17 @@ class EncodedTable {
         }
     }
 
+    /**
+     * @brief Get a lazy expression referring to column `name`. Operations on the result are
+     * deferred until `materialize()` (or `filter()`) so that their rounds can be fused.
+     *
+     * @param name
+     * @return typename SharedColumn::Lazy
+     */
+    typename SharedColumn::Lazy lazy(const std::string &name) {
+        return typename SharedColumn::Lazy((*this)[name]);
+    }
+
     /**
      * @brief Get column `name` as a BSharedVector.
      *
@@ -395,7 +430,7 @@ class EncodedTable {
      */
     inline void inputCSVTableData(const std::string &_file_path, const int &_input_party) {
         // get the table size
-        int current_rows = this->size();
+        size_t current_rows = this->size();
 
         // All parties gerenate initial data vectors for all columns
         std::vector<std::string> available_column_names;
@@ -430,7 +465,7 @@ class EncodedTable {
                 }
 
                 // Data lines
-                int row_index = 0;
+                size_t row_index = 0;
                 while (std::getline(file, line) && row_index < current_rows) {
                     std::stringstream ss(line);
                     std::string token;
@@ -457,7 +492,7 @@ class EncodedTable {
                                                     found_column_index.end(), valid_index);
                     if (valid_index_it == found_column_index.end()) {
                         // VALID bit was not read, so we need to set it to 1
-                        for (int i = 0; i < row_index; ++i) {
+                        for (size_t i = 0; i < row_index; ++i) {
                             read_column_data[valid_index][i] = 1;
                         }
                     }
@@ -500,7 +535,7 @@ class EncodedTable {
 
         std::ifstream file(_file_path);
 
-        int row_index = 0;
+        size_t row_index = 0;
         if (file.is_open()) {
             // Read the first line to get the column names
             std::getline(file, line);
@@ -525,7 +560,7 @@ class EncodedTable {
             }
 
             // Read the rest of the lines to get the column values
-            long long current_rows = this->size();
+            size_t current_rows = this->size();
             while (std::getline(file, line) && row_index < current_rows) {
                 std::stringstream ss(line);
                 std::string token;
@@ -618,6 +653,101 @@ class EncodedTable {
         }
     }
 
+    /**
+     * Reads table secret shares from a binary share file written by
+     * `outputBinaryTableSecretShares`. The file is memory-mapped and each column's shares are
+     * copied into the table in parallel. Columns are matched by name; columns of the file that
+     * are not in the schema are ignored. At most `size()` rows are read.
+     * Note: as with the CSV reader, if the file has no valid column, the valid bit is set for the
+     * rows read.
+     * @param _file_path The file containing the table secret shares.
+     */
+    inline void inputBinaryTableSecretShares(const std::string &_file_path) {
+        ShareFileReader reader(_file_path);
+        auto &header = reader.getHeader();
+
+        const int replication = ((B *)(schema.begin()->second->contents.get()))
+                                    ->asEVector()
+                                    .getReplicationNumber();
+        if (header.replication != replication || header.share_bytes != sizeof(Share)) {
+            throw std::runtime_error("Share file " + _file_path + " does not match the protocol (" +
+                                     std::to_string(header.replication) + " shares of " +
+                                     std::to_string(header.share_bytes) + " bytes)");
+        }
+
+        const size_t n = std::min((size_t)header.rows, (size_t)this->size());
+
+        // Collect the (source, destination) pair of every block to copy
+        std::vector<std::pair<const Share *, Vector<Share>>> copies;
+        std::set<std::string> column_names_set;
+        auto &columns = reader.getColumns();
+        for (size_t c = 0; c < columns.size(); c++) {
+            auto it = schema.find(columns[c].name);
+            if (it == schema.end()) {
+                continue;
+            }
+            if (it->second->encoding != columns[c].encoding) {
+                throw std::runtime_error("Share file column " + columns[c].name +
+                                         " has the wrong encoding");
+            }
+            column_names_set.insert(columns[c].name);
+            for (int r = 0; r < replication; r++) {
+                copies.push_back({(const Share *)reader.block(c, r),
+                                  ((B *)it->second->contents.get())->vector(r)});
+            }
+        }
+
+        runTime->execute_parallel_unsafe(n, [&](const size_t start, const size_t end) {
+            for (auto &[src, dst] : copies) {
+                if (!dst.has_mapping()) {
+                    std::memcpy(dst.batch_span().data() + start, src + start,
+                                (end - start) * sizeof(Share));
+                } else {
+                    for (size_t i = start; i < end; i++) {
+                        dst[i] = src[i];
+                    }
+                }
+            }
+        });
+
+        if (this->schema.find(ENC_TABLE_VALID) != this->schema.end() &&
+            column_names_set.find(ENC_TABLE_VALID) == column_names_set.end()) {
+            Vector<Share> sel_plain(n, 1);
+            B sel_secret = (*(B *)((*this)[ENC_TABLE_VALID].contents.get())).slice(0, n);
+
+            secret_share_vec(sel_plain, sel_secret);
+        }
+    }
+
+    /**
+     * Outputs the table secret shares to a binary share file (see `share_file.h` for the
+     * layout). Every column of the schema is written, including the reserved ones. Blocks are
+     * written in parallel by the runtime threads.
+     * @param _file_path The file to write the table secret shares to.
+     */
+    inline void outputBinaryTableSecretShares(const std::string &_file_path) {
+        std::vector<ShareFileColumn> columns;
+        std::vector<Vector<Share>> vectors;
+        std::vector<const void *> blocks;
+
+        const int replication = ((B *)(schema.begin()->second->contents.get()))
+                                    ->asEVector()
+                                    .getReplicationNumber();
+        for (auto const &imap : schema) {
+            columns.push_back({imap.first, imap.second->encoding});
+            for (int r = 0; r < replication; r++) {
+                auto v = ((B *)(imap.second->contents.get()))->vector(r);
+                // Blocks must be contiguous
+                vectors.push_back(v.has_mapping() ? v.materialize() : v);
+            }
+        }
+        for (auto &v : vectors) {
+            blocks.push_back(v.batch_span().data());
+        }
+
+        write_share_file(_file_path, columns, rows, replication, sizeof(Share), blocks);
+    }
+
     /**
      * Output the secret shares of a column to a file. The file will contain one
      * line for each element in the column. Each line will contain the replicated
@@ -685,7 +815,10 @@ class EncodedTable {
         Vector<Share> valid(rows);
         for (auto &c : schema) {
             Vector<Share> v(rows);
-            if (c.second->encoding == Encoding::BShared) {
+            if (c.first == ENC_TABLE_VALID) {
+                // The valid column holds single bits
+                v = ((B *)(c.second.get())->contents.get())->open_low_bits(1);
+            } else if (c.second->encoding == Encoding::BShared) {
                 v = ((B *)(c.second.get())->contents.get())->open();
             } else if (c.second->encoding == Encoding::AShared) {
                 v = ((A *)(c.second.get())->contents.get())->open();
@@ -1172,7 +1305,7 @@ class EncodedTable {
                 if (opt.reverse) {
                     // reverse. bottom row valid
                     auto short_valid = valid_col.slice(0, valid_col.size() - 1);
-                    short_valid &= uniq_col.slice(1);
+                    short_valid.and_low_bits(uniq_col.slice(1), 1);
                 } else {
                     // non-reverse. select top row only
                     filter((*this)[ENC_TABLE_UNIQ]);
@@ -1187,6 +1320,198 @@ class EncodedTable {
         return *this;
     }
 
+    /**
+     * @brief Declare the public domain of a key column, i.e., every value the column may take.
+     * Used by `domainAggregate`.
+     *
+     * @param column the key column
+     * @param values the domain values
+     */
+    void setDomain(const std::string &column, const std::vector<Share> &values) {
+        assert(schema.find(column) != schema.end());
+        domains[column] = values;
+    }
+
+    /**
+     * @brief Sort-free group-by for keys with small public domains (declared with `setDomain`).
+     *
+     * Computes, for every combination of domain values, a one-hot indicator over the valid rows
+     * and evaluates all sums and counts as dot products with it. Unlike `aggregate`, the table is
+     * neither sorted nor padded: the cost is linear in `n * |groups|`. The sums take a constant
+     * number of rounds; marking the valid groups takes `log n` rounds of single-bit ANDs.
+     *
+     * Groups are ordered by domain index, with the first key most significant. Groups with no
+     * valid rows are marked invalid in the result. Validity is the OR of the group's indicator,
+     * not a nonzero count, so a group of `2^w` rows is still valid.
+     *
+     * NOTE: only `sum` and `count` over arithmetic columns are supported. Sums and counts wrap
+     * modulo the share width.
+     *
+     * @param keys the key columns (boolean-shared)
+     * @param agg_spec the aggregations
+     * @return EncodedTable a new table with one row per group, holding the key and result
+     * columns
+     */
+    EncodedTable domainAggregate(const std::vector<std::string> &keys, AggregationSpec agg_spec) {
+        BEGIN_TABLE_PROFILING();
+
+        const size_t n = size();
+
+        size_t num_groups = 1;
+        size_t num_indicators = 0;
+        for (auto &k : keys) {
+            auto d = domains.find(k);
+            if (d == domains.end()) {
+                throw std::runtime_error("No domain declared for key column " + k);
+            }
+            if (!isBShared(k)) {
+                throw std::runtime_error("Key column " + k + " must be boolean-shared");
+            }
+            num_groups *= d->second.size();
+            num_indicators += d->second.size();
+        }
+
+        // Compare every key against every value of its domain in one batched circuit
+        B lhs(num_indicators * n);
+        Vector<Share> values(num_indicators * n);
+        size_t offset = 0;
+        for (auto &k : keys) {
+            auto key = *(B *)(*this)[k].contents.get();
+            for (auto &v : domains[k]) {
+                B dst = lhs.slice(offset, offset + n);
+                dst = key;
+                std::fill(values.begin() + offset, values.begin() + offset + n, v);
+                offset += n;
+            }
+        }
+        B rhs = runTime->public_share<SharedColumn::replicationNumber>(values);
+        B eq = lhs == rhs;
+
+        // Combine into one indicator per group; group g occupies rows [g * n, (g + 1) * n)
+        uniqB indicator = std::make_unique<B>(*getValidVector());
+        size_t groups = 1;
+        offset = 0;
+        for (auto &k : keys) {
+            const size_t domain_size = domains[k].size();
+
+            // repeat each group's block once per domain value
+            B left(groups * domain_size * n);
+            for (size_t g = 0; g < groups; g++) {
+                for (size_t v = 0; v < domain_size; v++) {
+                    B dst = left.slice((g * domain_size + v) * n, (g * domain_size + v + 1) * n);
+                    dst = indicator->slice(g * n, (g + 1) * n);
+                }
+            }
+            B right = eq.slice(offset * n, (offset + domain_size) * n)
+                          .cyclic_subset_reference(groups);
+
+            typename B::Packed indicator_p(left);
+            indicator_p &= typename B::Packed(right);
+            indicator = std::make_unique<B>(left.size());
+            indicator_p.unpack_into(*indicator);
+
+            groups *= domain_size;
+            offset += domain_size;
+        }
+        A indicator_a = indicator->b2a_bit();
+
+        // Sums and counts as a single batched dot product
+        std::vector<std::string> results;
+        std::vector<std::optional<A>> inputs;
+        for (auto [_data, _result, func] : agg_spec) {
+            if ((*this)[_data].encoding != Encoding::AShared) {
+                throw std::runtime_error("domainAggregate only supports arithmetic columns");
+            }
+            auto f = func.getA();
+            if (f == &orq::aggregators::count<A>) {
+                inputs.push_back(std::nullopt);
+            } else if (f == &orq::aggregators::sum<A>) {
+                inputs.push_back(*(A *)(*this)[_data].contents.get());
+            } else {
+                throw std::runtime_error("domainAggregate only supports sum and count");
+            }
+            results.push_back(_result);
+        }
+
+        Vector<Share> one(1, 1);
+        A shared_one = runTime->public_share<SharedColumn::replicationNumber>(one);
+
+        const size_t block = num_groups * n;
+        A x(inputs.size() * block);
+        A y(inputs.size() * block);
+        x = indicator_a.cyclic_subset_reference(inputs.size());
+        for (size_t j = 0; j < inputs.size(); j++) {
+            A dst = y.slice(j * block, (j + 1) * block);
+            if (inputs[j].has_value()) {
+                dst = inputs[j]->cyclic_subset_reference(num_groups);
+            } else {
+                dst = shared_one.repeated_subset_reference(block);
+            }
+        }
+        A sums = x.dot_product(y, n);
+
+        // Build the result table
+        std::vector<std::string> columns = keys;
+        for (auto &r : results) {
+            if (std::find(columns.begin(), columns.end(), r) == columns.end()) {
+                columns.push_back(r);
+            }
+        }
+        EncodedTable res(tableName, columns, num_groups);
+
+        size_t stride = num_groups;
+        for (auto &k : keys) {
+            auto &domain = domains[k];
+            stride /= domain.size();
+
+            Vector<Share> key_values(num_groups);
+            for (size_t g = 0; g < num_groups; g++) {
+                key_values[g] = domain[(g / stride) % domain.size()];
+            }
+            auto dst = *(B *)res[k].contents.get();
+            dst = runTime->public_share<SharedColumn::replicationNumber>(key_values);
+        }
+
+        for (size_t j = 0; j < results.size(); j++) {
+            auto dst = *(A *)res[results[j]].contents.get();
+            dst = sums.slice(j * num_groups, (j + 1) * num_groups);
+        }
+
+        // A group is valid iff any of its rows is: OR each group's indicator bits in a tree, all
+        // groups at once. The bits are single bits, so `a | b = a ^ b ^ (a & b)` only ANDs one bit
+        // per row.
+        if (n > 0) {
+            B any(indicator->size());
+            any = *indicator;
+            for (size_t m = n; m > 1; m -= m / 2) {
+                const size_t h = m / 2;
+                std::vector<VectorSizeType> lo_rows, hi_rows;
+                lo_rows.reserve(num_groups * h);
+                hi_rows.reserve(num_groups * h);
+                for (size_t g = 0; g < num_groups; g++) {
+                    for (size_t i = 0; i < h; i++) {
+                        lo_rows.push_back(g * n + i);
+                        hi_rows.push_back(g * n + m - h + i);
+                    }
+                }
+                B lo = any.mapping_reference(lo_rows);
+                B hi = any.mapping_reference(hi_rows);
+                B next(lo.size());
+                next = lo;
+                next.and_low_bits(hi, 1);
+                next ^= lo;
+                next ^= hi;
+                lo = next;
+            }
+            auto valid = *res.getValidVector();
+            valid = any.simple_subset_reference(0, n, num_groups * n - 1);
+        }
+
+        END_TABLE_PROFILING("domainAggregate");
+
+        return res;
+    }
+
     /**
      * @brief Distinct operation on provided columns.
      * Requires equivalent rows to be adjacent to be considered for the distinct.
@@ -1635,6 +1960,12 @@ class EncodedTable {
                          AggregationSpec agg_spec = {}, JoinOptions opt = {},
                          const SortingProtocol protocol = SortingProtocol::DEFAULT);
 
+    EncodedTable hash_join(EncodedTable &right, std::vector<std::string> keys,
+                           AggregationSpec agg_spec = {});
+
+    EncodedTable many_to_many_join(EncodedTable &right, std::vector<std::string> keys, size_t bound,
+                                   AggregationSpec agg_spec = {});
+
     /**
      * @brief Extend the LSB of a column. All other bits are ignored. A
      * value ending with a binary `1` will become all `1`s; namely, `-1`
@@ -1734,6 +2065,22 @@ class EncodedTable {
     }
 
    private:
+    /**
+     * @brief AND the (single-bit) column `e` into the valid column. Both are packed first, so
+     * the AND only communicates one bit per row.
+     *
+     * @param e a BShared column with the same number of rows as this table
+     */
+    void and_valid(const EncodedColumn &e) {
+        assert(e.encoding == Encoding::BShared);
+        B &valid = *getValidVector();
+        typename B::Packed valid_p(valid);
+        valid_p &= typename B::Packed(*(const B *)e.contents.get());
+        valid_p.unpack_into(valid);
+    }
+
+    void and_valid(const std::unique_ptr<EncodedColumn> &e) { and_valid(*e); }
+
     /**
      * @brief Copy column from table `t` into this table. This table's
      * schema is assumed to already contain a column of the correct name.
@@ -1788,5 +2135,25 @@ class EncodedTable {
     void copy_column(EncodedTable &t, std::string name, VectorSizeType start_index = 0) {
         copy_column(t, name, name, start_index);
     }
+
+    /**
+     * @brief Fill column `to` of this table with the rows of column `from` of table `t` at the
+     * given (public) indices.
+     *
+     * @param t
+     * @param from
+     * @param to
+     * @param rows one index into `t` per row of this table
+     */
+    void gather_column(EncodedTable &t, std::string from, std::string to,
+                       const std::vector<VectorSizeType> &rows) {
+        auto src = t[from].contents.get();
+        auto dst = (*this)[to].contents.get();
+        if (t[from].encoding == Encoding::BShared) {
+            *(B *)dst = ((B *)src)->mapping_reference(rows);
+        } else {
+            *(A *)dst = ((A *)src)->mapping_reference(rows);
+        }
+    }
 };
 }  // namespace orq::relational
@@ -0,0 +1,701 @@
+#pragma once
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "shared_column.h"
+
+/**
+ * @brief Record a binary operation (with a column or a public constant) as a LazyColumn node
+ *
+ */
+#define lazy_binary_op(_op_, _lazy_op_)                        \
+    LazyColumn operator _op_(const LazyColumn & other) const { \
+        return make(LazyOp::_lazy_op_, node, other.node);      \
+    }                                                          \
+    LazyColumn operator _op_(const int64_t & other) const {    \
+        return make(LazyOp::_lazy_op_, node, nullptr, other);  \
+    }
+
+namespace orq::relational {
+
+/**
+ * @brief Operations which can be recorded in a LazyColumn expression.
+ *
+ */
+enum class LazyOp {
+    Leaf,
+    // binary
+    Add,
+    Sub,
+    Mul,
+    And,
+    Or,
+    Xor,
+    Eq,
+    Neq,
+    Lt,
+    Lte,
+    Gt,
+    Gte,
+    // unary
+    Neg,
+    Invert,
+    Not,
+    Ltz
+};
+
+/**
+ * @brief A lazily-evaluated column expression.
+ *
+ * Operators on a LazyColumn do not execute anything; they record a node in an expression DAG
+ * whose leaves are existing columns. Calling `materialize()` schedules the DAG by round depth:
+ * all interactive nodes at the same depth which run on the same kernel are concatenated and
+ * evaluated by a single runtime call, so they share their communication rounds. The kernels are
+ * arithmetic multiplication, AND (which also evaluates OR, as `x ^ y ^ (x & y)`), the boolean
+ * adder and subtractor, and comparison: every comparison is normalized to `x > y` or `x == y`
+ * (swapping operands and negating the result as needed) and evaluated with `_compare`, which
+ * returns both. Local nodes (e.g. XOR, arithmetic addition, and multiplication, AND, or OR with a
+ * public constant) are evaluated in place between rounds, and intermediate results are freed as
+ * soon as their last consumer has run.
+ *
+ * Leaf columns are referenced, not copied, and must stay alive and unmodified until the
+ * expression is materialized.
+ *
+ * Example:
+ *
+ *     auto q = table.lazy("[Quantity]");
+ *     auto d = table.lazy("[Discount]");
+ *     table.filter((q < 24) & (d >= 5) & (d <= 7));
+ *
+ * evaluates all three comparisons with one `_compare` call, then the two ANDs in two further
+ * calls (they depend on each other).
+ *
+ * @tparam Share Share data type.
+ * @tparam EVector Container data type.
+ */
+template <typename Share, typename EVector>
+class LazyColumn {
+    using Column = SharedColumn<Share, EVector>;
+    using SVector = SharedVector<Share, EVector>;
+    using A = ASharedVector<Share, EVector>;
+    using B = BSharedVector<Share, EVector>;
+
+    struct Node {
+        LazyOp op;
+        Encoding encoding;
+        size_t size;
+
+        // number of levels of interactive operations at or below this node
+        int level = 0;
+
+        // whether the value is known to be a single bit (e.g. a comparison result), so that ANDs
+        // with it only need to communicate the least significant bit
+        bool single_bit = false;
+
+        std::shared_ptr<Node> lhs, rhs;
+        std::optional<int64_t> constant;
+
+        // for leaves, the referenced column
+        const EncodedColumn *leaf = nullptr;
+
+        // evaluation state; only valid during `materialize`
+        const EncodedColumn *value = nullptr;
+        std::unique_ptr<EncodedColumn> owned;
+        int uses = 0;
+    };
+
+    std::shared_ptr<Node> node;
+
+    LazyColumn(std::shared_ptr<Node> _node) : node(_node) {}
+
+    /**
+     * @brief The interactive kernel which evaluates a node. Nodes at the same depth with the same
+     * kernel are evaluated together.
+     */
+    enum class Kernel { None, Mul, And, Add, Sub, Compare };
+
+    /**
+     * @brief Get the kernel of a node, or `Kernel::None` if it is local.
+     *
+     * @param n
+     * @return Kernel
+     */
+    static Kernel kernel(const Node &n) {
+        const bool boolean = n.lhs && n.lhs->encoding == Encoding::BShared;
+        switch (n.op) {
+            case LazyOp::Add:
+                // the boolean adder is interactive; arithmetic addition is local
+                return boolean ? Kernel::Add : Kernel::None;
+            case LazyOp::Sub:
+                return boolean ? Kernel::Sub : Kernel::None;
+            case LazyOp::Mul:
+                // multiplying by a public constant is local
+                return n.constant ? Kernel::None : Kernel::Mul;
+            case LazyOp::And:
+            case LazyOp::Or:
+                return n.constant ? Kernel::None : Kernel::And;
+            case LazyOp::Eq:
+            case LazyOp::Neq:
+            case LazyOp::Lt:
+            case LazyOp::Lte:
+            case LazyOp::Gt:
+            case LazyOp::Gte:
+                return Kernel::Compare;
+            default:
+                return Kernel::None;
+        }
+    }
+
+    /**
+     * @brief Whether a comparison is evaluated as `x > y` (true) or `x == y` (false).
+     */
+    static bool compare_gt(const LazyOp op) { return op != LazyOp::Eq && op != LazyOp::Neq; }
+
+    /**
+     * @brief Whether a comparison swaps its operands: `x < y` is `y > x`, `x >= y` is `!(y > x)`.
+     */
+    static bool compare_swap(const LazyOp op) { return op == LazyOp::Lt || op == LazyOp::Gte; }
+
+    /**
+     * @brief Whether a comparison negates its kernel output: `!=`, `<=`, and `>=`.
+     */
+    static bool compare_negate(const LazyOp op) {
+        return op == LazyOp::Neq || op == LazyOp::Lte || op == LazyOp::Gte;
+    }
+
+    /**
+     * @brief One operand of a kernel: a column, or a public constant.
+     */
+    struct Operand {
+        const EncodedColumn *column;
+        std::optional<int64_t> constant;
+    };
+
+    /**
+     * @brief Create a new binary or unary node.
+     *
+     * @param op
+     * @param lhs
+     * @param rhs second operand, if any
+     * @param constant public second operand, if any
+     * @return LazyColumn
+     */
+    static LazyColumn make(const LazyOp op, const std::shared_ptr<Node> &lhs,
+                           const std::shared_ptr<Node> &rhs = nullptr,
+                           std::optional<int64_t> constant = std::nullopt) {
+        auto n = std::make_shared<Node>();
+        n->op = op;
+        n->lhs = lhs;
+        n->rhs = rhs;
+        n->constant = constant;
+        n->size = lhs->size;
+
+        switch (op) {
+            case LazyOp::Add:
+            case LazyOp::Sub:
+            case LazyOp::Mul:
+            case LazyOp::Neg:
+                n->encoding = lhs->encoding;
+                break;
+            default:
+                n->encoding = Encoding::BShared;
+                break;
+        }
+
+        if (rhs) {
+            assert(lhs->size == rhs->size);
+            assert(lhs->encoding == rhs->encoding);
+        }
+
+        const bool bit_constant = constant && (constant.value() & ~(int64_t)1) == 0;
+        switch (op) {
+            case LazyOp::And:
+                // one single-bit operand clears all higher bits of the result
+                n->single_bit = lhs->single_bit || (rhs && rhs->single_bit) || bit_constant;
+                break;
+            case LazyOp::Or:
+            case LazyOp::Xor:
+                n->single_bit = lhs->single_bit && ((rhs && rhs->single_bit) || bit_constant);
+                break;
+            case LazyOp::Not:
+                n->single_bit = lhs->single_bit;
+                break;
+            default:
+                n->single_bit = kernel(*n) == Kernel::Compare;
+                break;
+        }
+
+        int child_level = std::max(lhs->level, rhs ? rhs->level : 0);
+        n->level = child_level + (kernel(*n) != Kernel::None ? 1 : 0);
+
+        return LazyColumn(n);
+    }
+
+    /**
+     * @brief Evaluate a single operation eagerly, using the column operators.
+     *
+     * @param op
+     * @param x
+     * @param y second operand, if any
+     * @param k public second operand, if any
+     * @return std::unique_ptr<EncodedColumn>
+     */
+    static std::unique_ptr<EncodedColumn> apply(const LazyOp op, const EncodedColumn &x,
+                                                const EncodedColumn *y, std::optional<int64_t> k) {
+        if (k.has_value()) {
+            auto c = k.value();
+            switch (op) {
+                case LazyOp::Add:
+                    return x + c;
+                case LazyOp::Sub:
+                    return x + (-c);
+                case LazyOp::Mul: {
+                    // local: scale each share
+                    auto v = static_cast<const A *>(x.contents.get());
+                    return std::make_unique<Column>(std::make_unique<A>(v->vector * (Share)c));
+                }
+                case LazyOp::And: {
+                    // local: mask each share
+                    auto v = static_cast<const B *>(x.contents.get());
+                    return std::make_unique<Column>(std::make_unique<B>(v->vector & (Share)c));
+                }
+                case LazyOp::Or: {
+                    // local: x | c = (x & ~c) ^ c
+                    auto v = static_cast<const B *>(x.contents.get());
+                    Column masked(std::make_unique<B>(v->vector & (Share)~c));
+                    return masked ^ c;
+                }
+                case LazyOp::Xor:
+                    return x ^ c;
+                case LazyOp::Eq:
+                    return x == c;
+                case LazyOp::Neq:
+                    return x != c;
+                case LazyOp::Lt:
+                    return x < c;
+                case LazyOp::Lte:
+                    return x <= c;
+                case LazyOp::Gt:
+                    return x > c;
+                case LazyOp::Gte:
+                    return x >= c;
+                default:
+                    break;
+            }
+        } else if (y != nullptr) {
+            switch (op) {
+                case LazyOp::Add:
+                    return x + *y;
+                case LazyOp::Sub:
+                    return x - *y;
+                case LazyOp::Mul:
+                    return x * *y;
+                case LazyOp::And:
+                    return x & *y;
+                case LazyOp::Or:
+                    return x | *y;
+                case LazyOp::Xor:
+                    return x ^ *y;
+                case LazyOp::Eq:
+                    return x == *y;
+                case LazyOp::Neq:
+                    return x != *y;
+                case LazyOp::Lt:
+                    return x < *y;
+                case LazyOp::Lte:
+                    return x <= *y;
+                case LazyOp::Gt:
+                    return x > *y;
+                case LazyOp::Gte:
+                    return x >= *y;
+                default:
+                    break;
+            }
+        } else {
+            switch (op) {
+                case LazyOp::Neg:
+                    return -x;
+                case LazyOp::Invert:
+                    return ~x;
+                case LazyOp::Not:
+                    return !x;
+                case LazyOp::Ltz:
+                    return const_cast<EncodedColumn &>(x).ltz();
+                default:
+                    break;
+            }
+        }
+
+        std::cerr << "ERROR: unsupported lazy column operation\n";
+        abort();
+    }
+
+    /**
+     * @brief Concatenate operands of the same encoding into a newly allocated column. Constants
+     * are public, so sharing them requires no communication.
+     *
+     * @param parts
+     * @param sizes the size of each part
+     * @param encoding
+     * @param total total size of all parts
+     * @return std::unique_ptr<Column>
+     */
+    static std::unique_ptr<Column> concatenate(const std::vector<Operand> &parts,
+                                               const std::vector<size_t> &sizes,
+                                               const Encoding encoding, const size_t total) {
+        std::unique_ptr<Column> res;
+        if (std::any_of(parts.begin(), parts.end(), [](auto &p) { return p.constant; })) {
+            Vector<Share> k(total);
+            size_t offset = 0;
+            for (size_t i = 0; i < parts.size(); i++) {
+                if (parts[i].constant) {
+                    std::fill(k.begin() + offset, k.begin() + offset + sizes[i],
+                              (Share)parts[i].constant.value());
+                }
+                offset += sizes[i];
+            }
+            auto ev = orq::service::runTime->public_share<EVector::replicationNumber>(k);
+            if (encoding == Encoding::AShared) {
+                res = std::make_unique<Column>(std::make_unique<A>(std::move(ev)));
+            } else {
+                res = std::make_unique<Column>(std::make_unique<B>(std::move(ev)));
+            }
+        } else {
+            res = std::make_unique<Column>(total, encoding);
+        }
+        auto rv = static_cast<SVector *>(res->contents.get());
+
+        size_t offset = 0;
+        for (size_t i = 0; i < parts.size(); i++) {
+            if (parts[i].column) {
+                auto dst = rv->slice(offset, offset + sizes[i]);
+                dst = *static_cast<const SVector *>(parts[i].column->contents.get());
+            }
+            offset += sizes[i];
+        }
+        return res;
+    }
+
+    /**
+     * @brief Wrap a view of a kernel output as a node's result.
+     *
+     * @param n
+     * @param z the kernel output
+     * @param offset where the node's rows start in `z`
+     */
+    static void set_view(Node *n, const EncodedColumn &z, const size_t offset) {
+        auto zv = static_cast<const SVector *>(z.contents.get());
+        EVector ev = zv->vector.slice(offset, offset + n->size);
+        if (z.encoding == Encoding::AShared) {
+            n->owned = std::make_unique<Column>(std::make_unique<A>(ev));
+        } else {
+            n->owned = std::make_unique<Column>(std::make_unique<B>(ev));
+        }
+        n->value = n->owned.get();
+    }
+
+    /**
+     * @brief Evaluate a group of interactive nodes which run on the same kernel with one runtime
+     * call. Each node's result is a view into the shared output, or a local function of it.
+     *
+     * @param group
+     * @param k the group's kernel
+     */
+    static void evaluate_group(const std::vector<Node *> &group, const Kernel k) {
+        const auto in_encoding = group.front()->lhs->encoding;
+
+        size_t total = 0;
+        bool need_gt = false;
+        std::vector<Operand> xs, ys;
+        std::vector<size_t> sizes;
+        for (auto n : group) {
+            total += n->size;
+            sizes.push_back(n->size);
+
+            Operand x{n->lhs->value, std::nullopt};
+            Operand y{n->rhs ? n->rhs->value : nullptr, n->constant};
+            if (k == Kernel::Compare) {
+                need_gt |= compare_gt(n->op);
+                if (compare_swap(n->op)) {
+                    std::swap(x, y);
+                }
+            }
+            xs.push_back(x);
+            ys.push_back(y);
+        }
+
+        auto X = concatenate(xs, sizes, in_encoding, total);
+        auto Y = concatenate(ys, sizes, in_encoding, total);
+
+        // single round (or set of rounds) for the whole group
+        std::unique_ptr<EncodedColumn> Z, Z_eq;
+        switch (k) {
+            case Kernel::Mul:
+                Z = apply(LazyOp::Mul, *X, Y.get(), std::nullopt);
+                break;
+            case Kernel::And:
+                if (std::all_of(group.begin(), group.end(), [](auto n) {
+                        return n->lhs->single_bit || n->rhs->single_bit;
+                    })) {
+                    // AND the concatenated operands in place, one bit per row
+                    static_cast<B *>(X->contents.get())
+                        ->and_low_bits(*static_cast<const B *>(Y->contents.get()), 1);
+                    Z = std::move(X);
+                } else {
+                    Z = apply(LazyOp::And, *X, Y.get(), std::nullopt);
+                }
+                break;
+            case Kernel::Add:
+                Z = apply(LazyOp::Add, *X, Y.get(), std::nullopt);
+                break;
+            case Kernel::Sub:
+                Z = apply(LazyOp::Sub, *X, Y.get(), std::nullopt);
+                break;
+            case Kernel::Compare: {
+                assert(in_encoding == Encoding::BShared);
+                auto x = static_cast<const B *>(X->contents.get());
+                auto y = static_cast<const B *>(Y->contents.get());
+                if (need_gt) {
+                    auto eq = std::make_unique<B>(total);
+                    auto gt = std::make_unique<B>(total);
+                    x->_compare(*y, *eq, *gt);
+                    Z = std::make_unique<Column>(std::move(gt));
+                    Z_eq = std::make_unique<Column>(std::move(eq));
+                } else {
+                    Z_eq = apply(LazyOp::Eq, *X, Y.get(), std::nullopt);
+                }
+                break;
+            }
+            default:
+                std::cerr << "ERROR: unsupported lazy column kernel\n";
+                abort();
+        }
+
+        size_t offset = 0;
+        for (auto n : group) {
+            if (k == Kernel::Compare && !compare_gt(n->op)) {
+                set_view(n, *Z_eq, offset);
+            } else {
+                set_view(n, *Z, offset);
+            }
+
+            if (n->op == LazyOp::Or) {
+                // x | y = x ^ y ^ (x & y)
+                auto r = *(*n->value ^ *n->lhs->value) ^ *n->rhs->value;
+                n->owned = std::move(r);
+                n->value = n->owned.get();
+            } else if (k == Kernel::Compare && compare_negate(n->op)) {
+                n->owned = !*n->value;
+                n->value = n->owned.get();
+            }
+            offset += n->size;
+        }
+    }
+
+    /**
+     * @brief Collect all nodes reachable from `n` in topological (children-first) order.
+     *
+     * @param n
+     * @param visited
+     * @param order
+     */
+    static void collect(Node *n, std::unordered_set<Node *> &visited, std::vector<Node *> &order) {
+        if (!visited.insert(n).second) {
+            return;
+        }
+        if (n->lhs) {
+            collect(n->lhs.get(), visited, order);
+        }
+        if (n->rhs) {
+            collect(n->rhs.get(), visited, order);
+        }
+        order.push_back(n);
+    }
+
+    /**
+     * @brief Release a child's intermediate result once its last consumer has been evaluated.
+     *
+     * @param n
+     */
+    static void release(Node *n) {
+        if (--n->uses == 0) {
+            n->owned.reset();
+            n->value = nullptr;
+        }
+    }
+
+   public:
+    /**
+     * @brief Create a leaf expression referring to an existing column.
+     *
+     * @param column
+     */
+    LazyColumn(const EncodedColumn &column) {
+        node = std::make_shared<Node>();
+        node->op = LazyOp::Leaf;
+        node->encoding = column.encoding;
+        node->size = column.size();
+        node->leaf = &column;
+    }
+
+    /**
+     * @return The number of rows of this expression
+     */
+    size_t size() const { return node->size; }
+
+    /**
+     * @return The encoding of this expression's result
+     */
+    Encoding encoding() const { return node->encoding; }
+
+    /**
+     * @return The number of levels of interactive operations in this expression. Each level is
+     * evaluated with one runtime call per kernel used at that level; a kernel call is a single
+     * round for multiplication and AND, and one comparison or adder circuit otherwise.
+     */
+    int depth() const { return node->level; }
+
+    lazy_binary_op(+, Add);
+    lazy_binary_op(-, Sub);
+    lazy_binary_op(*, Mul);
+    lazy_binary_op(&, And);
+    lazy_binary_op(|, Or);
+    lazy_binary_op(^, Xor);
+    lazy_binary_op(==, Eq);
+    lazy_binary_op(!=, Neq);
+    lazy_binary_op(<, Lt);
+    lazy_binary_op(<=, Lte);
+    lazy_binary_op(>, Gt);
+    lazy_binary_op(>=, Gte);
+
+    LazyColumn operator-() const { return make(LazyOp::Neg, node); }
+    LazyColumn operator~() const { return make(LazyOp::Invert, node); }
+    LazyColumn operator!() const { return make(LazyOp::Not, node); }
+    LazyColumn ltz() const { return make(LazyOp::Ltz, node); }
+
+    /**
+     * @brief Evaluate several expressions together. Shared subexpressions are evaluated once,
+     * and interactive operations at the same depth which run on the same kernel are fused across
+     * all expressions.
+     *
+     * @param roots
+     * @return std::vector<std::unique_ptr<EncodedColumn>> one newly allocated column per root
+     */
+    static std::vector<std::unique_ptr<EncodedColumn>> materialize(
+        const std::vector<LazyColumn> &roots) {
+        std::unordered_set<Node *> visited;
+        std::vector<Node *> order;
+        for (auto &r : roots) {
+            collect(r.node.get(), visited, order);
+        }
+
+        int max_level = 0;
+        for (auto n : order) {
+            n->uses = 0;
+            max_level = std::max(max_level, n->level);
+        }
+        for (auto n : order) {
+            if (n->lhs) {
+                n->lhs->uses++;
+            }
+            if (n->rhs) {
+                n->rhs->uses++;
+            }
+            if (n->op == LazyOp::Leaf) {
+                n->value = n->leaf;
+            }
+        }
+        // roots are kept until the end
+        for (auto &r : roots) {
+            r.node->uses++;
+        }
+
+        auto consume = [](Node *n) {
+            if (n->lhs) {
+                release(n->lhs.get());
+            }
+            if (n->rhs) {
+                release(n->rhs.get());
+            }
+        };
+
+        for (int level = 0; level <= max_level; level++) {
+            // Group interactive nodes at this level by kernel, in a deterministic order so that all
+            // parties issue the same sequence of calls.
+            using Key = std::pair<Kernel, Encoding>;
+            std::vector<std::pair<Key, std::vector<Node *>>> groups;
+            for (auto n : order) {
+                if (n->level != level || n->op == LazyOp::Leaf || kernel(*n) == Kernel::None) {
+                    continue;
+                }
+                Key key{kernel(*n), n->lhs->encoding};
+                auto g = std::find_if(groups.begin(), groups.end(),
+                                      [&](auto &p) { return p.first == key; });
+                if (g == groups.end()) {
+                    groups.push_back({key, {n}});
+                } else {
+                    g->second.push_back(n);
+                }
+            }
+
+            for (auto &[key, group] : groups) {
+                evaluate_group(group, key.first);
+                for (auto n : group) {
+                    consume(n);
+                }
+            }
+
+            // Then evaluate local nodes, which may depend on this level's interactive results.
+            for (auto n : order) {
+                if (n->level != level || n->op == LazyOp::Leaf || kernel(*n) != Kernel::None) {
+                    continue;
+                }
+                n->owned = apply(n->op, *n->lhs->value, n->rhs ? n->rhs->value : nullptr,
+                                 n->constant);
+                n->value = n->owned.get();
+                consume(n);
+            }
+        }
+
+        std::vector<std::unique_ptr<EncodedColumn>> res;
+        for (auto &r : roots) {
+            auto n = r.node.get();
+            auto v = static_cast<const SVector *>(n->value->contents.get());
+
+            // Leaves and fused outputs are references; return contiguous copies instead. Only
+            // move the result out the last time a root appears.
+            if (n->op == LazyOp::Leaf || v->vector.has_mapping() || n->uses > 1) {
+                auto s = static_cast<SVector *>(n->value->contents.get())->deepcopy();
+                res.push_back(std::make_unique<Column>(std::move(s)));
+            } else {
+                res.push_back(std::move(n->owned));
+            }
+            release(n);
+        }
+
+        for (auto n : order) {
+            n->owned.reset();
+            n->value = nullptr;
+        }
+
+        return res;
+    }
+
+    /**
+     * @brief Evaluate this expression.
+     *
+     * @return std::unique_ptr<EncodedColumn> a newly allocated column
+     */
+    std::unique_ptr<EncodedColumn> materialize() const {
+        return std::move(materialize({*this}).front());
+    }
+};
+
+}  // namespace orq::relational
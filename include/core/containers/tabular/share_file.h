@@ -0,0 +1,343 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "backend/common/runtime.h"
+#include "core/containers/encoding.h"
+
+/**
+ * @brief Alignment of the data blocks in a binary share file
+ *
+ */
+#define SHARE_FILE_ALIGNMENT 64
+
+/**
+ * @brief Current version of the binary share file format
+ *
+ */
+#define SHARE_FILE_VERSION 1
+
+namespace orq::relational {
+
+/**
+ * @brief Fixed-size header at the start of a binary share file.
+ *
+ * A binary share file holds one party's shares of a table, column by column:
+ *
+ * - this header;
+ * - `num_columns` column descriptors, each an encoding byte, three reserved bytes, a 32-bit name
+ *   length, and the name itself;
+ * - zero padding up to `data_offset`;
+ * - for each column, for each replication index, one block of `rows` shares of `share_bytes`
+ *   bytes each. Every block starts at a multiple of `SHARE_FILE_ALIGNMENT`, so block (c, r) is at
+ *   `data_offset + (c * replication + r) * block_stride(rows, share_bytes)`.
+ *
+ * All integers are stored in host byte order; files are meant to be staged between jobs on the
+ * same machines, not exchanged across architectures.
+ */
+struct ShareFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t replication;
+    uint32_t share_bytes;
+    uint32_t num_columns;
+    uint64_t rows;
+    uint64_t data_offset;
+    uint8_t reserved[24];
+};
+static_assert(sizeof(ShareFileHeader) == SHARE_FILE_ALIGNMENT);
+
+static constexpr char SHARE_FILE_MAGIC[8] = {'O', 'R', 'Q', 'S', 'H', 'A', 'R', 'E'};
+
+/**
+ * @brief Descriptor of one column in a binary share file.
+ *
+ */
+struct ShareFileColumn {
+    std::string name;
+    Encoding encoding;
+};
+
+/**
+ * @brief Round up to the share file alignment.
+ *
+ * @param bytes
+ * @return size_t
+ */
+static inline size_t share_file_align(size_t bytes) {
+    return (bytes + SHARE_FILE_ALIGNMENT - 1) / SHARE_FILE_ALIGNMENT * SHARE_FILE_ALIGNMENT;
+}
+
+/**
+ * @brief Distance in bytes between consecutive blocks of a share file.
+ *
+ * @param rows
+ * @param share_bytes
+ * @return size_t
+ */
+static inline size_t share_file_block_stride(uint64_t rows, uint32_t share_bytes) {
+    return share_file_align(rows * share_bytes);
+}
+
+/**
+ * @brief Read-only memory mapping of a binary share file.
+ *
+ */
+class ShareFileReader {
+    int fd = -1;
+    void *base = MAP_FAILED;
+    size_t length = 0;
+
+    ShareFileHeader header;
+    std::vector<ShareFileColumn> columns;
+
+    /**
+     * @brief Throw if the file is shorter than `end` bytes.
+     *
+     */
+    void check_bounds(size_t end, const std::string &path) const {
+        if (end > length) {
+            throw std::runtime_error("Truncated share file " + path);
+        }
+    }
+
+    /**
+     * @brief Unmap the file and close its descriptor, if open.
+     *
+     */
+    void release() {
+        if (base != MAP_FAILED) {
+            munmap(base, length);
+            base = MAP_FAILED;
+        }
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+
+    /**
+     * @brief Parse the header and column descriptors of the mapped file.
+     *
+     * @param path for error messages
+     */
+    void parse(const std::string &path) {
+        std::memcpy(&header, base, sizeof(header));
+        if (std::memcmp(header.magic, SHARE_FILE_MAGIC, sizeof(SHARE_FILE_MAGIC)) != 0) {
+            throw std::runtime_error("Not a share file: " + path);
+        }
+        if (header.version != SHARE_FILE_VERSION) {
+            throw std::runtime_error("Unsupported share file version " +
+                                     std::to_string(header.version));
+        }
+
+        // Column descriptors
+        size_t offset = sizeof(ShareFileHeader);
+        for (uint32_t c = 0; c < header.num_columns; c++) {
+            check_bounds(offset + 8, path);
+            auto p = (const uint8_t *)base + offset;
+            Encoding encoding = (Encoding)p[0];
+            uint32_t name_length;
+            std::memcpy(&name_length, p + 4, sizeof(name_length));
+            offset += 8;
+
+            check_bounds(offset + name_length, path);
+            columns.push_back({std::string((const char *)base + offset, name_length), encoding});
+            offset += name_length;
+        }
+
+        // The blocks must follow the descriptors and fit in the file. Sizes are checked by
+        // division, so a corrupt header cannot wrap the end offset around.
+        if (header.data_offset < offset) {
+            throw std::runtime_error("Corrupt share file " + path +
+                                     ": data overlaps the column descriptors");
+        }
+        check_bounds(header.data_offset, path);
+        const size_t available = length - header.data_offset;
+        const uint64_t num_blocks = (uint64_t)header.num_columns * header.replication;
+        if (num_blocks > 0 && header.share_bytes > 0) {
+            if (header.rows > available / num_blocks / header.share_bytes) {
+                throw std::runtime_error("Truncated share file " + path);
+            }
+            check_bounds(header.data_offset +
+                             num_blocks * share_file_block_stride(header.rows, header.share_bytes),
+                         path);
+        }
+    }
+
+   public:
+    /**
+     * @brief Map a share file and parse its header.
+     *
+     * @param path
+     */
+    explicit ShareFileReader(const std::string &path) {
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Unable to open share file " + path + ": " +
+                                     std::strerror(errno));
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Unable to stat share file " + path);
+        }
+        length = st.st_size;
+        if (length < sizeof(ShareFileHeader)) {
+            ::close(fd);
+            throw std::runtime_error("Truncated share file " + path);
+        }
+
+        base = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (base == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Unable to map share file " + path);
+        }
+        // Blocks are read front to back
+        madvise(base, length, MADV_SEQUENTIAL);
+
+        // The destructor does not run if the constructor throws
+        try {
+            parse(path);
+        } catch (...) {
+            release();
+            throw;
+        }
+    }
+
+    ShareFileReader(const ShareFileReader &) = delete;
+    ShareFileReader &operator=(const ShareFileReader &) = delete;
+
+    ~ShareFileReader() { release(); }
+
+    const ShareFileHeader &getHeader() const { return header; }
+
+    const std::vector<ShareFileColumn> &getColumns() const { return columns; }
+
+    /**
+     * @brief Pointer to the shares of column `c` with replication index `r`.
+     *
+     * @param c column index, in file order
+     * @param r replication index
+     * @return const void*
+     */
+    const void *block(size_t c, size_t r) const {
+        return (const uint8_t *)base + header.data_offset +
+               (c * header.replication + r) * share_file_block_stride(header.rows,
+                                                                      header.share_bytes);
+    }
+};
+
+/**
+ * @brief Write a binary share file.
+ *
+ * The header and column descriptors are written with one `writev`. The data blocks are then
+ * written in parallel by the runtime threads, each writing its range of rows of every block with
+ * `pwrite`.
+ *
+ * @param path
+ * @param columns the column descriptors
+ * @param rows number of rows
+ * @param replication replication number
+ * @param share_bytes size of one share
+ * @param blocks pointer to the contiguous shares of each column and replication index, in order
+ * (column-major)
+ */
+static void write_share_file(const std::string &path, const std::vector<ShareFileColumn> &columns,
+                             uint64_t rows, uint32_t replication, uint32_t share_bytes,
+                             const std::vector<const void *> &blocks) {
+    assert(blocks.size() == columns.size() * replication);
+
+    // Header and column descriptors
+    std::vector<uint8_t> descriptors;
+    for (auto &column : columns) {
+        uint8_t encoding[4] = {(uint8_t)column.encoding, 0, 0, 0};
+        uint32_t name_length = column.name.size();
+        descriptors.insert(descriptors.end(), encoding, encoding + 4);
+        descriptors.insert(descriptors.end(), (uint8_t *)&name_length,
+                           (uint8_t *)&name_length + sizeof(name_length));
+        descriptors.insert(descriptors.end(), column.name.begin(), column.name.end());
+    }
+
+    ShareFileHeader header = {};
+    std::memcpy(header.magic, SHARE_FILE_MAGIC, sizeof(SHARE_FILE_MAGIC));
+    header.version = SHARE_FILE_VERSION;
+    header.replication = replication;
+    header.share_bytes = share_bytes;
+    header.num_columns = columns.size();
+    header.rows = rows;
+    header.data_offset = share_file_align(sizeof(header) + descriptors.size());
+
+    const size_t stride = share_file_block_stride(rows, share_bytes);
+    const size_t total = header.data_offset + blocks.size() * stride;
+
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Unable to open share file " + path + ": " +
+                                 std::strerror(errno));
+    }
+
+    // Size the file up front; padding reads back as zeros
+    if (ftruncate(fd, total) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Unable to size share file " + path);
+    }
+
+    struct iovec head[2] = {{&header, sizeof(header)},
+                            {descriptors.data(), descriptors.size()}};
+    ssize_t head_bytes = sizeof(header) + descriptors.size();
+    if (writev(fd, head, 2) != head_bytes) {
+        ::close(fd);
+        throw std::runtime_error("Unable to write share file " + path);
+    }
+
+    // Write all rows of a range of bytes, retrying on partial writes
+    auto pwrite_fully = [](int fd, const uint8_t *src, size_t bytes, off_t offset) {
+        while (bytes > 0) {
+            ssize_t written = pwrite(fd, src, bytes, offset);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            src += written;
+            bytes -= written;
+            offset += written;
+        }
+        return true;
+    };
+
+    std::atomic<bool> ok = true;
+    orq::service::runTime->execute_parallel_unsafe(
+        rows, [&](const size_t start, const size_t end) {
+            for (size_t b = 0; b < blocks.size(); b++) {
+                auto src = (const uint8_t *)blocks[b] + start * share_bytes;
+                off_t offset = header.data_offset + b * stride + start * share_bytes;
+                if (!pwrite_fully(fd, src, (end - start) * share_bytes, offset)) {
+                    ok = false;
+                }
+            }
+        });
+
+    ::close(fd);
+    if (!ok) {
+        throw std::runtime_error("Unable to write share file " + path);
+    }
+}
+
+}  // namespace orq::relational
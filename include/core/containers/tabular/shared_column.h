@@ -7,6 +7,9 @@
 
 namespace orq::relational {
 
+template <typename Share, typename EVector>
+class LazyColumn;
+
 /**
  * A secret-shared column with share and container types.
  *
@@ -28,6 +31,11 @@ class SharedColumn : public EncodedColumn {
    public:
     static const int replicationNumber = EVector::replicationNumber;
 
+    /**
+     * The lazy expression type over columns of this type.
+     */
+    using Lazy = LazyColumn<Share, EVector>;
+
     /**
      * Allocates a shared column with the given encoding and initializes it with zeros.
      * @param _size The column's size in number of elements.
@@ -1,5 +1,16 @@
+#include <cstdint>
+
 namespace orq {
 typedef size_t VectorSizeType;
+
+// Element type of permutations and other (public or secret-shared) row
+// indices. 32-bit indices address up to 2^31 rows per table; build with
+// INDEX_BITS=64 for larger inputs.
+#if defined(INDEX_BITS) && INDEX_BITS == 64
+typedef int64_t IndexType;
+#else
+typedef int32_t IndexType;
+#endif
 }
 
 #ifdef ZEROPC_DUMMY_VECTOR
@@ -10,4 +21,4 @@ typedef size_t VectorSizeType;
 #else
 #include "class_access_vector.h"
 #endif
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace orq::kernels {
+
+/**
+ * @brief Element-wise loops over raw storage, used by `Vector` when every operand is an affine view
+ * (`base + i * stride`) of its storage.
+ *
+ * The contiguous case (all strides 1) and the broadcast case (an input stride of 0) get their own
+ * loops without any index arithmetic, which the compiler vectorizes: with `-march=native`, to
+ * AVX2 or AVX-512 where the host has them. Other strides use a generic strided loop. Operands
+ * that are not affine views fall back to `Vector::operator[]`.
+ *
+ * Outputs may alias inputs element-for-element (e.g., `x ^= y`). The loops do not use `restrict`,
+ * so the compiler checks for other overlaps at runtime.
+ */
+
+/**
+ * @brief `out[i] = f(x[i])`.
+ */
+template <typename In, typename Out, typename F>
+static inline void unary(const In *x, const int64_t sx, Out *out, const int64_t so,
+                         const size_t n, F f) {
+    if (sx == 1 && so == 1) {
+        for (size_t i = 0; i < n; i++) {
+            out[i] = f(x[i]);
+        }
+    } else {
+        for (size_t i = 0; i < n; i++) {
+            out[(int64_t)i * so] = f(x[(int64_t)i * sx]);
+        }
+    }
+}
+
+/**
+ * @brief `out[i] = f(x[i], y[i])`.
+ */
+template <typename T, typename F>
+static inline void binary(const T *x, const int64_t sx, const T *y, const int64_t sy, T *out,
+                          const int64_t so, const size_t n, F f) {
+    if (sx == 1 && sy == 1 && so == 1) {
+        for (size_t i = 0; i < n; i++) {
+            out[i] = f(x[i], y[i]);
+        }
+    } else if (sx == 1 && sy == 0 && so == 1) {
+        const T b = *y;
+        for (size_t i = 0; i < n; i++) {
+            out[i] = f(x[i], b);
+        }
+    } else if (sx == 0 && sy == 1 && so == 1) {
+        const T a = *x;
+        for (size_t i = 0; i < n; i++) {
+            out[i] = f(a, y[i]);
+        }
+    } else {
+        for (size_t i = 0; i < n; i++) {
+            out[(int64_t)i * so] = f(x[(int64_t)i * sx], y[(int64_t)i * sy]);
+        }
+    }
+}
+
+/**
+ * @brief An input of `accumulate` and `aggregate`: element `i` is `base[i * stride]`.
+ */
+template <typename T>
+struct Strided {
+    T *base;
+    int64_t stride;
+};
+
+/**
+ * @brief `out[i] = f(out[i], x[i]...)` over any number of inputs, in a single pass.
+ */
+template <typename T, typename F, typename... In>
+static inline void accumulate(T *out, const int64_t so, const size_t n, F f, const In... x) {
+    if (so == 1 && ((x.stride == 1) && ...)) {
+        for (size_t i = 0; i < n; i++) {
+            out[i] = f(out[i], x.base[i]...);
+        }
+    } else {
+        for (size_t i = 0; i < n; i++) {
+            out[(int64_t)i * so] = f(out[(int64_t)i * so], x.base[(int64_t)i * x.stride]...);
+        }
+    }
+}
+
+/**
+ * @brief Fold `f` over consecutive groups of `group` elements of the inputs:
+ * `out[g] = f(...f(f(out[g], x[j]...), x[j + 1]...)...)` for `j` in group `g`.
+ */
+template <typename T, typename F, typename... In>
+static inline void aggregate(T *out, const int64_t so, const size_t n, const size_t group, F f,
+                             const In... x) {
+    const bool contiguous = ((x.stride == 1) && ...);
+    for (size_t g = 0, j = 0; j < n; g++) {
+        const size_t end = (n - j < group) ? n : j + group;
+        T acc = out[(int64_t)g * so];
+        if (contiguous) {
+            for (; j < end; j++) {
+                acc = f(acc, x.base[j]...);
+            }
+        } else {
+            for (; j < end; j++) {
+                acc = f(acc, x.base[(int64_t)j * x.stride]...);
+            }
+        }
+        out[(int64_t)g * so] = acc;
+    }
+}
+
+/**
+ * @brief `a0 * b0 + a1 * b1 + ...`
+ */
+template <typename T>
+static inline T sum_of_products(const T a, const T b) {
+    return a * b;
+}
+
+template <typename T, typename... R>
+static inline T sum_of_products(const T a, const T b, const R... r) {
+    return a * b + sum_of_products(r...);
+}
+
+/**
+ * @brief `(a0 & b0) ^ (a1 & b1) ^ ...`
+ */
+template <typename T>
+static inline T xor_of_ands(const T a, const T b) {
+    return a & b;
+}
+
+template <typename T, typename... R>
+static inline T xor_of_ands(const T a, const T b, const R... r) {
+    return (a & b) ^ xor_of_ands(r...);
+}
+
+/**
+ * @brief Pack bit `position` of `n` contiguous elements into the bits of `out[0, ceil(n / w))`,
+ * where `w` is the bitwidth of `T`.
+ */
+template <typename T>
+static inline void pack_bits(const T *source, T *out, const size_t n, const int position) {
+    using U = std::make_unsigned_t<T>;
+    constexpr size_t w = sizeof(T) * 8;
+
+    for (size_t i = 0, j = 0; j < n; i++, j += w) {
+        const size_t m = (n - j < w) ? n - j : w;
+        U r = 0;
+        for (size_t p = 0; p < m; p++) {
+            r |= (((U)source[j + p] >> position) & (U)1) << p;
+        }
+        out[i] = r;
+    }
+}
+
+/**
+ * @brief The inverse of `pack_bits`: set bit `position` of `n` contiguous elements of `out` from
+ * the bits of `source[0, ceil(n / w))`.
+ */
+template <typename T>
+static inline void unpack_bits(const T *source, T *out, const size_t n, const int position) {
+    using U = std::make_unsigned_t<T>;
+    constexpr size_t w = sizeof(T) * 8;
+    const U clear = ~((U)1 << position);
+
+    for (size_t i = 0, j = 0; j < n; i++, j += w) {
+        const size_t m = (n - j < w) ? n - j : w;
+        const U r = source[i];
+        for (size_t p = 0; p < m; p++) {
+            out[j + p] = ((U)out[j + p] & clear) | (((r >> p) & (U)1) << position);
+        }
+    }
+}
+
+}  // namespace orq::kernels
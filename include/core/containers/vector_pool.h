@@ -0,0 +1,296 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+// Upper bound on the bytes of storage each thread keeps cached for reuse. The caches are only
+// freed when their thread exits or by `RunTime::trim_memory`, so this bounds what a long-running
+// process holds on to between queries (times the number of worker threads).
+#ifndef VECTOR_POOL_MAX_CACHED_BYTES
+#define VECTOR_POOL_MAX_CACHED_BYTES (size_t{1} << 28)
+#endif
+
+namespace orq::memory {
+
+/**
+ * @brief Usage counters of `Vector` storage, in bytes (except `hits` and `misses`), across all
+ * threads. `current` and `peak` count storage held by live Vectors, at its allocated capacity;
+ * `cached` counts storage held by the pools for reuse.
+ */
+struct PoolStats {
+    size_t current;
+    size_t peak;
+    size_t cached;
+    size_t hits;
+    size_t misses;
+};
+
+namespace detail {
+    inline std::atomic<size_t> current_bytes{0};
+    inline std::atomic<size_t> peak_bytes{0};
+    inline std::atomic<size_t> cached_bytes{0};
+    inline std::atomic<size_t> pool_hits{0};
+    inline std::atomic<size_t> pool_misses{0};
+
+    inline void add_current(const size_t bytes) {
+        const size_t now = current_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        size_t peak = peak_bytes.load(std::memory_order_relaxed);
+        while (now > peak && !peak_bytes.compare_exchange_weak(peak, now,
+                                                               std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * @brief Ask the kernel to back the 2MB-aligned part of a fresh buffer with transparent huge
+     * pages, before it is first touched.
+     */
+    inline void advise_huge_pages([[maybe_unused]] void *ptr, [[maybe_unused]] const size_t bytes) {
+#if defined(USE_HUGE_PAGES) && defined(__linux__) && defined(MADV_HUGEPAGE)
+        constexpr uintptr_t HUGE_PAGE = uintptr_t{1} << 21;
+        const uintptr_t start = ((uintptr_t)ptr + HUGE_PAGE - 1) & ~(HUGE_PAGE - 1);
+        const uintptr_t end = ((uintptr_t)ptr + bytes) & ~(HUGE_PAGE - 1);
+        if (end > start) {
+            madvise((void *)start, end - start, MADV_HUGEPAGE);
+        }
+#endif
+    }
+}  // namespace detail
+
+/**
+ * @brief Allocator that default-initializes elements: growing a vector of trivial elements leaves
+ * the new ones uninitialized instead of zeroing them. Explicit values are still constructed.
+ */
+template <typename T>
+struct DefaultInitAllocator : std::allocator<T> {
+    template <typename U>
+    struct rebind {
+        using other = DefaultInitAllocator<U>;
+    };
+
+    DefaultInitAllocator() = default;
+
+    template <typename U>
+    DefaultInitAllocator(const DefaultInitAllocator<U> &) noexcept {}
+
+    template <typename U>
+    void construct(U *p) noexcept(std::is_nothrow_default_constructible_v<U>) {
+        ::new ((void *)p) U;
+    }
+
+    template <typename U, typename... Args>
+    void construct(U *p, Args &&...args) {
+        ::new ((void *)p) U(std::forward<Args>(args)...);
+    }
+};
+
+/**
+ * @brief Backing storage of a `Vector`.
+ */
+template <typename T>
+using Storage = std::vector<T, DefaultInitAllocator<T>>;
+
+/**
+ * @return the current usage counters
+ */
+inline PoolStats pool_stats() {
+    return {detail::current_bytes.load(), detail::peak_bytes.load(), detail::cached_bytes.load(),
+            detail::pool_hits.load(), detail::pool_misses.load()};
+}
+
+/**
+ * @brief Restart peak tracking from the current usage.
+ */
+inline void reset_peak() { detail::peak_bytes.store(detail::current_bytes.load()); }
+
+/**
+ * @brief Size-class pool of `Vector` backing storage.
+ *
+ * Storage is a `Storage<T>` behind a `shared_ptr` whose deleter returns it to the pool of the
+ * thread that drops the last reference, instead of freeing it. Each thread keeps free lists by
+ * size class (`floor(log2(capacity))`), so the many same-sized temporaries of sorting,
+ * aggregation, and comparison circuits reuse buffers that are already allocated and paged in. A
+ * request for `n` elements takes a cached buffer of capacity at least `n` from the class of `n`,
+ * or any buffer from the next class.
+ *
+ * Buffers below `MIN_POOLED_BYTES` are not cached, since the system allocator handles those well.
+ * Fresh buffers of 2MB or more are advised to use transparent huge pages (with `USE_HUGE_PAGES`).
+ * Caching is enabled with `USE_VECTOR_POOL`; without it, only the usage counters are kept.
+ */
+template <typename T>
+class VectorPool {
+    static constexpr size_t MIN_POOLED_BYTES = size_t{1} << 16;
+    static constexpr size_t MAX_PER_CLASS = 8;
+    static constexpr int NUM_CLASSES = 64;
+
+    // buffers can be reused without constructors or destructors
+    static constexpr bool POOLABLE = std::is_trivially_copyable_v<T> && !std::is_same_v<T, bool>;
+
+    std::array<std::vector<Storage<T>>, NUM_CLASSES> free_lists;
+    size_t cached = 0;
+
+    // set once this thread's pool is destroyed; later releases (e.g., from static Vectors at exit)
+    // free their storage directly
+    static inline thread_local bool destroyed = false;
+
+    VectorPool() = default;
+
+    ~VectorPool() {
+        destroyed = true;
+        detail::cached_bytes.fetch_sub(cached, std::memory_order_relaxed);
+    }
+
+    static VectorPool &local() {
+        static thread_local VectorPool pool;
+        return pool;
+    }
+
+    static size_t bytes_of(const Storage<T> &v) { return v.capacity() * sizeof(T); }
+
+    /**
+     * @brief Take a cached buffer of capacity at least `n`, if any.
+     */
+    bool take(const size_t n, Storage<T> &out) {
+        const int c = std::bit_width(n) - 1;
+        for (int k = c; k <= c + 1 && k < NUM_CLASSES; k++) {
+            auto &list = free_lists[k];
+            for (size_t i = list.size(); i-- > 0;) {
+                if (list[i].capacity() >= n) {
+                    out = std::move(list[i]);
+                    list[i] = std::move(list.back());
+                    list.pop_back();
+                    cached -= bytes_of(out);
+                    detail::cached_bytes.fetch_sub(bytes_of(out), std::memory_order_relaxed);
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Cache a buffer for reuse, unless this thread's cache is full.
+     */
+    void put(Storage<T> &&v) {
+        const size_t bytes = bytes_of(v);
+        auto &list = free_lists[std::bit_width(v.capacity()) - 1];
+        if (list.size() < MAX_PER_CLASS && cached + bytes <= VECTOR_POOL_MAX_CACHED_BYTES) {
+            list.push_back(std::move(v));
+            cached += bytes;
+            detail::cached_bytes.fetch_add(bytes, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Deleter of pooled storage.
+     */
+    struct Release {
+        size_t bytes;
+
+        void operator()(Storage<T> *v) const {
+            detail::current_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+#ifdef USE_VECTOR_POOL
+            if constexpr (POOLABLE) {
+                if (!destroyed && bytes_of(*v) >= MIN_POOLED_BYTES) {
+                    local().put(std::move(*v));
+                }
+            }
+#endif
+            delete v;
+        }
+    };
+
+    static std::shared_ptr<Storage<T>> wrap(Storage<T> &&v) {
+        const size_t bytes = bytes_of(v);
+        detail::add_current(bytes);
+        return std::shared_ptr<Storage<T>>(new Storage<T>(std::move(v)), Release{bytes});
+    }
+
+   public:
+    /**
+     * @brief Storage for `n` elements, all set to `init` if given. Otherwise, the initial values
+     * are unspecified: fresh buffers are not written at all, and reused ones keep stale contents.
+     *
+     * @param n number of elements
+     * @param init initial value of every element
+     * @return std::shared_ptr<Storage<T>>
+     */
+    static std::shared_ptr<Storage<T>> make(const size_t n,
+                                            const std::optional<T> init = std::nullopt) {
+        Storage<T> v;
+        bool reused = false;
+#ifdef USE_VECTOR_POOL
+        if constexpr (POOLABLE) {
+            reused = n * sizeof(T) >= MIN_POOLED_BYTES && !destroyed && local().take(n, v);
+        }
+#endif
+        if (reused) {
+            detail::pool_hits.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            detail::pool_misses.fetch_add(1, std::memory_order_relaxed);
+            v.reserve(n);
+            detail::advise_huge_pages(v.data(), n * sizeof(T));
+        }
+
+        if (init) {
+            v.assign(n, *init);
+        } else {
+            // leaves reused contents in place and fresh elements uninitialized
+            v.resize(n);
+        }
+        return wrap(std::move(v));
+    }
+
+    /**
+     * @brief Take ownership of existing storage, which returns to the pool once released.
+     *
+     * @param v the storage
+     * @return std::shared_ptr<Storage<T>>
+     */
+    static std::shared_ptr<Storage<T>> adopt(Storage<T> &&v) { return wrap(std::move(v)); }
+
+    /**
+     * @brief Free the storage cached by the calling thread.
+     */
+    static void trim() {
+        if (destroyed) {
+            return;
+        }
+        auto &pool = local();
+        for (auto &list : pool.free_lists) {
+            list.clear();
+            list.shrink_to_fit();
+        }
+        detail::cached_bytes.fetch_sub(pool.cached, std::memory_order_relaxed);
+        pool.cached = 0;
+    }
+};
+
+/**
+ * @brief Free the storage cached by the calling thread, for every integer element type.
+ */
+inline void trim_thread() {
+    VectorPool<int8_t>::trim();
+    VectorPool<int16_t>::trim();
+    VectorPool<int32_t>::trim();
+    VectorPool<int64_t>::trim();
+    VectorPool<__int128_t>::trim();
+    VectorPool<uint8_t>::trim();
+    VectorPool<uint16_t>::trim();
+    VectorPool<uint32_t>::trim();
+    VectorPool<uint64_t>::trim();
+    VectorPool<__uint128_t>::trim();
+}
+
+}  // namespace orq::memory
@@ -8,6 +8,7 @@
 #include "common.h"
 #include "core/containers/a_shared_vector.h"
 #include "core/containers/b_shared_vector.h"
+#include "core/containers/packed_b_shared_vector.h"
 #include "debug/orq_debug.h"
 
 using namespace orq::operators;
@@ -145,15 +146,63 @@ using A_ = ASharedVector<Share, EVector>;
 template <typename Share, typename EVector>
 using B_ = BSharedVector<Share, EVector>;
 
+template <typename Share, typename EVector>
+using Packed_ = PackedBSharedVector<Share, EVector>;
+
 /**
  * @brief Denotes the direction of an aggregation.
  *
  */
 enum class Direction { Forward, Reverse } Direction;
 
+/**
+ * @brief Compute the grouping bits of sorted keys for every power-of-two distance.
+ *
+ * Since equal keys are contiguous, rows `j` and `j + 2d` are in the same group iff both pairs
+ * `(j, j + d)` and `(j + d, j + 2d)` are. The equality circuit is therefore only evaluated once,
+ * on adjacent rows, and the bits for larger distances follow from a segmented AND-scan over
+ * them, which costs one packed AND per level.
+ *
+ * @tparam S underlying data type of vectors
+ * @tparam E Share container type.
+ *
+ * @param keys sorted key columns
+ * @param total_size number of rows
+ * @return std::vector<Packed_<S, E>> element `k` holds, for each row `j < total_size - 2^k`,
+ * whether rows `j` and `j + 2^k` belong to the same group.
+ */
+template <typename S, typename E>
+std::vector<Packed_<S, E>> distance_group_bits(std::vector<B_<S, E>>& keys,
+                                               const size_t& total_size) {
+    std::vector<Packed_<S, E>> levels;
+    if (total_size < 2) {
+        return levels;
+    }
+
+    // adjacent rows: combine the per-key equality bits in packed form
+    auto n = total_size - 1;
+    Packed_<S, E> adjacent(*(keys[0].slice(0, n) == keys[0].slice(1)));
+    for (int j = 1; j < keys.size(); ++j) {
+        adjacent &= Packed_<S, E>(*(keys[j].slice(0, n) == keys[j].slice(1)));
+    }
+    levels.push_back(adjacent);
+
+    for (size_t d = 1; 2 * d < total_size; d *= 2) {
+        B_<S, E> prev = levels.back().unpack();
+        n = total_size - 2 * d;
+
+        Packed_<S, E> next(prev.slice(0, n));
+        next &= Packed_<S, E>(prev.slice(d));
+        levels.push_back(next);
+    }
+    return levels;
+}
+
 /**
  * @brief Sorting-network based agregation. Assumes all vectors are the same
- * size.
+ * size, and that the keys are sorted (equal keys are contiguous). The grouping
+ * bits of each level are taken from `distance_group_bits`, so the key equality
+ * circuit runs once rather than once per level.
  *
  * @tparam S underlying data type of vectors
  * @tparam E Share container type.
@@ -251,6 +300,11 @@ void aggregate(
     // computes 1 + floor(log2(x)) ...
     const int log_size = std::bit_width(total_size) - 1;
 
+    std::vector<Packed_<S, E>> segment_bits;
+    if (keys.size() > 0) {
+        segment_bits = distance_group_bits(keys, total_size);
+    }
+
     for (int i = 1; i <= log_size; ++i) {
         size_t d = total_size / (1 << i);
         if (dir == Direction::Reverse) {
@@ -270,23 +324,17 @@ void aggregate(
             group_bits_b = shared_one_b.repeated_subset_reference(group_bits_b.size());
             group_bits_a = shared_one_a.repeated_subset_reference(group_bits_a.size());
         } else {
-            B_<S, E> first_vector = keys[0].slice(0, d_rest);
-            B_<S, E> second_vector = keys[0].slice(d);
-            group_bits_b = first_vector == second_vector;
-
-            // for remaining columns
-            for (int j = 1; j < keys.size(); ++j) {
-                B_<S, E> first_vector = keys[j].slice(0, d_rest);
-                B_<S, E> second_vector = keys[j].slice(d);
-                group_bits_b &= first_vector == second_vector;
-            }
+            // d is a power of two
+            segment_bits[std::countr_zero(d)].unpack_into(group_bits_b);
         }
 
         join_group_bits_b = group_bits_b;
         join_group_bits_a = group_bits_a;
         if (sel_b.has_value() && (a_any_noncopy || b_any_noncopy)) {
             auto s = ~(sel_b->slice(d) ^ sel_b->slice(0, d_rest));
-            group_bits_b &= s;
+            Packed_<S, E> group_bits_p(group_bits_b);
+            group_bits_p &= Packed_<S, E>(*s);
+            group_bits_p.unpack_into(group_bits_b);
         }
 
         group_bits_b.mask(1);
@@ -403,4 +451,51 @@ void tree_prefix_sum(T v, const bool& reverse = false) {
         b = b + a;
     }
 }
+
+/**
+ * @brief Copy each carrier row's values down to the non-carrier rows below it, up to the next
+ * carrier (a segmented "fill-forward" scan). Rows above the first carrier are left unchanged.
+ * Runs in `log(n)` levels, each a multiplex per column.
+ *
+ * @tparam S underlying data type of vectors
+ * @tparam E Share container type.
+ *
+ * @param carrier single-bit column marking the carrier rows
+ * @param b boolean columns to fill
+ * @param a arithmetic columns to fill
+ */
+template <typename S, typename E>
+void fill_forward(const B_<S, E>& carrier, std::vector<B_<S, E>>& b, std::vector<A_<S, E>>& a) {
+    const size_t n = carrier.size();
+
+    // whether a carrier has been seen at or above each row
+    B_<S, E> filled(n);
+    filled = carrier;
+
+    for (size_t d = 1; d < n; d <<= 1) {
+        B_<S, E> keep = filled.slice(d);
+        A_<S, E> keep_a(keep.size());
+        if (!a.empty()) {
+            keep_a = keep.b2a_bit();
+        }
+
+        for (auto& v : b) {
+            B_<S, E> next = multiplex(keep, v.slice(0, n - d), v.slice(d));
+            v.slice(d) = next;
+        }
+        for (auto& v : a) {
+            A_<S, E> next = multiplex(keep_a, v.slice(0, n - d), v.slice(d));
+            v.slice(d) = next;
+        }
+
+        // keep | filled = keep ^ filled ^ (keep & filled); both are single bits, so the AND only
+        // communicates one bit per row
+        B_<S, E> next(n - d);
+        next = keep;
+        next.and_low_bits(filled.slice(0, n - d), 1);
+        next ^= keep;
+        next ^= filled.slice(0, n - d);
+        filled.slice(d) = next;
+    }
+}
 }  // namespace orq::aggregators
@@ -3,6 +3,7 @@
 #include "common.h"
 #include "core/containers/a_shared_vector.h"
 #include "core/containers/b_shared_vector.h"
+#include "core/containers/packed_b_shared_vector.h"
 
 namespace orq::operators {
 /**
@@ -31,15 +32,26 @@ static void distinct(std::vector<BSharedVector<Share, EVector> *> &keys,
 
     BSharedVector<Share, EVector> rest = res->slice(1);
 
+    // Accumulate the (single-bit) inequality results in packed form so that each OR only
+    // communicates one bit per row.
+    typename BSharedVector<Share, EVector>::Packed neq(rest.size());
+
     for (int i = 0; i < keys.size(); ++i) {
         // v[0..n-1]
         BSharedVector<Share, EVector> a = keys[i]->slice(0, keys[i]->size() - 1);
         // v[1..n]
         BSharedVector<Share, EVector> b = keys[i]->slice(1);
 
-        rest |= a != b;
+        typename BSharedVector<Share, EVector>::Packed key_neq(*(a != b));
+        if (i == 0) {
+            neq = key_neq;
+        } else {
+            neq |= key_neq;
+        }
     }
 
+    neq.unpack_into(rest);
+
     // no return; `rest` is a reference into the result vector so
     // automatically updates.
 }
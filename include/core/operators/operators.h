@@ -6,6 +6,7 @@
 #include "distinct.h"
 #include "join.h"
 #include "merge.h"
+#include "prf.h"
 #include "quicksort.h"
 #include "radixsort.h"
 #include "shuffle.h"
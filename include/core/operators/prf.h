@@ -0,0 +1,235 @@
+/**
+ * @file prf.h
+ * @brief A pseudorandom function with a secret-shared key, evaluated over boolean shares
+ *
+ */
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "common.h"
+#include "core/containers/b_shared_vector.h"
+
+namespace orq::operators {
+
+/**
+ * @brief Public parameters of the block cipher behind `reveal_prf`: SIMON128/128, a Feistel
+ * network on two 64-bit words with 68 rounds. The round function is
+ * `(x, y) -> (y ^ (S^1 x & S^8 x) ^ S^2 x ^ k_i, x)`, where `S^j` rotates left, so each round
+ * costs a single 64-bit AND per block. The key schedule is affine, so the round keys are computed
+ * locally on each share of the key.
+ *
+ * SIMON is a standard lightweight cipher (ISO/IEC 29167-21) designed for the full codebook, i.e.
+ * without a limit on the data encrypted under one key.
+ */
+namespace simon {
+
+using block_t = unsigned __int128;
+
+constexpr int BLOCK_BITS = 128;
+constexpr int ROUNDS = 68;
+
+// The key schedule constant `c ^ z_i` is `~3 ^ z_i`, with the `z_2` sequence of SIMON128/128
+// (bit `i` is `z_i`)
+constexpr uint64_t Z2 = 0x3369f885192c0ef5;
+constexpr int Z2_PERIOD = 62;
+
+inline uint64_t rotl(const uint64_t x, const int r) { return (x << r) | (x >> (64 - r)); }
+inline uint64_t rotr(const uint64_t x, const int r) { return (x >> r) | (x << (64 - r)); }
+
+/**
+ * @return the public constant of round key `i + 2`
+ */
+inline uint64_t round_constant(const int i) {
+    return ~uint64_t{3} ^ ((Z2 >> (i % Z2_PERIOD)) & 1);
+}
+
+/**
+ * @brief Round key `i + 2` from round keys `i` and `i + 1`, without the constant. Linear, so it
+ * can be applied to each share.
+ */
+inline uint64_t next_round_key(const uint64_t k0, const uint64_t k1) {
+    const uint64_t t = rotr(k1, 3);
+    return k0 ^ t ^ rotr(t, 1);
+}
+
+/**
+ * @brief The linear part of a round, given the AND output `p = S^1 x & S^8 x`.
+ */
+inline void round_finish(uint64_t &x, uint64_t &y, const uint64_t p, const uint64_t k) {
+    const uint64_t t = x;
+    x = y ^ p ^ rotl(x, 2) ^ k;
+    y = t;
+}
+
+}  // namespace simon
+
+/**
+ * @brief Hash support for the tags returned by `reveal_prf`. The tags are pseudorandom, so their
+ * low half is already a good hash.
+ */
+struct PrfTagHash {
+    size_t operator()(const simon::block_t t) const { return (size_t)t; }
+};
+
+/**
+ * @brief Evaluate a pseudorandom function on each row of `message` under a fresh secret-shared
+ * key, and open the 128-bit outputs to all parties. The key is sampled jointly (every party
+ * contributes a random share) and discarded afterwards, so equal messages within one call get
+ * equal outputs, and the outputs reveal nothing else about the messages.
+ *
+ * The function is a CBC-MAC over the rows' words with SIMON128/128 (see `simon`): every block
+ * costs 68 rounds of communication, each ANDing 64 bits per row. The linear parts of the rounds
+ * and the key schedule are local on each share.
+ *
+ * Security: all rows of a call have the same number of blocks `l`, and CBC-MAC over messages of
+ * a fixed length is a PRF. For `q` distinct rows, the outputs are indistinguishable from
+ * independent random 128-bit strings except with advantage at most the PRP advantage against
+ * SIMON128/128 over `q * l` blocks plus `2 q^2 l^2 / 2^128` (Bellare, Kilian, and Rogaway). For
+ * `q <= 2^32` rows of `l <= 16` blocks, that is below `2^-55` plus the PRP advantage, which also
+ * bounds the probability that two distinct rows get equal outputs.
+ *
+ * @tparam T the share type
+ * @tparam E the share container type
+ * @param message the message words: row `i` of the message is `message[0][i], message[1][i], ...`
+ * @return std::vector<simon::block_t> the 128-bit outputs, one per row
+ */
+template <typename T, typename E>
+std::vector<simon::block_t> reveal_prf(const std::vector<BSharedVector<T, E>> &message) {
+    using B = BSharedVector<T, E>;
+    using U = std::make_unsigned_t<T>;
+    using simon::block_t;
+
+    constexpr int w = sizeof(T) * 8;
+    constexpr int R = E::replicationNumber;
+    // words per block, and per 64-bit half of a block
+    constexpr int W = simon::BLOCK_BITS / w;
+    constexpr int HW = (64 + w - 1) / w;
+
+    const size_t n = message.empty() ? 0 : message[0].size();
+    const int blocks = (message.size() + W - 1) / W;
+    if (n == 0) {
+        return {};
+    }
+
+    auto read_half = [](const Vector<T> &v, const size_t offset, const size_t stride) {
+        uint64_t h = 0;
+        for (int q = 0; q < HW; q++) {
+            h |= (uint64_t)(U)v[offset + q * stride] << (q * w);
+        }
+        return h;
+    };
+
+    // Key: two 64-bit words. Each party contributes a random share, so no party knows it.
+    Vector<T> contribution(2 * HW);
+    orq::service::runTime->populateLocalRandom(contribution);
+    B key(2 * HW);
+    for (int p = 0; p < orq::service::runTime->getNumParties(); p++) {
+        B key_share(2 * HW);
+        secret_share_vec(contribution, key_share, p);
+        key ^= key_share;
+    }
+
+    // The round constants, shared publicly so that they can be added to each share
+    Vector<T> constants((simon::ROUNDS - 2) * HW);
+    for (int i = 0; i < simon::ROUNDS - 2; i++) {
+        for (int q = 0; q < HW; q++) {
+            constants[i * HW + q] = (T)(simon::round_constant(i) >> (q * w));
+        }
+    }
+    B constants_b = orq::service::runTime->public_share<R>(constants);
+
+    std::array<std::array<uint64_t, simon::ROUNDS>, R> round_keys;
+    for (int j = 0; j < R; j++) {
+        auto &k = round_keys[j];
+        k[0] = read_half(key.vector(j), 0, 1);
+        k[1] = read_half(key.vector(j), HW, 1);
+        for (int i = 0; i < simon::ROUNDS - 2; i++) {
+            k[i + 2] = simon::next_round_key(k[i], k[i + 1]) ^
+                       read_half(constants_b.vector(j), i * HW, 1);
+        }
+    }
+
+    // The cipher state `(x, y)` of every row, for each share.
+    std::array<std::vector<uint64_t>, R> state_x;
+    std::array<std::vector<uint64_t>, R> state_y;
+    for (int j = 0; j < R; j++) {
+        state_x[j].assign(n, 0);
+        state_y[j].assign(n, 0);
+    }
+
+    // Inputs of the AND gate of each round, `HW` words per row.
+    B and_u(HW * n);
+    B and_v(HW * n);
+
+    auto write_and_inputs = [&](const int j, const size_t i, const uint64_t x) {
+        const uint64_t u = simon::rotl(x, 1);
+        const uint64_t v = simon::rotl(x, 8);
+        for (int q = 0; q < HW; q++) {
+            and_u.vector(j)[q * n + i] = (T)(u >> (q * w));
+            and_v.vector(j)[q * n + i] = (T)(v >> (q * w));
+        }
+    };
+
+    for (int b = 0; b < blocks; b++) {
+        // Absorb the next block of message words.
+        auto absorb = [&](const size_t start, const size_t end) {
+            for (int j = 0; j < R; j++) {
+                for (size_t i = start; i < end; i++) {
+                    block_t m = 0;
+                    for (int q = 0; q < W && b * W + q < (int)message.size(); q++) {
+                        m |= (block_t)(U)message[b * W + q].vector(j)[i] << (q * w);
+                    }
+                    state_x[j][i] ^= (uint64_t)(m >> 64);
+                    state_y[j][i] ^= (uint64_t)m;
+                    write_and_inputs(j, i, state_x[j][i]);
+                }
+            }
+        };
+        orq::service::runTime->execute_parallel_unsafe(n, absorb);
+
+        for (int r = 0; r < simon::ROUNDS; r++) {
+            B and_p = *(and_u & and_v);
+
+            const bool last = (r == simon::ROUNDS - 1);
+            auto round = [&](const size_t start, const size_t end) {
+                for (int j = 0; j < R; j++) {
+                    for (size_t i = start; i < end; i++) {
+                        const uint64_t p = read_half(and_p.vector(j), i, n);
+                        simon::round_finish(state_x[j][i], state_y[j][i], p, round_keys[j][r]);
+                        if (!last) {
+                            write_and_inputs(j, i, state_x[j][i]);
+                        }
+                    }
+                }
+            };
+            orq::service::runTime->execute_parallel_unsafe(n, round);
+        }
+    }
+
+    // Open the full final state.
+    B tag_words(2 * HW * n);
+    auto output = [&](const size_t start, const size_t end) {
+        for (int j = 0; j < R; j++) {
+            for (size_t i = start; i < end; i++) {
+                for (int q = 0; q < HW; q++) {
+                    tag_words.vector(j)[q * n + i] = (T)(state_x[j][i] >> (q * w));
+                    tag_words.vector(j)[(HW + q) * n + i] = (T)(state_y[j][i] >> (q * w));
+                }
+            }
+        }
+    };
+    orq::service::runTime->execute_parallel_unsafe(n, output);
+    auto opened = tag_words.open();
+
+    std::vector<block_t> tags(n);
+    for (size_t i = 0; i < n; i++) {
+        tags[i] = ((block_t)read_half(opened, i, n) << 64) | read_half(opened, HW * n + i, n);
+    }
+    return tags;
+}
+
+}  // namespace orq::operators
@@ -224,7 +224,7 @@ static ElementwisePermutation<EVector> quicksort(BSharedVector<Share, EVector> &
     }
     // 1 pair for invert (calls obliv_apply_elementwise_perm)
     int num_pairs = 1;
-    orq::random::PermutationManager::get()->reserve(v.size(), num_permutations, num_pairs);
+    orq::random::PermutationManager::get()->prefetch(v.size(), num_permutations, num_pairs);
 
     auto reversed = order == SortOrder::DESC;
 
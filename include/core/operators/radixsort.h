@@ -1,101 +1,284 @@
 #pragma once
 
+#include <unistd.h>
+
 #include "common.h"
 #include "core/random/permutations/permutation_manager.h"
 
 namespace orq::operators {
 
 template <typename E>
-using ASharedPerm = ASharedVector<int, orq::EVector<int, E::replicationNumber>>;
+using ASharedPerm = ASharedVector<IndexType, orq::EVector<IndexType, E::replicationNumber>>;
 template <typename E>
-using BSharedPerm = BSharedVector<int, orq::EVector<int, E::replicationNumber>>;
+using BSharedPerm = BSharedVector<IndexType, orq::EVector<IndexType, E::replicationNumber>>;
+
+// Widest digit (bits per pass) the radix sorts will use. The one-hot digit
+// indicators take 2^d times the space of the input, so this must stay small.
+#define RADIX_MAX_DIGIT_BITS 4
+
+// Estimated cost of one communication round, in units of the communication of
+// one n-element multiplication, scaled by n (i.e. a round "costs" as much as
+// multiplying this many elements).
+#define RADIX_ROUND_COST (1 << 14)
+
+// Fraction (1 / this) of the physical memory the scratch space of one radix sort
+// may take. Wider digits are skipped if their scratch space would exceed it.
+#define RADIX_SCRATCH_MEMORY_DIVISOR 4
+
+/**
+ * @brief Size of the `RadixDigitScratch` for a sort of `n` elements with d-bit digits.
+ *
+ * The shifted input takes one n-element slice, the digit bits `d`, and the indicators and
+ * destinations `2^d` each, so the scratch space grows as `n << d`.
+ *
+ * @param n Number of elements being sorted.
+ * @param d Digit width.
+ * @return The size in bytes of the local shares.
+ */
+static size_t radix_scratch_bytes(const size_t n, const int d) {
+    const size_t elements = n * (1 + d + 2 * ((size_t)1 << d));
+    return elements * sizeof(IndexType) * orq::service::runTime->getReplicationNumber();
+}
+
+/**
+ * @brief Memory budget for the scratch space of one radix sort.
+ *
+ * @return `1 / RADIX_SCRATCH_MEMORY_DIVISOR` of the physical memory, or no limit if it is unknown.
+ */
+static size_t radix_scratch_budget() {
+    const long pages = sysconf(_SC_PHYS_PAGES);
+    const long page_size = sysconf(_SC_PAGE_SIZE);
+    if (pages <= 0 || page_size <= 0) {
+        return std::numeric_limits<size_t>::max();
+    }
+    return (size_t)pages * page_size / RADIX_SCRATCH_MEMORY_DIVISOR;
+}
+
+/**
+ * @brief Choose the digit width for the radix sorts below.
+ *
+ * A pass over a d-bit digit costs, in units of one n-element multiplication,
+ * - `d` bit conversions (b2a), batched into one call;
+ * - `2^d - 2` multiplications for the one-hot digit indicators, in `d - 1` rounds;
+ * - `2^d - 1` multiplications to select each element's destination, in one round;
+ * - `perm_ops` permutation applications (shuffles), which dominate for small d.
+ *
+ * Wider digits cut the number of passes, and so permutation applications, by d×, but the
+ * indicator cost grows exponentially. Round latency favors wider digits for small `n`.
+ *
+ * The scratch space grows as `n << d` (see `radix_scratch_bytes`), so digits whose scratch space
+ * would exceed `radix_scratch_budget()` are not considered; one-bit digits always are.
+ *
+ * @param n Number of elements being sorted.
+ * @param bits Number of bits to sort on.
+ * @param perm_ops Permutation applications per pass.
+ * @return The digit width, between 1 and `RADIX_MAX_DIGIT_BITS`.
+ */
+static int radix_digit_bits(const size_t n, const int bits, const int perm_ops) {
+    // Sharded permutations are applied once per party (2PC: one permutation
+    // correlation), and shuffle both the data and the destination vector.
+    const int parties = std::max(2, orq::service::runTime->getNumParties());
+    const double perm_comm = 4.0 * parties;
+    const double perm_rounds = parties + 1;
+    const double b2a_comm = 2;
+    const double b2a_rounds = 2;
+    const double round_cost = (double)RADIX_ROUND_COST / std::max<size_t>(n, 1);
+
+    const size_t budget = radix_scratch_budget();
+
+    int best = 1;
+    double best_cost = std::numeric_limits<double>::max();
+    for (int d = 1; d <= std::min(bits, RADIX_MAX_DIGIT_BITS); d++) {
+        if (d > 1 && radix_scratch_bytes(n, d) > budget) {
+            break;
+        }
+        const double comm =
+            d * b2a_comm + ((1 << d) - 2) + ((1 << d) - 1) + perm_ops * perm_comm;
+        const double rounds = b2a_rounds + (d - 1) + 1 + perm_ops * perm_rounds;
+        const double cost = div_ceil(bits, d) * (comm + rounds * round_cost);
+        if (cost < best_cost) {
+            best = d;
+            best_cost = cost;
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Number of passes (permutation applications) the radix sorts below make.
+ *
+ * @param n Number of elements being sorted.
+ * @param bits Number of bits to sort on.
+ * @param perm_ops Permutation applications per pass.
+ * @return The number of passes.
+ */
+static int radix_num_passes(const size_t n, const int bits, const int perm_ops) {
+    return div_ceil(bits, radix_digit_bits(n, bits, perm_ops));
+}
+
+/**
+ * @brief Intermediate storage for `gen_digit_perm`, preallocated once per sort for the widest
+ * digit and reused by every pass.
+ *
+ * @tparam S Share data type.
+ * @tparam E Share container type.
+ */
+template <typename S, typename E>
+struct RadixDigitScratch {
+    // one shifted copy of the input
+    BSharedVector<S, E> v_shift;
+    // the digit bits, one per n-element slice
+    BSharedPerm<E> vprime;
+    // the one-hot digit indicators, one per n-element slice
+    ASharedPerm<E> f;
+    // the destination of each element under each digit value
+    ASharedPerm<E> s;
+    ASharedPerm<E> one;
+
+    RadixDigitScratch(const size_t n, const int d)
+        : v_shift(n),
+          vprime(d * n),
+          f(n << d),
+          s(n << d),
+          one(orq::service::runTime->public_share<E::replicationNumber>(
+              orq::Vector<IndexType>({1}).repeated_subset_reference(n))) {}
+};
+
+/**
+ * @brief Generate the stable sorting permutation over one digit of `v`.
+ *
+ * Generalizes the AHI+22 bit permutation to w-bit digits: convert the digit bits, expand them
+ * into one-hot indicators \f$f_k\f$ for each digit value \f$k\f$, and prefix sum the
+ * concatenation \f$f_0 \| \dots \| f_{2^w - 1}\f$ to obtain the destination of each element
+ * under each digit value. The permutation selects the destination of the actual digit.
+ *
+ * @tparam S Share data type.
+ * @tparam E Share container type.
+ * @param v Vector to sort.
+ * @param t Preallocated temporaries, for digits at least `w` bits wide.
+ * @param shift Position of the least significant bit of the digit.
+ * @param w Width of the digit.
+ * @param sign_bit Position of the sign bit within the digit, which is inverted, or -1 if none.
+ * @return The digit permutation. It refers to the storage in `t`, so it must be used before the
+ * next call.
+ */
+template <typename S, typename E>
+static ElementwisePermutation<E> gen_digit_perm(BSharedVector<S, E> &v,
+                                                RadixDigitScratch<S, E> &t, const int shift,
+                                                const int w, const int sign_bit) {
+    const size_t n = v.size();
+    const size_t m = n << w;
+    const int digits = 1 << w;
+
+    // Place bit j of the digit in the LSB of slice j, so that all bits are
+    // converted together.
+    for (int j = 0; j < w; j++) {
+        // shift needs to happen over the (possibly larger) data type.
+        t.v_shift.bit_arithmetic_right_shift(v, shift + j);
+
+        if (j == sign_bit) {
+            // sorting the MSB. flip the sign bit.
+            t.v_shift.inplace_invert();
+        }
+
+        // internally call copy-cast operator (data type might not be int)
+        t.vprime.slice(j * n, (j + 1) * n) = t.v_shift;
+    }
+
+    ASharedPerm<E> b = t.vprime.slice(0, w * n).b2a_bit();
+
+    auto f = t.f.slice(0, m);
+    auto s = t.s.slice(0, m);
+
+    // Expand the bits into one-hot indicators, one bit at a time. After bit j,
+    // the first 2^(j+1) slices of f hold the indicators of the j+1 low bits:
+    //   f_{k + 2^j} = f_k * b_j
+    //   f_k         = f_k * (1 - b_j) = f_k - f_{k + 2^j}
+    // Each step is one multiplication over all previous indicators.
+    auto b0 = b.slice(0, n);
+    f.slice(0, n) = t.one;
+    f.slice(0, n) -= b0;
+    f.slice(n, 2 * n) = b0;
+
+    for (int j = 1; j < w; j++) {
+        const size_t h = n << j;
+        auto lo = f.slice(0, h);
+        auto hi = f.slice(h, 2 * h);
+        hi = lo;
+        hi *= b.slice(j * n, (j + 1) * n).cyclic_subset_reference(1 << j);
+        lo -= hi;
+    }
+
+    // We want to compute `s.prefix_sum - 1`
+    // But instead can just decrement the first element, and then prefix
+    // sum; this propagates the -1 to the entire vector without another pass
+    s = f;
+    s.slice(0, 1) -= 1;
+    s.prefix_sum();
+
+    // Select the destination for each element's digit value:
+    //   perm = sum_k f_k * s_k
+    // As in the single-bit case, save one slice of multiplications using the
+    // fact that f_0 = 1 - sum_{k > 0} f_k:
+    //   perm = s_0 + sum_{k > 0} f_k * (s_k - s_0)
+    auto s0 = s.slice(0, n);
+    auto s_rest = s.slice(n, m);
+    auto f_rest = f.slice(n, m);
+    s_rest -= s0.cyclic_subset_reference(digits - 1);
+    f_rest *= s_rest;
+    for (int k = 1; k < digits; k++) {
+        s0 += f_rest.slice((k - 1) * n, k * n);
+    }
+
+    // s0 is the digit perm now.
+    return ElementwisePermutation<E>(s0);
+}
 
 /**
- * @brief Direct implementation of the AHI+22 radix sort algorithm.
+ * @brief Implementation of the AHI+22 radix sort algorithm, generalized to multi-bit digits.
+ *
+ * With one-bit digits, this is exactly AHI+22.
  *
  * @tparam S Share data type.
  * @tparam E Share container type.
  * @param v Vector to sort.
  * @param bits Number of bits to sort on.
  * @param full_width Whether sorting on full bitwidth (affects sign bit handling).
+ * @param digit_bits Bits per pass, at most `RADIX_MAX_DIGIT_BITS`. If 0, chosen by
+ * `radix_digit_bits`.
  * @return Permutation representing the sort order.
  */
 template <typename S, typename E>
 static ElementwisePermutation<E> radix_sort_ccs(BSharedVector<S, E> &v, const int bits,
-                                                const bool full_width = true) {
+                                                const bool full_width = true,
+                                                const int digit_bits = 0) {
     const size_t n = v.size();
 
-    // need 2 extra permutations for padding/inversion
-    orq::random::PermutationManager::get()->reserve(n, bits + 2);
+    assert(digit_bits >= 0 && digit_bits <= RADIX_MAX_DIGIT_BITS);
 
-    // Reserve temporaries for gen_bit_perm
-    BSharedVector<S, E> v_shift(n);
-    BSharedPerm<E> vprime(n);
-    ASharedPerm<E> s(2 * n);
-    ASharedPerm<E> one = orq::service::runTime->public_share<E::replicationNumber>(
-        orq::Vector<int>({1}).repeated_subset_reference(n));
+    // each pass applies one permutation and composes it with the total
+    const int d = digit_bits ? digit_bits : radix_digit_bits(n, bits, 2);
 
-    // Create views of each half of s
-    auto s0 = s.slice(0, n);
-    auto s1 = s.slice(n);
+    // need 2 extra permutations for padding/inversion
+    orq::random::PermutationManager::get()->prefetch(n, div_ceil(bits, d) + 2);
+
+    // Reserve temporaries for gen_digit_perm
+    RadixDigitScratch<S, E> t(n, d);
 
     // create the global permutation
     ElementwisePermutation<E> total_perm(v.size());
 
-    for (int i = 0; i < bits; i++) {
-        // Generate a permutation over the ith bit of v.
-        // This was originally a function call, but we need to reuse lots of
-        // intermediate storage; best to preallocate outside the loop.
-
-        // shift needs to happen over the (possibly larger) data type.
-        v_shift.bit_arithmetic_right_shift(v, i);
-
-        if (full_width && i == bits - 1) {
-            // sorting the MSB. flip the sign bit.
-            v_shift.inplace_invert();
-        }
+    for (int i = 0; i < bits; i += d) {
+        const int w = std::min(d, bits - i);
+        const int sign_bit = (full_width && i + w == bits) ? w - 1 : -1;
 
-        // internally call copy-cast operator (data type might not be int)
-        vprime = v_shift;
-
-        ASharedPerm<E> f1 = vprime.b2a_bit();
-
-        // Compute f0 := 1 - f1. (However, just reuse s0 storage.)
-        s0 = one;
-        s0 -= f1;
-
-        // Copy f1 into s1, so we can prefix sum but keep original
-        s1 = f1;
-
-        // We want to compute `s.prefix_sum - 1`
-        // But instead can just decrement the first element, and then prefix
-        // sum; this propagates the -1 to the entire vector without another pass
-        s.slice(0, 1) -= 1;
-        s.prefix_sum();
-
-        // We want to use f0 and f1 to select the correct values from s0 and s1.
-        // - f0 is an indicator vector where f0[i] = 1 if x[i] = 0
-        // - f1 is an indicator vector where f1[i] = 1 if x[i] = 1
-        // - s0 has the destinations of all 0 values in x (first half of s)
-        // - s1 has the destinations of all 1 values in x (second half of s)
-        // This is equivalent to:
-        //   s0 = (f0 * s0) + (f1 * s1)
-        // We can do it with fewer multiplications using the fact that
-        // f0 = 1 - f1:
-        //   perm = (s0 + f1 * (s1 - s0));
-        // (effectively multiplex)
-        s1 -= s0;
-        f1 *= s1;
-        s0 += f1;
-
-        // s0 is the bit perm now.
-        ElementwisePermutation<E> bit_perm(s0);
+        ElementwisePermutation<E> digit_perm = gen_digit_perm(v, t, i, w, sign_bit);
 
         // apply it to v
-        oblivious_apply_elementwise_perm(v, bit_perm);
+        oblivious_apply_elementwise_perm(v, digit_perm);
 
         // compose the permutations
-        total_perm = compose_permutations(total_perm, bit_perm);
+        total_perm = compose_permutations(total_perm, digit_perm);
     }
 
     return total_perm;
@@ -105,96 +288,57 @@ static ElementwisePermutation<E> radix_sort_ccs(BSharedVector<S, E> &v, const in
 /**
  * @brief The radix sort protocol.
  *
- * Implements the radix sort protocol for a given number of bits.
+ * Implements the radix sort protocol for a given number of bits, sorting one digit of
+ * `radix_digit_bits` bits per pass. Each digit permutation is applied to both `v` and the index
+ * column `idx`, which is never sorted on; since every pass is stable, `idx` ends up holding the
+ * original position of each sorted element.
  *
  * @tparam S Share data type.
  * @tparam E Share container type.
  * @param v Vector to sort.
+ * @param idx Index column, permuted alongside `v`.
  * @param bits Number of bits to sort on.
  * @param full_width Whether sorting on full bitwidth (affects sign bit handling).
  */
 template <typename S, typename E>
-static void radix_sort_body(BSharedVector<S, E> &v, const int bits, const bool full_width = true) {
+static void radix_sort_body(BSharedVector<S, E> &v, BSharedPerm<E> &idx, const int bits,
+                            const bool full_width = true) {
     const size_t n = v.size();
 
-    // need 1 permutation for padding
+    const int d = radix_digit_bits(n, bits, 1);
+    const int passes = div_ceil(bits, d);
+
+    // need 1 permutation to convert the index column
     int num_permutations = 1;
+    // 1 pair per call to oblivious_apply_elementwise_perm + 1 pair for invert
+    int num_pairs = passes + 1;
     if (runTime->getNumParties() == 2) {
-        // 2PC doesn't need one for remove_padding, uses direct b2a conversion
+        // 2PC uses direct b2a conversion, but needs a pair per permuted vector
         num_permutations -= 1;
+        num_pairs += passes;
     }
-    // 1 pair per call to oblivious_apply_elementwise_perm + 1 pair for invert
-    int num_pairs = bits + 1;
-    orq::random::PermutationManager::get()->reserve(n, num_permutations, num_pairs);
-
-    // Reserve temporaries for gen_bit_perm
-    BSharedVector<S, E> v_shift(n);
-    BSharedPerm<E> vprime(n);
-    ASharedPerm<E> s(2 * n);
-    ASharedPerm<E> one = orq::service::runTime->public_share<E::replicationNumber>(
-        orq::Vector<int>({1}).repeated_subset_reference(n));
+    orq::random::PermutationManager::get()->prefetch(n, num_permutations, num_pairs);
 
-    // Create views of each half of s
-    auto s0 = s.slice(0, n);
-    auto s1 = s.slice(n);
+    // Reserve temporaries for gen_digit_perm
+    RadixDigitScratch<S, E> t(n, d);
 
-    for (int i = 0; i < bits; i++) {
-        // Generate a permutation over the ith bit of v.
-        // This was originally a function call, but we need to reuse lots of
-        // intermediate storage; best to preallocate outside the loop.
+    for (int i = 0; i < bits; i += d) {
+        const int w = std::min(d, bits - i);
+        const int sign_bit = (full_width && i + w == bits) ? w - 1 : -1;
 
-        // shift needs to happen over the (possibly larger) data type.
-        v_shift.bit_arithmetic_right_shift(v, 32 + i);
-
-        if (full_width && i == bits - 1) {
-            // sorting the MSB. flip the sign bit.
-            v_shift.inplace_invert();
-        }
-
-        // internally call copy-cast operator (data type might not be int)
-        vprime = v_shift;
-
-        ASharedPerm<E> f1 = vprime.b2a_bit();
-
-        // Compute f0 := 1 - f1. (However, just reuse s0 storage.)
-        s0 = one;
-        s0 -= f1;
-
-        // Copy f1 into s1, so we can prefix sum but keep original
-        s1 = f1;
-
-        // We want to compute `s.prefix_sum - 1`
-        // But instead can just decrement the first element, and then prefix
-        // sum; this propagates the -1 to the entire vector without another pass
-        s.slice(0, 1) -= 1;
-        s.prefix_sum();
-
-        // We want to use f0 and f1 to select the correct values from s0 and s1.
-        // - f0 is an indicator vector where f0[i] = 1 if x[i] = 0
-        // - f1 is an indicator vector where f1[i] = 1 if x[i] = 1
-        // - s0 has the destinations of all 0 values in x (first half of s)
-        // - s1 has the destinations of all 1 values in x (second half of s)
-        // This is equivalent to:
-        //   s0 = (f0 * s0) + (f1 * s1)
-        // We can do it with fewer multiplications using the fact that
-        // f0 = 1 - f1:
-        //   perm = (s0 + f1 * (s1 - s0));
-        // (effectively multiplex)
-        s1 -= s0;
-        f1 *= s1;
-        s0 += f1;
-
-        // s0 is the bit perm now.
-        ElementwisePermutation<E> perm(s0);
+        ElementwisePermutation<E> perm = gen_digit_perm(v, t, i, w, sign_bit);
 
-        // apply it to v
-        oblivious_apply_elementwise_perm(v, perm);
+        // apply it to v and the index column
+        oblivious_apply_elementwise_perm(v, idx, perm);
     }
 }
 
 /**
  * @brief The radix sort protocol entry point.
  *
+ * Rather than padding the input with its index (which would widen 64-bit keys to 128 bits), the
+ * index travels in a separate `IndexType` column.
+ *
  * @tparam S Share data type.
  * @tparam E Share container type.
  * @param v Vector to sort.
@@ -205,24 +349,45 @@ static void radix_sort_body(BSharedVector<S, E> &v, const int bits, const bool f
 template <typename S, typename E>
 static ElementwisePermutation<E> radix_sort(BSharedVector<S, E> &v, SortOrder order,
                                             const size_t bits) {
+    const size_t n = v.size();
     auto reversed = order == SortOrder::DESC;
 
     // Are we sorting on the full width?
     // If so, sign bit will need to be sorted backwards.
     const bool full_width = (sizeof(S) * 8 == bits);
 
-    // pad the input
-    PaddedBSharedVector<E> padded = pad_input(v, reversed);
+    // Index column: 0 to n-1, or -1 to -n if reversed (as in `pad_input`)
+    if (n > (size_t)std::numeric_limits<IndexType>::max()) {
+        throw std::runtime_error("radix_sort: the index column supports at most " +
+                                 std::to_string(std::numeric_limits<IndexType>::max()) + " rows");
+    }
+    orq::Vector<IndexType> positions(n);
+    for (size_t i = 0; i < n; i++) {
+        positions[i] = reversed ? (-1 - (IndexType)i) : (IndexType)i;
+    }
+    BSharedPerm<E> idx = orq::service::runTime->public_share<E::replicationNumber>(positions);
+
+    if (reversed) {
+        v.reverse();
+        idx.reverse();
+    }
+
+    radix_sort_body(v, idx, bits, full_width);
+
+    if (reversed) {
+        v.reverse();
+        idx.reverse();
+    }
 
-    radix_sort_body(padded, bits, full_width);
+    // the index column holds the secret-shared applied permutation
+    ElementwisePermutation<E> permutation(n, Encoding::BShared);
+    permutation = idx;
+    permutation.b2a();
 
     if (reversed) {
-        padded.reverse();
+        permutation.negate();
     }
 
-    // unpad the result to obtain the original sorted list and the
-    // secret-shared applied permutation
-    ElementwisePermutation<E> permutation = remove_padding(v, padded, reversed);
     permutation.invert();
 
     return permutation;
@@ -10,8 +10,6 @@ using namespace orq::benchmarking;
 
 using namespace orq::random;
 
-#define random_buffer_size 65536
-
 namespace orq::operators {
 
 #if defined(MPC_PROTOCOL_PLAINTEXT_ONE) || defined(MPC_PROTOCOL_DUMMY_ZERO)
@@ -19,9 +17,11 @@ namespace orq::operators {
 #endif
 
 template <typename E>
-using AElementwisePermutation = ASharedVector<int, orq::EVector<int, E::replicationNumber>>;
+using AElementwisePermutation =
+    ASharedVector<IndexType, orq::EVector<IndexType, E::replicationNumber>>;
 template <typename E>
-using BElementwisePermutation = BSharedVector<int, orq::EVector<int, E::replicationNumber>>;
+using BElementwisePermutation =
+    BSharedVector<IndexType, orq::EVector<IndexType, E::replicationNumber>>;
 
 #ifdef INSTRUMENT_APPLYPERM
 /**
@@ -59,43 +59,9 @@ void count_oblivious_apply_perm(uint64_t size) {
  * @param generator The common PRG object used as the pseudorandomness source.
  * @return The permutation as a vector of destination indices.
  */
-std::vector<int> gen_perm(size_t size, std::shared_ptr<random::CommonPRG> generator) {
-    std::vector<int> permutation(size);
-    for (size_t i = 0; i < size; i++) {
-        permutation[i] = i;
-    }
-
-    // we don't know a priori how many random elements we will need,
-    //  so we don't want to overshoot by too much
-    // however, we also get speed benefits from generating randomness in batches
-    orq::Vector<uint32_t> random(random_buffer_size);
-    generator->getNext(random);
-
-    int bits = std::bit_width(size);
-    int mask = (1 << bits) - 1;
-
-    int rand_index = 0;
-    for (size_t i = 0; i < size; i++) {
-        // get the location to put the ith element
-        // generate random int in range [0, n-i-1]
-        uint32_t rand = size;
-        while (rand > size - i - 1) {
-            rand = random[rand_index] & mask;
-            rand_index++;
-            if (rand_index == random_buffer_size) {
-                // generate new randomness and reset the index
-                generator->getNext(random);
-                rand_index = 0;
-            }
-        }
-        int location = i + rand;
-
-        // swap
-        int temp = permutation[i];
-        permutation[i] = permutation[location];
-        permutation[location] = temp;
-    }
-
+LocalPermutation gen_perm(size_t size, std::shared_ptr<random::CommonPRG> generator) {
+    LocalPermutation permutation(size);
+    random::gen_perm(permutation, generator);
     return permutation;
 }
 
@@ -140,7 +106,7 @@ void local_apply_perm(Vector<T> &x, const LocalPermutation &permutation) {
  * @param permutation The permutation to apply as ORQ Vector.
  */
 template <typename T>
-void local_apply_perm(Vector<T> &x, Vector<int> &permutation) {
+void local_apply_perm(Vector<T> &x, Vector<IndexType> &permutation) {
     local_apply_perm(x, permutation.as_std_vector());
 }
 
@@ -176,7 +142,7 @@ void local_apply_perm_single_threaded(Vector<T> &x, const LocalPermutation &perm
  * @param permutation The permutation to apply.
  */
 template <typename T>
-void local_apply_perm_single_threaded(Vector<T> &x, Vector<int> &permutation) {
+void local_apply_perm_single_threaded(Vector<T> &x, Vector<IndexType> &permutation) {
     local_apply_perm_single_threaded(x, permutation.as_std_vector());
 }
 
@@ -195,7 +161,7 @@ void local_apply_perm(EVector<T, R> &x, P &permutation) {
         if constexpr (std::is_same_v<P, LocalPermutation>) {
             return permutation;
         } else {
-            // Vector<int>
+            // Vector<IndexType>
             return permutation.as_std_vector();
         }
     }();
@@ -213,13 +179,13 @@ void local_apply_perm(EVector<T, R> &x, P &permutation) {
  * @param permutation The permutation to apply.
  */
 template <typename EVector>
-void local_apply_perm(ElementwisePermutation<EVector> &x, Vector<int> &permutation) {
+void local_apply_perm(ElementwisePermutation<EVector> &x, Vector<IndexType> &permutation) {
     local_apply_perm(x.sharedVector, permutation);
 }
 
 /**
  * Overload for permutation a SharedVector. Permutation type P can be
- * a LocalPermutation or Vector<int>.
+ * a LocalPermutation or Vector<IndexType>.
  *
  * @tparam S Share data type.
  * @tparam E Share container type.
@@ -247,7 +213,7 @@ void local_apply_perm(SharedVector<S, E> &x, P &permutation) {
  * @param x The vector to permute.
  * @param permutation The permutation whose inverse to apply.
  */
-template <typename T, typename S = int>
+template <typename T, typename S = IndexType>
 void local_apply_inverse_perm(Vector<T> &x, const std::vector<S> &permutation) {
     static auto new_x = std::make_unique<Vector<T>>(x.size());
     new_x->resize(x.size());
@@ -277,7 +243,7 @@ void local_apply_inverse_perm(Vector<T> &x, const std::vector<S> &permutation) {
  * @param x The vector to permute.
  * @param permutation The permutation whose inverse to apply.
  */
-template <typename T, typename S = int>
+template <typename T, typename S = IndexType>
 void local_apply_inverse_perm(Vector<T> &x, const Vector<S> &permutation) {
     local_apply_inverse_perm(x, permutation.as_std_vector());
 }
@@ -291,7 +257,7 @@ void local_apply_inverse_perm(Vector<T> &x, const Vector<S> &permutation) {
  * @param x The vector to permute.
  * @param permutation The permutation whose inverse to apply.
  */
-template <typename T, int R, typename S = int>
+template <typename T, int R, typename S = IndexType>
 void local_apply_inverse_perm(EVector<T, R> &x, const std::vector<S> &permutation) {
     for (int r = 0; r < R; r++) {
         local_apply_inverse_perm(x(r), permutation);
@@ -307,7 +273,7 @@ void local_apply_inverse_perm(EVector<T, R> &x, const std::vector<S> &permutatio
  * @param x The vector to permute.
  * @param permutation The permutation whose inverse to apply.
  */
-template <typename Share, typename EVector, typename S = int>
+template <typename Share, typename EVector, typename S = IndexType>
 void local_apply_inverse_perm(SharedVector<Share, EVector> &x, const std::vector<S> &permutation) {
     local_apply_inverse_perm(x.vector, permutation);
 }
@@ -321,7 +287,7 @@ void local_apply_inverse_perm(SharedVector<Share, EVector> &x, const std::vector
  * @param permutation The permutation whose inverse to apply.
  */
 template <typename Share, typename EVector>
-void local_apply_inverse_perm(SharedVector<Share, EVector> &x, Vector<int> &permutation) {
+void local_apply_inverse_perm(SharedVector<Share, EVector> &x, Vector<IndexType> &permutation) {
     local_apply_inverse_perm(x, permutation.as_std_vector());
 }
 
@@ -334,7 +300,7 @@ void local_apply_inverse_perm(SharedVector<Share, EVector> &x, Vector<int> &perm
  * @param permutation The permutation whose inverse to apply.
  */
 template <typename EVector>
-void local_apply_inverse_perm(ElementwisePermutation<EVector> &x, Vector<int> &permutation) {
+void local_apply_inverse_perm(ElementwisePermutation<EVector> &x, Vector<IndexType> &permutation) {
     local_apply_inverse_perm(x.sharedVector, permutation);
 }
 
@@ -381,6 +347,70 @@ void hm_oblivious_apply_sharded_perm(ElementwisePermutation<EVector> &x,
     hm_oblivious_apply_sharded_perm(x.sharedVector, permutation);
 }
 
+/**
+ * @brief Obliviously apply one sharded secret-shared permutation to several vectors of the same
+ * size (Honest Majority).
+ *
+ * The vectors are stacked into one matrix, arithmetic vectors first, so each hop reshares all of
+ * them, of both encodings, with a single exchange (see `reshare_mixed`).
+ *
+ * @tparam Share Share data type.
+ * @tparam EVector Share container type.
+ * @param columns The secret-shared vectors to permute.
+ * @param permutation The permutation to apply.
+ */
+template <typename Share, typename EVector>
+void hm_oblivious_apply_sharded_perm(std::vector<SharedVector<Share, EVector> *> &columns,
+                                     std::shared_ptr<HMShardedPermutation> &permutation) {
+    if (columns.empty()) {
+        return;
+    }
+    const size_t n = columns[0]->size();
+
+    int pID = orq::service::runTime->getPartyID();
+    auto groups = orq::service::runTime->getGroups();
+
+    // order the columns by encoding: arithmetic, then boolean
+    std::vector<SharedVector<Share, EVector> *> stacked;
+    for (orq::Encoding encoding : {orq::Encoding::AShared, orq::Encoding::BShared}) {
+        for (auto column : columns) {
+            assert(column->size() == n);
+            if (column->encoding == encoding) {
+                stacked.push_back(column);
+            }
+        }
+    }
+    const size_t num_arithmetic =
+        n * std::count_if(columns.begin(), columns.end(), [](auto column) {
+            return column->encoding == orq::Encoding::AShared;
+        });
+
+    // copy the columns into one contiguous matrix
+    EVector matrix(n * stacked.size());
+    std::vector<SharedVector<Share, EVector>> parts;
+    for (size_t c = 0; c < stacked.size(); c++) {
+        parts.emplace_back(matrix.slice(c * n, (c + 1) * n), stacked[c]->encoding);
+        parts[c] = *stacked[c];
+    }
+
+    // apply permutations to each column and reshare the whole matrix
+    for (std::set<int> group : groups) {
+        if (group.contains(pID)) {
+            auto &local_perm = (*permutation->getPermMap())[group];
+            for (auto &part : parts) {
+                local_apply_perm(part, local_perm);
+            }
+        }
+
+        orq::service::runTime->reshare_mixed(matrix, group, num_arithmetic);
+    }
+
+    // copy back out
+    for (size_t c = 0; c < stacked.size(); c++) {
+        *stacked[c] = parts[c];
+    }
+}
+
 /**
  * Obliviously apply the inverse of a sharded secret-shared permutation.
  *
@@ -633,6 +663,37 @@ void oblivious_apply_sharded_perm(ElementwisePermutation<EVector> &x,
     oblivious_apply_sharded_perm(x.sharedVector, permutation);
 }
 
+/**
+ * @brief Protocol agnostic function to apply one sharded permutation to several vectors.
+ *
+ * Dishonest-majority permutations are single-use correlations, so they cannot be shared across
+ * vectors; callers should apply a separate permutation to each vector instead.
+ *
+ * @tparam Share Share data type.
+ * @tparam EVector Share container type.
+ * @param columns The secret-shared vectors to permute.
+ * @param perm The permutation to apply.
+ */
+template <typename Share, typename EVector>
+void oblivious_apply_sharded_perm(std::vector<SharedVector<Share, EVector> *> &columns,
+                                  std::shared_ptr<ShardedPermutation> &perm) {
+#ifdef INSTRUMENT_APPLYPERM
+    if (!columns.empty()) {
+        count_oblivious_apply_perm<Share>(columns.size() * columns[0]->size());
+    }
+#endif
+
+    if (auto hm_perm = std::dynamic_pointer_cast<HMShardedPermutation>(perm)) {
+        // honest majority
+        hm_oblivious_apply_sharded_perm(columns, hm_perm);
+    } else {
+#ifndef MPC_PROTOCOL_DUMMY_ZERO
+        // DMShardedPermutation (or unknown)
+        throw std::runtime_error("Multi-column apply requires an HMShardedPermutation");
+#endif
+    }
+}
+
 /**
  * @brief Protocol agnostic function to apply sharded permutations.
  *
@@ -691,20 +752,116 @@ void oblivious_apply_elementwise_perm(SharedVector<Share, EVector> &x,
     ElementwisePermutation<EVectorPerm> permutation(perm);
 
     // generate a pair of random sharded permutations
-    auto [pi_1, pi_2] = PermutationManager::get()->getNextPair<Share, int>(x.size(), x.encoding,
-                                                                           perm.getEncoding());
+    auto [pi_1, pi_2] = PermutationManager::get()->getNextPair<Share, IndexType>(
+        x.size(), x.encoding, perm.getEncoding());
 
     // shuffle both the vector and the permutation according to pi
     oblivious_apply_sharded_perm(x, pi_1);
     oblivious_apply_sharded_perm(permutation, pi_2);
 
     // open pi(perm)
-    Vector<int> pi_perm = permutation.open();
+    Vector<IndexType> pi_perm = permutation.open();
 
     // locally apply pi(perm) to pi(x)
     local_apply_perm(x, pi_perm);
 }
 
+/**
+ * @brief Obliviously apply an elementwise secret-shared permutation to several vectors.
+ *
+ * With honest majority, all vectors are shuffled by the same sharded permutation (see
+ * `hm_oblivious_apply_sharded_perm`), so this consumes one pair and reshares once per hop and
+ * encoding. In 2PC, each vector needs its own pair of permutation correlations, so this falls back
+ * to one `oblivious_apply_elementwise_perm` per vector.
+ *
+ * @tparam Share Share data type.
+ * @tparam EVector Share container type.
+ * @tparam EVectorPerm Permutation type.
+ * @param columns The secret-shared vectors to permute, all of the permutation's size.
+ * @param perm The permutation to apply.
+ */
+template <typename Share, typename EVector, typename EVectorPerm>
+void oblivious_apply_elementwise_perm(std::vector<SharedVector<Share, EVector> *> columns,
+                                      ElementwisePermutation<EVectorPerm> &perm) {
+    if (columns.empty()) {
+        return;
+    }
+
+    if (runTime->getNumParties() == 2) {
+        for (auto column : columns) {
+            oblivious_apply_elementwise_perm(*column, perm);
+        }
+        return;
+    }
+
+    // make a deep copy of the permutation
+    ElementwisePermutation<EVectorPerm> permutation(perm);
+
+    // generate a pair of random sharded permutations
+    auto [pi_1, pi_2] = PermutationManager::get()->getNextPair<Share, IndexType>(
+        perm.size(), columns[0]->encoding, perm.getEncoding());
+
+    // shuffle all vectors and the permutation according to pi
+    oblivious_apply_sharded_perm(columns, pi_1);
+    oblivious_apply_sharded_perm(permutation, pi_2);
+
+    // open pi(perm)
+    Vector<IndexType> pi_perm = permutation.open();
+
+    // locally apply pi(perm) to each pi(x)
+    for (auto column : columns) {
+        local_apply_perm(*column, pi_perm);
+    }
+}
+
+/**
+ * @brief Obliviously apply an elementwise secret-shared permutation to two vectors of different
+ * share types.
+ *
+ * With honest majority, both vectors are shuffled by the same sharded permutation and the
+ * permutation is opened once. In 2PC, permutation correlations are specific to the share type, so
+ * this falls back to one `oblivious_apply_elementwise_perm` per vector.
+ *
+ * @tparam S1 Share data type of the first vector.
+ * @tparam E1 Share container type of the first vector.
+ * @tparam S2 Share data type of the second vector.
+ * @tparam E2 Share container type of the second vector.
+ * @tparam EVectorPerm Permutation type.
+ * @param x The first secret-shared vector to permute.
+ * @param y The second secret-shared vector to permute, of the same size.
+ * @param perm The permutation to apply.
+ */
+template <typename S1, typename E1, typename S2, typename E2, typename EVectorPerm>
+void oblivious_apply_elementwise_perm(SharedVector<S1, E1> &x, SharedVector<S2, E2> &y,
+                                      ElementwisePermutation<EVectorPerm> &perm) {
+    assert(x.size() == y.size());
+
+    if (runTime->getNumParties() == 2) {
+        oblivious_apply_elementwise_perm(x, perm);
+        oblivious_apply_elementwise_perm(y, perm);
+        return;
+    }
+
+    // make a deep copy of the permutation
+    ElementwisePermutation<EVectorPerm> permutation(perm);
+
+    // generate a pair of random sharded permutations
+    auto [pi_1, pi_2] = PermutationManager::get()->getNextPair<S1, IndexType>(
+        x.size(), x.encoding, perm.getEncoding());
+
+    // shuffle both vectors and the permutation according to pi
+    oblivious_apply_sharded_perm(x, pi_1);
+    oblivious_apply_sharded_perm(y, pi_1);
+    oblivious_apply_sharded_perm(permutation, pi_2);
+
+    // open pi(perm)
+    Vector<IndexType> pi_perm = permutation.open();
+
+    // locally apply pi(perm) to pi(x) and pi(y)
+    local_apply_perm(x, pi_perm);
+    local_apply_perm(y, pi_perm);
+}
+
 /**
  * @brief Compose two elementwise secret-shared permutations.
  *
@@ -720,14 +877,14 @@ ElementwisePermutation<EVector> compose_permutations(ElementwisePermutation<EVec
 
     // generate a random sharded permutation
     std::shared_ptr<ShardedPermutation> pi =
-        PermutationManager::get()->getNext<int32_t>(sigma.size(), sigma.getEncoding());
+        PermutationManager::get()->getNext<IndexType>(sigma.size(), sigma.getEncoding());
 
     // apply the random permutation pi to sigma
     // sigma' := pi(sigma) = sigma * pi_inverse (observation 2.4)
     oblivious_apply_sharded_perm(sigma, pi);
 
     // open pi(sigma) = sigma * pi_inverse
-    Vector<int> pi_sigma = sigma.open();
+    Vector<IndexType> pi_sigma = sigma.open();
 
     // apply inverse(pi(sigma)) to rho
     // rho' := inverse(pi(sigma))(rho) = (pi * sigma_inverse)(rho) = rho * sigma
@@ -768,10 +925,20 @@ static void shuffle(SharedVector<Share, EVector> &x) {
 template <typename Share, typename EVector>
 static void shuffle(std::vector<ASharedVector<Share, EVector> *> _data_a,
                     std::vector<BSharedVector<Share, EVector> *> _data_b, size_t size) {
-    // generate a random sharded permutation and use it to generate a random
-    // elementwise permutation
+    // generate a random sharded permutation
     std::shared_ptr<ShardedPermutation> sharded_perm =
-        PermutationManager::get()->getNext<int32_t>(size, orq::Encoding::BShared);
+        PermutationManager::get()->getNext<IndexType>(size, orq::Encoding::BShared);
+
+    if (std::dynamic_pointer_cast<HMShardedPermutation>(sharded_perm)) {
+        // honest majority: apply the sharded permutation to all columns at once
+        std::vector<SharedVector<Share, EVector> *> columns(_data_a.begin(), _data_a.end());
+        columns.insert(columns.end(), _data_b.begin(), _data_b.end());
+        oblivious_apply_sharded_perm(columns, sharded_perm);
+        return;
+    }
+
+    // otherwise, use the sharded permutation to generate a random elementwise
+    // permutation
     ElementwisePermutation<EVector> permutation(size, orq::Encoding::BShared);
     oblivious_apply_sharded_perm(permutation, sharded_perm);
 
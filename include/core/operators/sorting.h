@@ -1,6 +1,7 @@
 #pragma once
 
 #include "common.h"
+#include "core/containers/packed_b_shared_vector.h"
 #include "shuffle.h"
 
 // To change the default sort protocol, recompile with this option set
@@ -37,6 +38,8 @@ namespace operators {
     static ElementwisePermutation<E> radix_sort(
         BSharedVector<S, E>& v, SortOrder order = SortOrder::ASC,
         const size_t bits = std::numeric_limits<std::make_unsigned_t<S>>::digits);
+
+    static int radix_num_passes(const size_t n, const int bits, const int perm_ops);
     // \endcond DOXYGEN_IGNORE
 
     /**
@@ -76,7 +79,6 @@ namespace operators {
      * and l's second key is greater than r's second key, or the first two keys are the same and so
      * forth, for all keys.
      */
-    // TODO: use bit compression.
     template <typename Share, typename EVector>
     static BSharedVector<Share, EVector> compare_rows(
         const std::vector<BSharedVector<Share, EVector>*>& x_vec,
@@ -84,6 +86,7 @@ namespace operators {
         const std::vector<SortOrder>& order) {
         assert((x_vec.size() > 0) && (x_vec.size() == y_vec.size()) &&
                (order.size() == x_vec.size()));
+        using Packed = typename BSharedVector<Share, EVector>::Packed;
         const int cols_num = x_vec.size();  // Number of keys
         // Compare elements on first key
         BSharedVector<Share, EVector>* t = order[0] == SortOrder::DESC ? y_vec[0] : x_vec[0];
@@ -91,6 +94,14 @@ namespace operators {
         BSharedVector<Share, EVector> eq(t->size());
         BSharedVector<Share, EVector> gt(t->size());
         t->_compare(*o, eq, gt);
+        if (cols_num == 1) {
+            gt.asEVector().mask(1);
+            return gt;
+        }
+        // Compose the result bits of the remaining keys in packed form, so that the two ANDs per
+        // key only communicate one bit per row.
+        Packed p_eq(eq);
+        Packed p_gt(gt);
         // Compare elements on remaining keys
         for (int i = 1; i < cols_num; ++i) {
             bool invert = order[i] == SortOrder::DESC;
@@ -99,12 +110,13 @@ namespace operators {
             BSharedVector<Share, EVector> new_eq(t->size());
             BSharedVector<Share, EVector> new_gt(t->size());
             t->_compare(*o, new_eq, new_gt);
+            Packed p_new_eq(new_eq);
+            Packed p_new_gt(new_gt);
             // Compose 'gt' and `eq` bits
-            gt = gt ^ (new_gt & eq);
-            eq = eq & new_eq;
+            p_gt ^= p_new_gt & p_eq;
+            p_eq &= p_new_eq;
         }
-        gt.asEVector().mask(1);
-        return gt;
+        return p_gt.unpack();
     }
 
     /**
@@ -405,7 +417,8 @@ namespace operators {
     // For int64, pad up to 128. Otherwise use int64_t by default.
     // (We've decided to use 32 bits for padding, so we can support vectors of
     // at most 4B elements. So even an 8 bit vector would need 8+32 = 40 bits
-    // of padding.)
+    // of padding.) Only quicksort pads its input, since it needs unique keys;
+    // radix sort carries the index in a separate column instead.
     template <typename T>
     using PadWidth =
         typename std::conditional<std::is_same<T, int64_t>::value, __int128_t, int64_t>::type;
@@ -432,10 +445,13 @@ namespace operators {
     static PaddedBSharedVector<EVector> pad_input(BSharedVector<Share, EVector>& v,
                                                   bool reverse_order) {
         auto _size = v.size();
+        if (_size > (size_t)std::numeric_limits<int32_t>::max()) {
+            throw std::runtime_error("pad_input: 32-bit padding supports at most 2^31 - 1 rows");
+        }
         PaddedBSharedVector<EVector> ret(_size);
 
         orq::Vector<int> idx(_size);
-        for (int i = 0; i < _size; i++) {
+        for (int i = 0; i < (int)_size; i++) {
             idx[i] = reverse_order ? (-1 - i) : i;
         }
 
@@ -526,28 +542,41 @@ namespace operators {
 
         // See Project Wiki for derivation. At a high level:
         // - Quicksort needs extra perms for shuffle
-        // - Multibit radixsort needs one extra pair per bit
+        // - Multibit radixsort needs one extra pair per digit (see `radix_digit_bits`)
         // - 2PC doesn't need perms for b2a, but all other protocols do.
         int perms_required = nk + ns - 1;
         int pairs_required = 4 * ns + 3 * nk + nc - 1;
         if (protocol == SortingProtocol::QUICKSORT) {
             perms_required += nk;
         } else if (protocol == SortingProtocol::RADIXSORT) {
-            pairs_required += nk * L;
+            pairs_required += nk * radix_num_passes(size, L, 1);
         }
 
+#ifdef MPC_PROTOCOL_BEAVER_TWO
+        // 2PC radix sorts permute their index column with a separate pair per pass
+        pairs_required += ns;
+        if (protocol == SortingProtocol::RADIXSORT) {
+            pairs_required += nk * radix_num_passes(size, L, 1);
+        }
+#endif
+
 #ifndef MPC_PROTOCOL_BEAVER_TWO
         // Non-2PC. Note: this is a compile time check because we may add other
         // two-party protocols in the future for which this edge case does not
         // apply...
         perms_required += nk + ns;
+
+        // Applying the sort permutation to all columns takes one pair, rather
+        // than one per column (see the multi-column oblivious_apply_elementwise_perm)
+        pairs_required -= nk + ns + nc - 1;
 #endif
 
 #ifdef INSTRUMENT_TABLES
         single_cout("[TABLE_GENPERM] p=" << perms_required << " n=" << size
                                          << " pairs=" << pairs_required);
 #endif
-        orq::random::PermutationManager::get()->reserve(size, perms_required, pairs_required);
+        // generated in the background (honest majority) while the sort runs
+        orq::random::PermutationManager::get()->prefetch(size, perms_required, pairs_required);
 
         // sort subroutine, to pick the right algorithm
         auto sort_sub = [&, protocol](const int sort_col) {
@@ -594,19 +623,12 @@ namespace operators {
             sort_permutation = compose_permutations(sort_permutation, next_permutation);
         }
 
-        // apply sort perm to key columns...
-        for (int j = 0; j < _columns.size(); j++) {
-            oblivious_apply_elementwise_perm(*_columns[j], sort_permutation);
-        }
-
-        // ...all arithmetic columns
-        for (auto& a_column : _data_a) {
-            oblivious_apply_elementwise_perm(*a_column, sort_permutation);
-        }
-        // ...and all binary columns
-        for (auto& b_column : _data_b) {
-            oblivious_apply_elementwise_perm(*b_column, sort_permutation);
-        }
+        // apply sort perm to key columns, all arithmetic columns, and all
+        // binary columns at once
+        std::vector<SharedVector<Share, EVector>*> all_columns(_columns.begin(), _columns.end());
+        all_columns.insert(all_columns.end(), _data_a.begin(), _data_a.end());
+        all_columns.insert(all_columns.end(), _data_b.begin(), _data_b.end());
+        oblivious_apply_elementwise_perm(all_columns, sort_permutation);
 
         // At this point, should be zero permutations left in the queue
     }
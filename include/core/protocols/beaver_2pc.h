@@ -116,6 +116,32 @@ class Beaver_2PC : public Protocol<Data, Share, Vector, EVector> {
         this->handle_precision(x, y, z);
     }
 
+    /**
+     * @brief Secure bitwise AND of the `bits` least significant bits. Masking a boolean
+     * sharing bitwise yields a sharing of the masked value, so the masked triple is still a
+     * valid triple and both openings only send `bits` bits per element.
+     *
+     * @param x Binary shared input.
+     * @param y Binary shared input.
+     * @param z Binary shared output (higher bits cleared).
+     * @param bits Number of significant bits per element.
+     */
+    void and_b(const EVector &x, const EVector &y, EVector &z, const int &bits) {
+        const Data m = this->low_bits_mask(bits);
+        auto [a, b, c] = BTANDgen->getNext(x.size());
+        a.mask(m);
+        b.mask(m);
+        c.mask(m);
+
+        auto A = open_shares_b(x ^ a, bits);
+        auto B = open_shares_b(y ^ b, bits);
+
+        z = (y & A) ^ (a & B) ^ c;
+        z.mask(m);
+
+        this->handle_precision(x, y, z);
+    }
+
     /**
      * @brief Boolean complement operation.
      *
@@ -252,6 +278,22 @@ class Beaver_2PC : public Protocol<Data, Share, Vector, EVector> {
         return shares(0) ^ shares_2;
     }
 
+    /**
+     * @brief Open the `bits` least significant bits of boolean shares, sending only those bits.
+     *
+     * @param shares Input shared vector.
+     * @param bits Number of significant bits per element.
+     * @return Opened plaintext vector (higher bits zero).
+     */
+    Vector open_shares_b(const EVector &shares, const int &bits) {
+        Vector shares_2(shares(0).size());
+        this->communicator->exchangeShares(shares(0), shares_2, 1, shares.size(),
+                                           SignificantBits{bits});
+        Vector opened = shares(0) ^ shares_2;
+        opened.mask(this->low_bits_mask(bits));
+        return opened;
+    }
+
     /**
      * @brief Generate arithmetic shares for a single value.
      *
@@ -81,13 +81,16 @@ class Fantastic_4PC : public Protocol<Data, Share, Vector, EVector> {
         this->randomnessManager->commonPRGManager->get(-1)->getNext(r_prev);
 
         // Parties generate the cross terms they know
+        Vector cross_10(size), cross_12(size), cross_02(size);
         // ...shared with previous party, randomness excludes next
-        auto cross_10 = x(0) * y(0) + x(0) * y(1) + x(1) * y(0) - r_next;
+        cross_10.fma_accumulate(x(0), y(0), x(0), y(1), x(1), y(0));
+        cross_10 -= r_next;
         // ...shared with next party, randomness excludes opposite
-        auto cross_12 = x(1) * y(1) + x(1) * y(2) + x(2) * y(1) - r_opp;
+        cross_12.fma_accumulate(x(1), y(1), x(1), y(2), x(2), y(1));
+        cross_12 -= r_opp;
         // ...shared with opposite party.
         // We'll randomize below, since it's different per party.
-        auto cross_02 = x(0) * y(2) + x(2) * y(0);
+        cross_02.fma_accumulate(x(0), y(2), x(2), y(0));
 
         // Use these vectors to as communicator buffers
         Vector mult_recv(size), mult_recv_check(size);
@@ -345,13 +348,16 @@ class Fantastic_4PC : public Protocol<Data, Share, Vector, EVector> {
         this->randomnessManager->commonPRGManager->get(-1)->getNext(r_prev);
 
         // Parties generate the cross terms they know
+        Vector cross_10(size), cross_12(size), cross_02(size);
         // ...shared with previous party, randomness excludes next
-        auto cross_10 = x(0) & y(0) ^ x(0) & y(1) ^ x(1) & y(0) ^ r_next;
+        cross_10 = r_next;
+        cross_10.xor_and_accumulate(x(0), y(0), x(0), y(1), x(1), y(0));
         // ...shared with next party, randomness excludes opposite
-        auto cross_12 = x(1) & y(1) ^ x(1) & y(2) ^ x(2) & y(1) ^ r_opp;
+        cross_12 = r_opp;
+        cross_12.xor_and_accumulate(x(1), y(1), x(1), y(2), x(2), y(1));
         // ...shared with opposite party.
         // We'll randomize below, since it's different per party.
-        auto cross_02 = x(0) & y(2) ^ x(2) & y(0);
+        cross_02.xor_and_accumulate(x(0), y(2), x(2), y(0));
 
         // Use these vectors to as communicator buffers
         Vector mult_recv(size), mult_recv_check(size);
@@ -802,9 +808,9 @@ class Fantastic_4PC : public Protocol<Data, Share, Vector, EVector> {
      *
      * @param v The vector to be rerandomized and reshared.
      * @param group The group performing the resharing.
-     * @param binary A flag indicating an arithmetic or binary encoding of the vector.
+     * @param num_arithmetic The number of leading arithmetic shares; the rest are binary.
      */
-    void reshare(EVector &v, const std::set<int> group, bool binary) {
+    void reshare_mixed(EVector &v, const std::set<int> group, const size_t num_arithmetic) {
         assert(group.size() == 3);
 
         // find receive party
@@ -821,28 +827,7 @@ class Fantastic_4PC : public Protocol<Data, Share, Vector, EVector> {
 
         // all parties in the group -> generate a zero sharing to rerandomize the vector
         if (receiver_rel_rank != 0) {
-            // generate randomness
-            std::vector<Vector> rand;
-            for (int i = 0; i < 4; i++) {
-                rand.push_back(Vector(v.size()));
-            }
-
-            if (binary) {
-                this->randomnessManager->zeroSharingGenerator->groupGetNextBinary(rand, group);
-            } else {
-                this->randomnessManager->zeroSharingGenerator->groupGetNextArithmetic(rand, group);
-            }
-
-            auto my_shares = this->getPartyShareMappings()[this->partyID];
-            // Generating too many random values here: each party only needs
-            // RepNum random vectors, but is generating PartyNum
-            for (int i = 0; i < 3; i++) {
-                if (binary) {
-                    v(i) ^= rand[my_shares[i]];
-                } else {
-                    v(i) += rand[my_shares[i]];
-                }
-            }
+            this->rerandomize(v, group, num_arithmetic);
         }
 
         /*
@@ -2,6 +2,8 @@
 
 #include <sodium.h>
 
+#include "jmp_hash.h"
+
 namespace orq {
 
 /**
@@ -17,7 +19,11 @@ namespace orq {
  */
 template <typename Data, typename Share, typename Vector, typename EVector>
 class Fantastic_4PC : public Protocol<Data, Share, Vector, EVector> {
-    std::map<std::pair<int, int>, std::unique_ptr<crypto_generichash_state>> hash_states;
+    std::map<std::pair<int, int>, JmpHash> hash_states;
+#ifdef USE_JMP_ASYNC_HASH
+    // Declared after hash_states, so it stops before the states are destroyed
+    JmpHashQueue<JmpHash> hash_queue;
+#endif
 
     /**
      * @brief Computes the JMP receiver.
@@ -104,21 +110,60 @@ class Fantastic_4PC : public Protocol<Data, Share, Vector, EVector> {
     void init_hash(int i, int j) {
         assert(i < j);
 
-        crypto_generichash_init(hash_states[{i, j}].get(), NULL, 0, crypto_generichash_BYTES);
-
         // Seed the hash with the party ID for domain separation
         uint8_t seed = i << 4 | j;
-        crypto_generichash_update(hash_states[{i, j}].get(), reinterpret_cast<u_char *>(&seed),
-                                  sizeof(seed));
+        hash_states[{i, j}].init(seed);
+    }
+
+    /**
+     * @brief Draw the key of every pair's hash.
+     *
+     * A keyed hash only catches a cheating sender if the sender does not know
+     * the key, so it comes from the common PRG of the three parties other than
+     * the sender. The receiver and the hasher both hold it. Every party except
+     * the sender draws in the same order, to keep that PRG in sync.
+     */
+    void key_hashes() {
+        for (int i = 0; i < 4; i++) {
+            for (int j = i + 1; j < 4; j++) {
+                std::array<uint8_t, JmpHash::KEY_BYTES> key{};
+                if constexpr (JmpHash::KEY_BYTES > 0) {
+                    int send_party = i == who_hashes(i, j) ? j : i;
+                    if (this->partyID != send_party) {
+                        this->randomnessManager->commonPRGManager->get(abs2rel(send_party))
+                            ->getNext(key);
+                    }
+                }
+                hash_states[{i, j}].set_key(key);
+            }
+        }
+    }
+
+    /**
+     * @brief Add a JMP message to a pair's hash.
+     *
+     * With `USE_JMP_ASYNC_HASH`, the update is queued for the background
+     * hashing thread and `malicious_check` waits for it.
+     *
+     * @param hash_id Pair of parties, in increasing order.
+     * @param bytes Message bytes.
+     */
+    void update_hash(const std::pair<int, int> &hash_id, std::span<const u_char> bytes) {
+#ifdef USE_JMP_ASYNC_HASH
+        hash_queue.push(&hash_states[hash_id], bytes.data(), bytes.size());
+#else
+        hash_states[hash_id].update(bytes.data(), bytes.size());
+#endif
     }
 
     /**
      * @brief Internal method to open shares using JMP protocol.
      *
      * @param sh Input shared vector.
+     * @param width Number of significant bits per element (0 for full width).
      * @return Opened plaintext vector.
      */
-    Vector _open_shares(const EVector &sh) {
+    Vector _open_shares(const EVector &sh, SignificantBits width = {}) {
         size_t N = sh.size();
         Vector sh3(N);
 
@@ -131,11 +176,11 @@ class Fantastic_4PC : public Protocol<Data, Share, Vector, EVector> {
 
             if (this->partyID == Pr) {
                 // Receive into extra vector
-                _jmp_recv(sh3, Pi, Pj, Pr);
+                _jmp_recv(sh3, Pi, Pj, Pr, width);
             } else if (this->partyID == Pi || this->partyID == Pj) {
                 // Send missing share
                 auto rel_sh = abs2sh(Pr);
-                _jmp_send(sh(rel_sh), Pi, Pj, Pr);
+                _jmp_send(sh(rel_sh), Pi, Pj, Pr, width);
             }
         }
         return sh3;
@@ -226,19 +271,20 @@ class Fantastic_4PC : public Protocol<Data, Share, Vector, EVector> {
      * @param Pi First sender party.
      * @param Pj Second sender party.
      * @param Pr Receiver party (must be this party).
+     * @param width Number of significant bits per element (0 for full width).
      */
-    void _jmp_recv(Vector &x, int Pi, int Pj, int Pr) {
+    void _jmp_recv(Vector &x, int Pi, int Pj, int Pr, SignificantBits width = {}) {
         // ONLY receiver can call this.
         assert(this->partyID == Pr);
 
         auto [_, send_party, hash_id] = _jmp_assignments(Pi, Pj);
 
         auto span = x.batch_span();
-        auto byte_ptr = reinterpret_cast<u_char *>(span.data());
+        auto byte_ptr = reinterpret_cast<const u_char *>(span.data());
 
         // Receive & update my hash.
-        this->communicator->receiveShares(x, abs2rel(send_party), x.size());
-        crypto_generichash_update(hash_states[hash_id].get(), byte_ptr, span.size_bytes());
+        this->communicator->receiveShares(x, abs2rel(send_party), x.size(), width);
+        update_hash(hash_id, {byte_ptr, span.size_bytes()});
     }
 
     /**
@@ -248,18 +294,23 @@ class Fantastic_4PC : public Protocol<Data, Share, Vector, EVector> {
      * @param Pi First sender party.
      * @param Pj Second sender party.
      * @param Pr Receiver party.
+     * @param width Number of significant bits per element (0 for full width). Bits above the
+     * width must be zero, since the hash covers the full words.
      */
-    void _jmp_send(const Vector &x, int Pi, int Pj, int Pr) {
+    void _jmp_send(const Vector &x, int Pi, int Pj, int Pr, SignificantBits width = {}) {
         auto [hash_party, send_party, hash_id] = _jmp_assignments(Pi, Pj);
 
-        auto span = x.batch_span();
-        auto byte_ptr = reinterpret_cast<const u_char *>(span.data());
-
         if (this->partyID == send_party) {
-            this->communicator->sendShares(x, abs2rel(Pr), x.size());
+            // The communicator sends mapped vectors in place
+            this->communicator->sendShares(x, abs2rel(Pr), x.size(), width);
         } else if (this->partyID == hash_party) {
+            // The hash needs contiguous bytes
+            auto contiguous = x.materialize();
+            auto span = contiguous.batch_span();
+            auto byte_ptr = reinterpret_cast<const u_char *>(span.data());
+
             // update hash
-            crypto_generichash_update(hash_states[hash_id].get(), byte_ptr, span.size_bytes());
+            update_hash(hash_id, {byte_ptr, span.size_bytes()});
         }
     }
 
@@ -289,10 +340,9 @@ class Fantastic_4PC : public Protocol<Data, Share, Vector, EVector> {
                   random::RandomnessManager *_randomnessManager)
         : Protocol<Data, Share, Vector, EVector>(_communicator, _randomnessManager, _partyID, 4,
                                                  3) {
+        key_hashes();
         for (int Pi = 0; Pi < 4; Pi++) {
             for (int Pj = Pi + 1; Pj < 4; Pj++) {
-                hash_states[{Pi, Pj}] = std::make_unique<crypto_generichash_state>();
-
                 init_hash(Pi, Pj);
             }
         }
@@ -305,12 +355,13 @@ class Fantastic_4PC : public Protocol<Data, Share, Vector, EVector> {
      * @param from Owner of this data.
      * @param also_from Co-owner of data.
      * @param to Party who will receive data from both.
+     * @param width Number of significant bits per element (0 for full width).
      */
-    void jmp(Vector &x, int from, int also_from, int to) {
+    void jmp(Vector &x, int from, int also_from, int to, SignificantBits width = {}) {
         if (this->partyID == to) {
-            _jmp_recv(x, from, also_from, to);
+            _jmp_recv(x, from, also_from, to, width);
         } else if (this->partyID == from || this->partyID == also_from) {
-            _jmp_send(x, from, also_from, to);
+            _jmp_send(x, from, also_from, to, width);
         }
         // excluded party nops (doesn't even need to call, but probably best
         // to do so)
@@ -327,11 +378,13 @@ class Fantastic_4PC : public Protocol<Data, Share, Vector, EVector> {
      * @param Pj Second owner.
      * @param Pg Optional third party (computed if not provided).
      * @param Ph Optional fourth party (computed if not provided).
+     * @param width Number of significant bits per element (0 for full width). Only meaningful
+     * for boolean sharings: the random share and the sent share are masked to the width.
      * @return Shared vector.
      */
     template <orq::Encoding E>
     EVector inp(const Vector &x, int Pi, int Pj, std::optional<int> Pg = {},
-                std::optional<int> Ph = {}) {
+                std::optional<int> Ph = {}, SignificantBits width = {}) {
         size_t n = x.size();
         EVector r(n);
 
@@ -354,9 +407,15 @@ class Fantastic_4PC : public Protocol<Data, Share, Vector, EVector> {
         Vector xg = r(abs2sh(*Pg));
         Vector xh = r(abs2sh(*Ph));
 
+        const bool narrow = E == Encoding::BShared && width.bits > 0;
+        const Data m = this->low_bits_mask(width.bits);
+
         if (this->partyID != Pg) {
             // Pi, Pj, Ph generate random, excluding Pg
             this->randomnessManager->commonPRGManager->get(abs2rel(*Pg))->getNext(xg);
+            if (narrow) {
+                xg.mask(m);
+            }
 
             if (this->partyID != Ph) {
                 // Pi Pj generate xh
@@ -364,12 +423,15 @@ class Fantastic_4PC : public Protocol<Data, Share, Vector, EVector> {
                     xh = x - xg;
                 } else if constexpr (E == Encoding::BShared) {
                     xh = x ^ xg;
+                    if (narrow) {
+                        xh.mask(m);
+                    }
                 }
             }
         }
 
         // Ph does nothing in this function
-        jmp(xh, Pi, Pj, *Pg);
+        jmp(xh, Pi, Pj, *Pg, width);
 
         return r;
     }
@@ -406,13 +468,16 @@ class Fantastic_4PC : public Protocol<Data, Share, Vector, EVector> {
                     hi = abs2sh(Ph);
                     gi = abs2sh(Pg);
 
-                    r += inp<Encoding::AShared>(x(hi) * y(gi) + x(gi) * y(hi), Pi, Pj, Pg, Ph);
+                    Vector cross(x.size());
+                    cross.fma_accumulate(x(hi), y(gi), x(gi), y(hi));
+                    r += inp<Encoding::AShared>(cross, Pi, Pj, Pg, Ph);
                 }
             }
         }
 
         // self terms.
-        z = r + x * y;
+        r.fma_accumulate(x, y);
+        z = r;
 
         this->handle_precision(x, y, z);
         this->truncate(z);
@@ -491,13 +556,56 @@ class Fantastic_4PC : public Protocol<Data, Share, Vector, EVector> {
                     hi = abs2sh(Ph);
                     gi = abs2sh(Pg);
 
-                    r ^= inp<Encoding::BShared>(x(hi) & y(gi) ^ x(gi) & y(hi), Pi, Pj, Pg, Ph);
+                    Vector cross(x.size());
+                    cross.xor_and_accumulate(x(hi), y(gi), x(gi), y(hi));
+                    r ^= inp<Encoding::BShared>(cross, Pi, Pj, Pg, Ph);
                 }
             }
         }
 
         // self terms.
-        z = r ^ (x & y);
+        r.xor_and_accumulate(x, y);
+        z = r;
+
+        this->handle_precision(x, y, z);
+    }
+
+    /**
+     * @brief Boolean AND of the `bits` least significant bits. Every INP masks its random and
+     * sent shares to the width, so only `bits` bits per element cross the wire.
+     *
+     * @param x First input vector.
+     * @param y Second input vector.
+     * @param z Output vector (higher bits cleared).
+     * @param bits Number of significant bits per element.
+     */
+    void and_b(const EVector &x, const EVector &y, EVector &z, const int &bits) {
+        const SignificantBits width{bits};
+        int Pi, Pj, Pg, Ph, hi, gi;
+        EVector r(x.size());
+
+        for (Pi = 0; Pi < 4; Pi++) {
+            for (Pj = Pi + 1; Pj < 4; Pj++) {
+                Pg = next_party(Pi, Pj);
+                Ph = excluded_party(Pi, Pj, Pg);
+
+                if (this->partyID == Pg || this->partyID == Ph) {
+                    r ^= inp<Encoding::BShared>(r(0), Pi, Pj, Pg, Ph, width);
+                } else {
+                    hi = abs2sh(Ph);
+                    gi = abs2sh(Pg);
+
+                    Vector cross(x.size());
+                    cross.xor_and_accumulate(x(hi), y(gi), x(gi), y(hi));
+                    r ^= inp<Encoding::BShared>(cross, Pi, Pj, Pg, Ph, width);
+                }
+            }
+        }
+
+        // self terms.
+        r.xor_and_accumulate(x, y);
+        z = r;
+        z.mask(this->low_bits_mask(bits));
 
         this->handle_precision(x, y, z);
     }
@@ -673,6 +781,20 @@ class Fantastic_4PC : public Protocol<Data, Share, Vector, EVector> {
         return shares(0) ^ shares(1) ^ shares(2) ^ sh3;
     }
 
+    /**
+     * @brief Open the `bits` least significant bits of boolean shares, sending only those bits.
+     * The shares are masked first, so the JMP hashes agree with the packed transfers.
+     *
+     * @param shares Input shared vector.
+     * @param bits Number of significant bits per element.
+     * @return Opened plaintext vector (higher bits zero).
+     */
+    Vector open_shares_b(const EVector &shares, const int &bits) {
+        EVector masked = shares & this->low_bits_mask(bits);
+        auto sh3 = _open_shares(masked, SignificantBits{bits});
+        return masked(0) ^ masked(1) ^ masked(2) ^ sh3;
+    }
+
     /**
      * @brief Malicious check for hash consistency.
      *
@@ -680,9 +802,14 @@ class Fantastic_4PC : public Protocol<Data, Share, Vector, EVector> {
      * @return True if checks passed, false otherwise.
      */
     bool malicious_check(bool should_abort = true) {
-        auto N = crypto_generichash_blake2b_BYTES;
+        auto N = JmpHash::DIGEST_BYTES;
         orq::Vector<int8_t> hash(N);
         bool ok = true;
+
+#ifdef USE_JMP_ASYNC_HASH
+        hash_queue.drain();
+#endif
+
         for (int i = 0; i < 4; i++) {
             for (int j = i + 1; j < 4; j++) {
                 auto hasher = who_hashes(i, j);
@@ -691,9 +818,9 @@ class Fantastic_4PC : public Protocol<Data, Share, Vector, EVector> {
                     continue;
                 }
 
-                // Bit hacky, but sodium needs a pointer, while communicator
+                // Bit hacky, but the hash needs a pointer, while communicator
                 // wants a orq::Vector
-                crypto_generichash_final(hash_states[{i, j}].get(), (uint8_t *)&hash[0], N);
+                hash_states[{i, j}].final((uint8_t *)&hash[0]);
 
                 //// Uncomment the below to look at each hash view ////
                 // std::cout << "P" << this->partyID << "'s view of H" << i << "," << j << ": ";
@@ -805,9 +932,9 @@ class Fantastic_4PC : public Protocol<Data, Share, Vector, EVector> {
      *
      * @param v The vector to be rerandomized and reshared.
      * @param group The group performing the resharing.
-     * @param binary A flag indicating an arithmetic or binary encoding of the vector.
+     * @param num_arithmetic The number of leading arithmetic shares; the rest are binary.
      */
-    void reshare(EVector &v, const std::set<int> group, bool binary) {
+    void reshare_mixed(EVector &v, const std::set<int> group, const size_t num_arithmetic) {
         assert(group.size() == 3);
 
         // find receive party
@@ -815,28 +942,7 @@ class Fantastic_4PC : public Protocol<Data, Share, Vector, EVector> {
 
         // all parties in the group generate a zero sharing to rerandomize the vector
         if (receiver != this->partyID) {
-            // generate randomness
-            std::vector<Vector> rand;
-            for (int i = 0; i < 4; i++) {
-                rand.push_back(Vector(v.size()));
-            }
-
-            if (binary) {
-                this->randomnessManager->zeroSharingGenerator->groupGetNextBinary(rand, group);
-            } else {
-                this->randomnessManager->zeroSharingGenerator->groupGetNextArithmetic(rand, group);
-            }
-
-            auto my_shares = this->getPartyShareMappings()[this->partyID];
-            // Generating too many random values here: each party only needs
-            // RepNum random vectors, but is generating PartyNum
-            for (int i = 0; i < my_shares.size(); i++) {
-                if (binary) {
-                    v(i) ^= rand[my_shares[i]];
-                } else {
-                    v(i) += rand[my_shares[i]];
-                }
-            }
+            this->rerandomize(v, group, num_arithmetic);
         }
 
         // distribute new shares - by absolute index
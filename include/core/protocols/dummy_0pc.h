@@ -376,11 +376,11 @@ class Dummy_0PC : public Protocol<Data, Share, Vector, EVector> {
      *
      * @param v Input/output vector.
      * @param group Party group.
-     * @param binary Whether shares are binary.
+     * @param num_arithmetic Number of leading arithmetic shares.
      */
-    void reshare(EVector &v, const std::set<int> group, bool binary) {
-        op_counter[__func__] += v.size();
-        round_counter[__func__] += 1;
+    void reshare_mixed(EVector &v, const std::set<int> group, const size_t num_arithmetic) {
+        op_counter["reshare"] += v.size();
+        round_counter["reshare"] += 1;
     }
 };
 
@@ -0,0 +1,407 @@
+#pragma once
+
+#include <sodium.h>
+
+#include <algorithm>
+#include <cassert>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <smmintrin.h>
+#include <wmmintrin.h>
+#define __ORQ_PCLMUL_SUPPORTED
+#endif
+
+// Upper bound on the bytes waiting in the background hashing queue. Workers
+// block once it is reached, so a slow hasher cannot grow memory without bound.
+#ifndef JMP_ASYNC_HASH_QUEUE_BYTES
+#define JMP_ASYNC_HASH_QUEUE_BYTES (1UL << 28)
+#endif
+
+namespace orq {
+
+/**
+ * @brief Unkeyed BLAKE2b hash of the JMP messages between a pair of parties.
+ *
+ * This is the original verification hash of the Fantastic-Four protocol.
+ * It is collision resistant, so it needs no key, but it runs at only a few
+ * GB/s per core.
+ */
+class Blake2bJmpHash {
+    crypto_generichash_state state;
+
+   public:
+    static constexpr size_t KEY_BYTES = 0;
+    static constexpr size_t DIGEST_BYTES = crypto_generichash_BYTES;
+
+    /**
+     * @brief No-op: BLAKE2b is unkeyed.
+     */
+    void set_key(std::span<const uint8_t> key) { assert(key.size() == KEY_BYTES); }
+
+    /**
+     * @brief Start a new digest.
+     *
+     * @param domain Domain separation byte (the pair of parties).
+     */
+    void init(uint8_t domain) {
+        crypto_generichash_init(&state, NULL, 0, DIGEST_BYTES);
+        crypto_generichash_update(&state, &domain, sizeof(domain));
+    }
+
+    void update(const uint8_t *bytes, size_t n) { crypto_generichash_update(&state, bytes, n); }
+
+    /**
+     * @brief Write the digest. The state must be re-initialized afterwards.
+     */
+    void final(uint8_t *digest) { crypto_generichash_final(&state, digest, DIGEST_BYTES); }
+};
+
+/**
+ * @brief Polynomial MAC over \f$GF(2^{128})\f$ of the JMP messages between a
+ * pair of parties.
+ *
+ * The message is split into 16-byte blocks \f$m_1, \dots, m_L\f$ (the last one
+ * zero-padded) and followed by a block holding the total length and the domain
+ * byte. The digest is \f$\sum_i m_i k^{L + 2 - i}\f$, evaluated with Horner's
+ * rule, modulo \f$x^{128} + x^7 + x^2 + x + 1\f$. Two different messages of at
+ * most \f$L\f$ blocks collide with probability at most \f$(L + 1) / 2^{128}\f$
+ * over the choice of \f$k\f$, so the key must be unknown to the party whose
+ * messages are being checked. The caller is responsible for that.
+ *
+ * With PCLMUL, eight blocks are multiplied by \f$k^8, \dots, k\f$ and reduced
+ * once. Otherwise, a portable carry-less multiplication computes the same
+ * digest, so parties may mix the two.
+ */
+class PolyJmpHash {
+    struct Block {
+        uint64_t lo = 0;
+        uint64_t hi = 0;
+    };
+
+    // Blocks multiplied per reduction on the PCLMUL path
+    static constexpr int LANES = 8;
+
+    // powers[i] = k^(i + 1)
+    Block powers[LANES];
+    Block acc;
+
+    uint8_t pending[16];
+    size_t pending_bytes = 0;
+    uint64_t total_bytes = 0;
+    uint8_t domain = 0;
+
+    // whether `absorb` takes the PCLMUL path
+    bool hardware;
+
+    // x^128 = x^7 + x^2 + x + 1
+    static constexpr uint64_t REDUCTION = 0x87;
+
+    /**
+     * @brief Portable 64x64 -> 128-bit carry-less multiplication.
+     */
+    static Block clmul64(uint64_t a, uint64_t b) {
+        Block r;
+        for (int i = 0; i < 64; i++) {
+            if ((b >> i) & 1) {
+                r.lo ^= a << i;
+                r.hi ^= i ? a >> (64 - i) : 0;
+            }
+        }
+        return r;
+    }
+
+    /**
+     * @brief Portable field multiplication.
+     */
+    static Block multiply(const Block &a, const Block &b) {
+        Block p0 = clmul64(a.lo, b.lo);
+        Block p1 = clmul64(a.lo, b.hi);
+        Block p2 = clmul64(a.hi, b.lo);
+        Block p3 = clmul64(a.hi, b.hi);
+
+        // 256-bit product, one 64-bit word at a time
+        uint64_t r0 = p0.lo;
+        uint64_t r1 = p0.hi ^ p1.lo ^ p2.lo;
+        uint64_t r2 = p1.hi ^ p2.hi ^ p3.lo;
+        uint64_t r3 = p3.hi;
+
+        // Fold the top half: r2 lands below x^128 after one multiplication by
+        // the reduction polynomial, r3 needs a second, smaller fold.
+        Block t0 = clmul64(r2, REDUCTION);
+        Block t1 = clmul64(r3, REDUCTION);
+        Block t2 = clmul64(t1.hi, REDUCTION);
+        return {r0 ^ t0.lo ^ t2.lo, r1 ^ t0.hi ^ t1.lo};
+    }
+
+    static Block load(const uint8_t *p) {
+        Block b;
+        std::memcpy(&b.lo, p, 8);
+        std::memcpy(&b.hi, p + 8, 8);
+        return b;
+    }
+
+    void absorb_portable(const uint8_t *p, size_t blocks) {
+        for (size_t i = 0; i < blocks; i++) {
+            Block m = load(p + 16 * i);
+            acc = multiply({acc.lo ^ m.lo, acc.hi ^ m.hi}, powers[0]);
+        }
+    }
+
+#ifdef __ORQ_PCLMUL_SUPPORTED
+    /**
+     * @brief Accumulate the unreduced 256-bit product a * b into [hi:lo].
+     */
+    __attribute__((target("pclmul,sse4.1"))) static void multiply_acc(__m128i a, __m128i b,
+                                                                      __m128i &lo, __m128i &hi) {
+        __m128i p0 = _mm_clmulepi64_si128(a, b, 0x00);
+        __m128i p1 = _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x01),
+                                   _mm_clmulepi64_si128(a, b, 0x10));
+        __m128i p3 = _mm_clmulepi64_si128(a, b, 0x11);
+        lo = _mm_xor_si128(lo, _mm_xor_si128(p0, _mm_slli_si128(p1, 8)));
+        hi = _mm_xor_si128(hi, _mm_xor_si128(p3, _mm_srli_si128(p1, 8)));
+    }
+
+    /**
+     * @brief Reduce [hi:lo] modulo the field polynomial; same folds as `multiply`.
+     */
+    __attribute__((target("pclmul,sse4.1"))) static __m128i reduce(__m128i lo, __m128i hi) {
+        const __m128i poly = _mm_set_epi64x(0, REDUCTION);
+        __m128i t0 = _mm_clmulepi64_si128(hi, poly, 0x00);
+        __m128i t1 = _mm_clmulepi64_si128(hi, poly, 0x01);
+        __m128i t2 = _mm_clmulepi64_si128(t1, poly, 0x01);
+        return _mm_xor_si128(_mm_xor_si128(lo, t0), _mm_xor_si128(_mm_slli_si128(t1, 8), t2));
+    }
+
+    __attribute__((target("pclmul,sse4.1"))) void absorb_pclmul(const uint8_t *p, size_t blocks) {
+        __m128i k[LANES];
+        for (int j = 0; j < LANES; j++) {
+            k[j] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&powers[j]));
+        }
+        auto in = reinterpret_cast<const __m128i *>(p);
+
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&acc));
+        size_t i = 0;
+        for (; i + LANES <= blocks; i += LANES) {
+            __m128i lo = _mm_setzero_si128();
+            __m128i hi = _mm_setzero_si128();
+            multiply_acc(_mm_xor_si128(a, _mm_loadu_si128(in + i)), k[LANES - 1], lo, hi);
+            for (int j = 1; j < LANES; j++) {
+                multiply_acc(_mm_loadu_si128(in + i + j), k[LANES - 1 - j], lo, hi);
+            }
+            a = reduce(lo, hi);
+        }
+        for (; i < blocks; i++) {
+            __m128i lo = _mm_setzero_si128();
+            __m128i hi = _mm_setzero_si128();
+            multiply_acc(_mm_xor_si128(a, _mm_loadu_si128(in + i)), k[0], lo, hi);
+            a = reduce(lo, hi);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(&acc), a);
+    }
+#endif
+
+    void absorb(const uint8_t *p, size_t blocks) {
+#ifdef __ORQ_PCLMUL_SUPPORTED
+        if (hardware) {
+            absorb_pclmul(p, blocks);
+            return;
+        }
+#endif
+        absorb_portable(p, blocks);
+    }
+
+   public:
+    static constexpr size_t KEY_BYTES = 16;
+    static constexpr size_t DIGEST_BYTES = 16;
+
+    /**
+     * @param use_hardware Use PCLMUL if this CPU supports it. Both paths compute the same digest;
+     * this only lets tests compare them.
+     */
+    explicit PolyJmpHash(bool use_hardware = true)
+        : hardware(use_hardware && hardwareSupported()) {}
+
+    /**
+     * @return true if this CPU supports the PCLMUL instructions used here.
+     */
+    static bool hardwareSupported() {
+#ifdef __ORQ_PCLMUL_SUPPORTED
+        static const bool supported =
+            __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1");
+        return supported;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Set the evaluation point. It is kept across `init` calls.
+     *
+     * @param key KEY_BYTES bytes, shared by the hashing and receiving parties.
+     */
+    void set_key(std::span<const uint8_t> key) {
+        assert(key.size() == KEY_BYTES);
+        powers[0] = load(key.data());
+        for (int i = 1; i < LANES; i++) {
+            powers[i] = multiply(powers[i - 1], powers[0]);
+        }
+    }
+
+    /**
+     * @brief Start a new digest.
+     *
+     * @param _domain Domain separation byte (the pair of parties).
+     */
+    void init(uint8_t _domain) {
+        acc = {};
+        pending_bytes = 0;
+        total_bytes = 0;
+        domain = _domain;
+    }
+
+    void update(const uint8_t *bytes, size_t n) {
+        total_bytes += n;
+
+        // Complete a partial block left by the previous update
+        if (pending_bytes > 0) {
+            size_t take = std::min(n, 16 - pending_bytes);
+            std::memcpy(pending + pending_bytes, bytes, take);
+            pending_bytes += take;
+            bytes += take;
+            n -= take;
+            if (pending_bytes < 16) {
+                return;
+            }
+            absorb(pending, 1);
+            pending_bytes = 0;
+        }
+
+        absorb(bytes, n / 16);
+        pending_bytes = n % 16;
+        std::memcpy(pending, bytes + n - pending_bytes, pending_bytes);
+    }
+
+    /**
+     * @brief Write the digest. The state must be re-initialized afterwards.
+     */
+    void final(uint8_t *digest) {
+        if (pending_bytes > 0) {
+            std::memset(pending + pending_bytes, 0, 16 - pending_bytes);
+            absorb(pending, 1);
+        }
+        Block length = {total_bytes, domain};
+        absorb(reinterpret_cast<const uint8_t *>(&length), 1);
+        std::memcpy(digest, &acc, DIGEST_BYTES);
+    }
+};
+
+#ifdef USE_JMP_BLAKE2B_HASH
+using JmpHash = Blake2bJmpHash;
+#else
+using JmpHash = PolyJmpHash;
+#endif
+
+/**
+ * @brief Applies JMP hash updates on a background thread, in order.
+ *
+ * Each update copies its bytes, since the caller is free to overwrite its
+ * buffer as soon as `push` returns. The thread is started by the first update,
+ * so protocol instances that never JMP do not spawn one. Call `drain` before
+ * reading a digest.
+ *
+ * @tparam Hash Hash type (`Blake2bJmpHash` or `PolyJmpHash`).
+ */
+template <typename Hash>
+class JmpHashQueue {
+    struct Task {
+        Hash *hash;
+        std::vector<uint8_t> bytes;
+    };
+
+    std::deque<Task> tasks;
+    size_t queued_bytes = 0;
+    bool busy = false;
+    bool stopping = false;
+
+    std::mutex mutex;
+    std::condition_variable work_available;
+    std::condition_variable work_done;
+    std::thread thread;
+
+    void run() {
+        std::unique_lock lock(mutex);
+        while (true) {
+            work_available.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (tasks.empty()) {
+                return;
+            }
+
+            Task task = std::move(tasks.front());
+            tasks.pop_front();
+            busy = true;
+
+            lock.unlock();
+            task.hash->update(task.bytes.data(), task.bytes.size());
+            lock.lock();
+
+            busy = false;
+            queued_bytes -= task.bytes.size();
+            work_done.notify_all();
+        }
+    }
+
+   public:
+    JmpHashQueue() = default;
+    JmpHashQueue(const JmpHashQueue &) = delete;
+    JmpHashQueue &operator=(const JmpHashQueue &) = delete;
+
+    ~JmpHashQueue() {
+        if (thread.joinable()) {
+            {
+                std::lock_guard lock(mutex);
+                stopping = true;
+            }
+            work_available.notify_one();
+            thread.join();
+        }
+    }
+
+    /**
+     * @brief Queue `hash->update(bytes, n)`.
+     *
+     */
+    void push(Hash *hash, const uint8_t *bytes, size_t n) {
+        Task task{hash, std::vector<uint8_t>(bytes, bytes + n)};
+        {
+            std::unique_lock lock(mutex);
+            if (!thread.joinable()) {
+                thread = std::thread(&JmpHashQueue::run, this);
+            }
+            work_done.wait(lock, [this] {
+                return queued_bytes == 0 || queued_bytes < JMP_ASYNC_HASH_QUEUE_BYTES;
+            });
+            queued_bytes += n;
+            tasks.push_back(std::move(task));
+        }
+        work_available.notify_one();
+    }
+
+    /**
+     * @brief Wait until every queued update has been applied.
+     *
+     */
+    void drain() {
+        std::unique_lock lock(mutex);
+        work_done.wait(lock, [this] { return tasks.empty() && !busy; });
+    }
+};
+
+}  // namespace orq
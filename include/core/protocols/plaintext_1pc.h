@@ -339,10 +339,10 @@ class Plaintext_1PC : public Protocol<Data, Share, Vector, EVector> {
      * @return First share's vector.
      */
     Vector open_shares_a(const EVector &shares) {
-        assert(!shares.has_mapping());
         op_counter[__func__] += shares.size();
         round_counter[__func__] += 1;
-        return shares(0);
+        // Don't hand back a view aliasing the shares
+        return shares(0).materialize();
     }
 
     /**
@@ -352,10 +352,10 @@ class Plaintext_1PC : public Protocol<Data, Share, Vector, EVector> {
      * @return First share's vector.
      */
     Vector open_shares_b(const EVector &shares) {
-        assert(!shares.has_mapping());
         op_counter[__func__] += shares.size();
         round_counter[__func__] += 1;
-        return shares(0);
+        // Don't hand back a view aliasing the shares
+        return shares(0).materialize();
     }
 
     /**
@@ -432,11 +432,11 @@ class Plaintext_1PC : public Protocol<Data, Share, Vector, EVector> {
      *
      * @param v Input/output vector.
      * @param group Party group.
-     * @param binary Whether shares are binary.
+     * @param num_arithmetic Number of leading arithmetic shares.
      */
-    void reshare(EVector &v, const std::set<int> group, bool binary) {
-        op_counter[__func__] += v.size();
-        round_counter[__func__] += 1;
+    void reshare_mixed(EVector &v, const std::set<int> group, const size_t num_arithmetic) {
+        op_counter["reshare"] += v.size();
+        round_counter["reshare"] += 1;
     }
 };
 
@@ -6,8 +6,11 @@
 #include "profiling/stopwatch.h"
 using namespace orq::benchmarking;
 
+#include <limits>
 #include <numeric>
+#include <optional>
 #include <set>
+#include <span>
 #include <vector>
 
 // Temporary workaround until we make protocol classes templated.
@@ -458,6 +461,9 @@ class ProtocolBase {
  */
 template <typename Data, typename Share, typename Vector, typename EVector>
 class Protocol : public ProtocolBase {
+    // Pool of daBits for this protocol instance; registered with the randomness manager.
+    std::unique_ptr<random::DaBitGenerator<Data>> dabitGenerator;
+
    public:
     // The communicator
     Communicator *communicator;
@@ -478,9 +484,38 @@ class Protocol : public ProtocolBase {
         : ProtocolBase(_partyID, _numParties, _replicationNumber) {
         this->communicator = _communicator;
         this->randomnessManager = _randomnessManager;
+
+        // daBits are generated by (and on the thread of) this protocol instance
+        if (this->randomnessManager != nullptr) {
+            using shares_t = typename random::DaBitGenerator<Data>::shares_t;
+            dabitGenerator = std::make_unique<random::DaBitGenerator<Data>>(
+                _partyID, [this](const size_t &n, shares_t &b, shares_t &a) {
+                    EVector _b(n), _a(n);
+                    generate_dabits(_b, _a);
+
+                    // pack the single-bit boolean shares, one daBit per bit
+                    EVector packed(n / random::DaBitGenerator<Data>::L);
+                    packed.pack_from(_b, 0);
+                    for (int i = 0; i < replicationNumber; i++) {
+                        b.push_back(packed(i));
+                        a.push_back(_a(i));
+                    }
+                });
+            this->randomnessManager
+                ->correlationGenerators[{__typeid(Data), random::Correlation::DaBit}] =
+                dabitGenerator.get();
+        }
+    }
+    /// Destructor; unregisters this instance's daBit generator, which refers to the protocol.
+    virtual ~Protocol() {
+        if (dabitGenerator != nullptr) {
+            auto &generators = this->randomnessManager->correlationGenerators;
+            auto it = generators.find({__typeid(Data), random::Correlation::DaBit});
+            if (it != generators.end() && it->second == dabitGenerator.get()) {
+                generators.erase(it);
+            }
+        }
     }
-    /// Destructor
-    virtual ~Protocol() {}
 
     /**
      * @brief Reshare shares with other parties.
@@ -498,37 +533,24 @@ class Protocol : public ProtocolBase {
      * reshared.
      */
     virtual void reshare(EVector &v, const std::set<int> group, bool binary) {
+        reshare_mixed(v, group, binary ? 0 : v.size());
+    }
+
+    /**
+     * @brief Reshare a vector whose first `num_arithmetic` elements are arithmetic shares and
+     * the rest boolean shares, with a single exchange.
+     *
+     * @param v The EVector representing each party's view of the vector to be reshared.
+     * @param group The group of parties that perform the resharing.
+     * @param num_arithmetic The number of leading arithmetic shares.
+     */
+    virtual void reshare_mixed(EVector &v, const std::set<int> group, const size_t num_arithmetic) {
         auto ra = reshareMap[group];
 
         if (ra.action == ReshareAction::Send) {
             assert(ra.ranks.size() == ra.shareIdx.size());
 
-            {
-                // Scope rand for garbage collection
-                std::vector<Vector> rand;
-                for (int i = 0; i < numParties; i++) {
-                    rand.push_back(Vector(v.size()));
-                }
-
-                // Randomize
-                if (binary) {
-                    this->randomnessManager->zeroSharingGenerator->groupGetNextBinary(rand, group);
-                } else {
-                    this->randomnessManager->zeroSharingGenerator->groupGetNextArithmetic(rand,
-                                                                                          group);
-                }
-
-                auto my_shares = getPartyShareMappings()[partyID];
-                // Generating too many random values here: each party only needs
-                // RepNum random vectors, but is generating PartyNum
-                for (int i = 0; i < replicationNumber; i++) {
-                    if (binary) {
-                        v(i) ^= rand[my_shares[i]];
-                    } else {
-                        v(i) += rand[my_shares[i]];
-                    }
-                }
-            }
+            rerandomize(v, group, num_arithmetic);
 
             for (int i = 0; i < ra.ranks.size(); i++) {
                 this->communicator->sendShares(v(ra.shareIdx[i]), ra.ranks[i], v.size());
@@ -540,6 +562,77 @@ class Protocol : public ProtocolBase {
         }
     }
 
+   protected:
+    /**
+     * @brief Rerandomize this party's shares of `v` with a zero sharing among `group`, before
+     * resharing them.
+     *
+     * @param v The shares; the first `num_arithmetic` are arithmetic, the rest boolean.
+     * @param group The group of parties that perform the resharing.
+     * @param num_arithmetic The number of leading arithmetic shares.
+     */
+    void rerandomize(EVector &v, const std::set<int> &group, const size_t num_arithmetic) {
+        const size_t n = v.size();
+        auto my_shares = getPartyShareMappings()[partyID];
+
+        for (bool binary : {false, true}) {
+            const size_t begin = binary ? num_arithmetic : 0;
+            const size_t end = binary ? n : num_arithmetic;
+            if (begin == end) {
+                continue;
+            }
+
+            // Generating too many random values here: each party only needs
+            // RepNum random vectors, but is generating PartyNum
+            std::vector<Vector> rand;
+            for (int i = 0; i < numParties; i++) {
+                rand.push_back(Vector(end - begin));
+            }
+
+            if (binary) {
+                this->randomnessManager->zeroSharingGenerator->groupGetNextBinary(rand, group);
+            } else {
+                this->randomnessManager->zeroSharingGenerator->groupGetNextArithmetic(rand, group);
+            }
+
+            for (int i = 0; i < replicationNumber; i++) {
+                auto &r = rand[my_shares[i]];
+                if (end - begin == n) {
+                    // the whole vector has one encoding
+                    if (binary) {
+                        v(i) ^= r;
+                    } else {
+                        v(i) += r;
+                    }
+                } else {
+                    auto &x = v(i);
+                    for (size_t j = begin; j < end; j++) {
+                        if (binary) {
+                            x[j] ^= r[j - begin];
+                        } else {
+                            x[j] += r[j - begin];
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+   public:
+    /**
+     * @brief Mask selecting the `bits` least significant bits of a word.
+     *
+     * @param bits
+     * @return Data
+     */
+    static Data low_bits_mask(const int &bits) {
+        using U = std::make_unsigned_t<Data>;
+        if (bits >= std::numeric_limits<U>::digits) {
+            return (Data)~(U)0;
+        }
+        return (Data)(((U)1 << bits) - 1);
+    }
+
     virtual void handle_precision(const EVector &x, const EVector &y, EVector &z) {
         if (x.getPrecision() != y.getPrecision()) {
             throw std::runtime_error("Precision mismatch between multiplication inputs");
@@ -657,6 +750,24 @@ class Protocol : public ProtocolBase {
      */
     virtual void and_b(const EVector &first, const EVector &second, EVector &result) = 0;
 
+    /**
+     * @brief Defines vectorized bitwise AND (&) of the `bits` least significant bits of each
+     * element. The higher bits of the result are cleared. Protocols override this to send only
+     * `bits` bits per element; the default computes the full-width AND and masks it.
+     *
+     * @param first The first shared vector of size S.
+     * @param second The second shared vector of size S.
+     * @param result The output shared vector of size S.
+     * @param bits The number of significant bits per element.
+     */
+    virtual void and_b(const EVector &first, const EVector &second, EVector &result,
+                       const int &bits) {
+        and_b(first, second, result);
+        if (bits < std::numeric_limits<std::make_unsigned_t<Data>>::digits) {
+            result.mask(low_bits_mask(bits));
+        }
+    }
+
     /**
      * @brief Defines vectorized boolean complement (~).
      *
@@ -701,6 +812,140 @@ class Protocol : public ProtocolBase {
      */
     virtual std::pair<EVector, EVector> redistribute_shares_b(const EVector &x) = 0;
 
+    /**
+     * @brief Fill `v` with a sharing of a uniformly random secret, without communication. Each
+     * share is drawn from the PRG common to exactly the parties that hold it (or from the local
+     * PRG, if this is the only party that holds it). The result is valid both as a boolean and as
+     * an arithmetic sharing.
+     *
+     * @param v The output shared vector.
+     */
+    virtual void random_shares(EVector &v) {
+        auto holders = getSharePartyMappings();
+        auto my_shares = getPartyShareMappings()[partyID];
+        for (int i = 0; i < replicationNumber; i++) {
+            auto &h = holders[my_shares[i]];
+            if (h.size() == 1) {
+                this->randomnessManager->localPRG->getNext(v(i));
+            } else {
+                this->randomnessManager->commonPRGManager->get(std::set<int>(h.begin(), h.end()))
+                    ->getNext(v(i));
+            }
+        }
+    }
+
+    /**
+     * @brief Generate daBits, i.e., random bits shared in both domains. The default samples a
+     * random boolean sharing and converts it with `b2a_bit`; protocols may override this with a
+     * dedicated generation protocol.
+     *
+     * @param b The output B-shared vector of single-bit elements.
+     * @param a The output A-shared vector with the same bits as `b`.
+     */
+    virtual void generate_dabits(EVector &b, EVector &a) {
+        random_shares(b);
+        b.mask(1);
+        b2a_bit(b, a);
+    }
+
+    /**
+     * @brief Compose the arithmetic shares of \f$\ell\f$ daBits per element into words over the
+     * whole batch: \f$\sum_j 2^j r_j\f$, or, given public bits `c`, \f$\sum_j 2^j (1 - 2 c_j)
+     * r_j\f$. Each element is a branch-free reduction over contiguous shares, which the compiler
+     * vectorizes.
+     *
+     * @param ra The arithmetic shares of the daBits, \f$\ell\f$ per element.
+     * @param out The output, one word per element.
+     * @param c Optional public bits to flip, one word per element.
+     */
+    static void compose_dabits(const Vector &ra, Vector &out, const Vector *c = nullptr) {
+        using U = std::make_unsigned_t<Data>;
+        constexpr int L = std::numeric_limits<U>::digits;
+        const size_t n = out.size();
+
+        // daBit shares are usually a slice of a pooled chunk; otherwise, gather them first
+        std::vector<std::span<Data>> runs;
+        std::optional<Vector> dense;
+        if (!ra.contiguous_runs(runs, 1)) {
+            dense.emplace(Vector::uninitialized(ra.size()));
+            *dense = ra;
+            dense->contiguous_runs(runs, 1);
+        }
+        const U *bits = (const U *)runs[0].data();
+        auto o = out.batch_span();
+
+        for (size_t k = 0; k < n; k++) {
+            const U *r = bits + k * L;
+            const U flip = c != nullptr ? (U)(*c)[k] : 0;
+            // 2^j (1 - 2 c_j) r_j summed as (all r_j terms) - 2 (the terms with c_j = 1)
+            U all = 0, flipped = 0;
+            for (int j = 0; j < L; j++) {
+                const U t = r[j] << j;
+                all += t;
+                flipped += t & -((flip >> j) & 1);
+            }
+            o[k] = (Data)(all - 2 * flipped);
+        }
+    }
+
+    /**
+     * @brief Full-width boolean-to-arithmetic conversion using \f$\ell\f$ daBits per element. The
+     * input is masked with the daBits and opened in a single round; bit \f$j\f$ of the result
+     * is then \f$c_j \oplus r_j = c_j + r_j - 2 c_j r_j\f$, which is local since \f$c\f$ is
+     * public.
+     *
+     * @param x The input B-shared vector.
+     * @param y The output A-shared vector.
+     */
+    virtual void b2a_dabit(const EVector &x, EVector &y) {
+        using U = std::make_unsigned_t<Data>;
+        const int L = std::numeric_limits<U>::digits;
+        const size_t n = x.size();
+        if (n == 0) {
+            return;
+        }
+        // bit j of element k is daBit k * L + j; the packed boolean word k is the mask r
+        auto [rb, ra] = dabitGenerator->getNext(n * L);
+
+        EVector masked = x ^ EVector(rb);
+        Vector c = open_shares_b(masked);
+
+        // y = c + sum_j 2^j (1 - 2 c_j) r_j
+        EVector sum(n);
+        for (int i = 0; i < replicationNumber; i++) {
+            compose_dabits(ra[i], sum(i), &c);
+        }
+        y = sum + public_share(c);
+    }
+
+    /**
+     * @brief Mask an arithmetic sharing with an edaBit (assembled from \f$\ell\f$ daBits per
+     * element) and open it. Returns boolean sharings of the public value \f$c = x - r\f$ and of
+     * \f$r\f$, whose sum (computed with a boolean adder) is a boolean sharing of `x`. Alternative
+     * to `redistribute_shares_b` which only needs a single opening.
+     *
+     * @param x The input A-shared vector.
+     * @return Pair of boolean shared vectors that add up to `x`.
+     */
+    virtual std::pair<EVector, EVector> edabit_shares_b(const EVector &x) {
+        using U = std::make_unsigned_t<Data>;
+        const int L = std::numeric_limits<U>::digits;
+        const size_t n = x.size();
+        if (n == 0) {
+            return {EVector(0), EVector(0)};
+        }
+        auto [rb, ra] = dabitGenerator->getNext(n * L);
+
+        // r^B is the packed boolean word; r^A = sum_j 2^j r_j
+        EVector r_b(rb), r_a(n);
+        for (int i = 0; i < replicationNumber; i++) {
+            compose_dabits(ra[i], r_a(i));
+        }
+
+        Vector c = open_shares_a(x - r_a);
+        return {public_share(c), r_b};
+    }
+
     // **************************************** //
     //          Reconstruction operations       //
     // **************************************** //
@@ -775,6 +1020,23 @@ class Protocol : public ProtocolBase {
      */
     virtual Vector open_shares_b(const EVector &shares) = 0;
 
+    /**
+     * @brief Opens the `bits` least significant bits of boolean shares. The higher bits of the
+     * output are zero. Protocols override this to send only `bits` bits per element; the default
+     * opens the full words and masks them.
+     *
+     * @param shares A shared vector that contains boolean shares of the secret values.
+     * @param bits The number of significant bits per element.
+     * @return A new vector that contains the plaintext values of type Data.
+     */
+    virtual Vector open_shares_b(const EVector &shares, const int &bits) {
+        Vector opened = open_shares_b(shares);
+        if (bits < std::numeric_limits<std::make_unsigned_t<Data>>::digits) {
+            opened.mask(low_bits_mask(bits));
+        }
+        return opened;
+    }
+
     // **************************************** //
     //        Share generation operations       //
     // **************************************** //
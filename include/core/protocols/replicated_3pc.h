@@ -48,12 +48,8 @@ class Replicated_3PC : public Protocol<Data, Share, Vector, EVector> {
         // TODO (john): Change this so that the generator only gives us the required random numbers
         Vector local(size);
         this->randomnessManager->zeroSharingGenerator->getNextArithmetic(local);
-        // Local computation
-
-        // TODO: same as and, we need a way to figure out this size (or an upper bound)
-        local += x(0) * y(0);
-        local += x(0) * y(1);
-        local += x(1) * y(0);
+        // Local computation, added to the zero share in a single pass
+        local.fma_accumulate(x(0), y(0), x(0), y(1), x(1), y(0));
 
         // Communication round
         Vector remote(size);
@@ -138,15 +134,15 @@ class Replicated_3PC : public Protocol<Data, Share, Vector, EVector> {
         // Number of elements
         const size_t size = x.size();
 
-        // Local computation and aggergation
-        auto local = x(0).dot_product(y(0), aggSize) + x(0).dot_product(y(1), aggSize) +
-                     x(1).dot_product(y(0), aggSize);
-        const size_t newSize = local.size();
+        const size_t aggSize_ = (aggSize == 0) ? size : aggSize;
+        const size_t newSize = div_ceil(size, aggSize_);
 
-        // Generate 'size' random shares of zero
-        Vector r(newSize);
-        this->randomnessManager->zeroSharingGenerator->getNextArithmetic(r);
-        local += r;
+        // Generate 'newSize' random shares of zero
+        Vector local(newSize);
+        this->randomnessManager->zeroSharingGenerator->getNextArithmetic(local);
+
+        // Local computation and aggregation, added to the zero share in a single pass
+        local.dot_product_accumulate(aggSize_, x(0), y(0), x(0), y(1), x(1), y(0));
 
         // Communication round
         Vector remote(newSize);
@@ -171,12 +167,8 @@ class Replicated_3PC : public Protocol<Data, Share, Vector, EVector> {
         // using each seed
         Vector local(size);
         this->randomnessManager->zeroSharingGenerator->getNextBinary(local);
-        // Local computation
-
-        // only access these once
-        local ^= x(0) & y(0);
-        local ^= x(0) & y(1);
-        local ^= x(1) & y(0);
+        // Local computation, XORed into the zero share in a single pass
+        local.xor_and_accumulate(x(0), y(0), x(0), y(1), x(1), y(0));
 
         // Communication round
         Vector remote(size);
@@ -190,6 +182,33 @@ class Replicated_3PC : public Protocol<Data, Share, Vector, EVector> {
         this->handle_precision(x, y, z);
     }
 
+    /**
+     * @brief Secure bitwise AND of the `bits` least significant bits. The zero sharing is
+     * masked to the same bits, so the exchanged shares are bit-packed on the wire.
+     *
+     * @param x First input vector.
+     * @param y Second input vector.
+     * @param z Output vector (higher bits cleared).
+     * @param bits Number of significant bits per element.
+     */
+    void and_b(const EVector &x, const EVector &y, EVector &z, const int &bits) {
+        const Data m = this->low_bits_mask(bits);
+        long long size = x.size();
+        Vector local(size);
+        this->randomnessManager->zeroSharingGenerator->getNextBinary(local);
+
+        local.xor_and_accumulate(x(0), y(0), x(0), y(1), x(1), y(0));
+        local.mask(m);
+
+        Vector remote(size);
+        this->communicator->exchangeShares(local, remote, 2, 1, size, SignificantBits{bits});
+
+        z(0) = local;
+        z(1) = remote;
+
+        this->handle_precision(x, y, z);
+    }
+
     /**
      * @brief Boolean complement operation.
      *
@@ -329,6 +348,22 @@ class Replicated_3PC : public Protocol<Data, Share, Vector, EVector> {
         return shares(0) ^ shares(1) ^ shares_3;
     }
 
+    /**
+     * @brief Open the `bits` least significant bits of boolean shares, sending only those bits.
+     *
+     * @param shares Input shared vector.
+     * @param bits Number of significant bits per element.
+     * @return Opened plaintext vector (higher bits zero).
+     */
+    Vector open_shares_b(const EVector &shares, const int &bits) {
+        size_t size = shares.size();
+        Vector shares_3(size);
+        this->communicator->exchangeShares(shares(1), shares_3, 2, 1, size, SignificantBits{bits});
+        Vector opened = shares(0) ^ shares(1) ^ shares_3;
+        opened.mask(this->low_bits_mask(bits));
+        return opened;
+    }
+
     /**
      * @brief Generate replicated arithmetic shares for a single value.
      *
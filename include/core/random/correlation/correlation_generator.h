@@ -10,6 +10,7 @@ enum class Correlation {
     BeaverAndTriple,
     AuthMulTriple,
     AuthRandom,
+    DaBit,
     ZeroSharing,
     Common,
     ShardedPermutation
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <limits>
+#include <type_traits>
+
+#include "core/containers/e_vector.h"
+#include "correlation_generator.h"
+
+namespace orq::random {
+
+/**
+ * @brief Generator for daBits: random bits \f$r \in \{0, 1\}\f$ which are secret-shared in both
+ * the boolean and the arithmetic domain, \f$([r]^B, [r]^A)\f$.
+ *
+ * Generating daBits requires secure computation, so it is delegated to the protocol which owns
+ * the generator (see `Protocol::generate_dabits`). The generator itself keeps a pool of unused
+ * daBits: `reserve()` fills the pool ahead of time (e.g., before the online phase of a query), and
+ * `getNext()` draws from the pool, generating any missing daBits on demand.
+ *
+ * daBits are handled in words of \f$\ell\f$ (the bitwidth of `T`). The boolean shares are packed,
+ * \f$\ell\f$ daBits per element: bit \f$j\f$ of word \f$k\f$ is daBit \f$k \ell + j\f$, so word
+ * \f$k\f$ is also a boolean sharing of the \f$\ell\f$-bit value with those bits. The arithmetic
+ * shares take one element per daBit. The pool is a queue of the chunks returned by each
+ * generation call; requests within one chunk are served as views, without copying.
+ *
+ * Shares are stored as one Vector per local share (the contents of an EVector), so that the type
+ * of the generator only depends on `T`.
+ *
+ * NOTE: a generator must only be used by the thread that owns its protocol instance, since
+ * generation communicates over that thread's communicator.
+ *
+ * @tparam T The data type of the shares.
+ */
+template <typename T>
+class DaBitGenerator : public CorrelationGenerator {
+   public:
+    /**
+     * @brief The local shares of a vector, one Vector per local share.
+     */
+    using shares_t = std::vector<Vector<T>>;
+
+    /**
+     * @brief Function which generates `n` fresh daBits (a multiple of the bitwidth) into its
+     * (packed boolean, arithmetic) outputs.
+     */
+    using fill_t = std::function<void(const size_t &, shares_t &, shares_t &)>;
+
+    /**
+     * @brief Number of daBits per packed boolean word.
+     */
+    static constexpr size_t L = std::numeric_limits<std::make_unsigned_t<T>>::digits;
+
+   private:
+    fill_t fill;
+
+    /**
+     * @brief The output of one generation call: `words` packed boolean words, and `words * L`
+     * arithmetic shares.
+     */
+    struct Chunk {
+        shares_t b, a;
+        size_t words;
+    };
+
+    // Pooled daBits; words [head, chunks.front().words) of the first chunk are unused.
+    std::deque<Chunk> chunks;
+    size_t head = 0;
+    size_t pooled_words = 0;
+
+    static size_t words_for(const size_t &n) { return (n + L - 1) / L; }
+
+   public:
+    /**
+     * Constructor for the daBit generator.
+     * @param rank The rank of this party.
+     * @param _fill The protocol-specific generation function.
+     */
+    DaBitGenerator(const int &rank, fill_t _fill) : CorrelationGenerator(rank), fill(_fill) {}
+
+    /**
+     * @return The number of pooled (unused) daBits.
+     */
+    size_t available() const { return pooled_words * L; }
+
+    /**
+     * Generate at least `n` daBits (rounded up to whole words) and add them to the pool.
+     * @param n The number of daBits to generate.
+     */
+    void reserve(const size_t &n) {
+        const size_t words = words_for(n);
+        if (words == 0) {
+            return;
+        }
+
+        Chunk c{{}, {}, words};
+        fill(words * L, c.b, c.a);
+        chunks.push_back(std::move(c));
+        pooled_words += words;
+    }
+
+    /**
+     * Get `n` daBits, generating any that are not already pooled. Draws whole words: if `n` is
+     * not a multiple of the bitwidth, the rest of the last word is discarded.
+     * @param n The number of daBits.
+     * @return A pair with the packed boolean shares (`ceil(n / L)` words) and the arithmetic
+     * shares (`ceil(n / L) * L` elements) of the same bits.
+     */
+    std::pair<shares_t, shares_t> getNext(const size_t &n) {
+        const size_t words = words_for(n);
+        if (pooled_words < words) {
+            reserve((words - pooled_words) * L);
+        }
+
+        shares_t b, a;
+        if (words == 0) {
+            return {b, a};
+        }
+
+        // Fast path: the request is within the first chunk, so return views into it.
+        auto &front = chunks.front();
+        if (front.words - head >= words) {
+            for (size_t i = 0; i < front.b.size(); i++) {
+                b.push_back(front.b[i].slice(head, head + words));
+                a.push_back(front.a[i].slice(head * L, (head + words) * L));
+            }
+        } else {
+            // Copy only the requested daBits out of the chunks they span.
+            for (size_t i = 0; i < front.b.size(); i++) {
+                b.emplace_back(words);
+                a.emplace_back(words * L);
+            }
+            size_t offset = 0;
+            size_t h = head;
+            for (auto it = chunks.begin(); offset < words; it++, h = 0) {
+                const size_t m = std::min(words - offset, it->words - h);
+                for (size_t i = 0; i < b.size(); i++) {
+                    b[i].slice(offset, offset + m) = it->b[i].slice(h, h + m);
+                    a[i].slice(offset * L, (offset + m) * L) = it->a[i].slice(h * L, (h + m) * L);
+                }
+                offset += m;
+            }
+        }
+
+        // Release the consumed words.
+        size_t consumed = words;
+        pooled_words -= words;
+        while (consumed > 0) {
+            const size_t m = std::min(consumed, chunks.front().words - head);
+            head += m;
+            consumed -= m;
+            if (head == chunks.front().words) {
+                chunks.pop_front();
+                head = 0;
+            }
+        }
+
+        return {b, a};
+    }
+};
+
+// Template specialization
+template <typename T>
+struct CorrelationEnumType<T, Correlation::DaBit> {
+    using type = DaBitGenerator<T>;
+};
+}  // namespace orq::random
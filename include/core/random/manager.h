@@ -2,6 +2,7 @@
 
 #include <typeindex>
 
+#include "correlation/dabit_generator.h"
 #include "correlation/ole_generator.h"
 #include "correlation/zero_sharing_generator.h"
 #include "prg/common_prg.h"
@@ -99,6 +100,16 @@ class RandomnessManager {
         getCorrelation<T, Correlation::BeaverAndTriple>()->reserve(n);
     }
 
+    /**
+     * Calls the daBit generator's reserve() function.
+     * @tparam T The data type of the daBit shares.
+     * @param n The number of daBits to generate.
+     */
+    template <typename T>
+    void reserve_dabits(size_t n) {
+        getCorrelation<T, Correlation::DaBit>()->reserve(n);
+    }
+
     /**
      * Get a correlation generator for the specified type and correlation.
      * @tparam T The data type for the correlation elements.
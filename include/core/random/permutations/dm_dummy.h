@@ -77,8 +77,8 @@ class DMDummyGenerator : public DMShardedPermutationGenerator<T> {
         // get the size from the existing permutation
         size_t n = dm_perm->size();
 
-        Vector<int> pi_0(n);
-        Vector<int> pi_1(n);
+        Vector<IndexType> pi_0(n);
+        Vector<IndexType> pi_1(n);
 
         // if the permutation has a CommonPRG, use it
         std::shared_ptr<CommonPRG> prg;
@@ -92,12 +92,12 @@ class DMDummyGenerator : public DMShardedPermutationGenerator<T> {
             }
 
             if (DMBase::getRank() == 0) {
-                std::vector<int> random_perm_0(n);
+                std::vector<IndexType> random_perm_0(n);
                 gen_perm(random_perm_0, prg);
                 pi_0 = random_perm_0;
                 comm->exchangeShares(pi_0, pi_1, 1, n);
             } else {
-                std::vector<int> random_perm_1(n);
+                std::vector<IndexType> random_perm_1(n);
                 gen_perm(random_perm_1, prg);
                 pi_1 = random_perm_1;
                 comm->exchangeShares(pi_1, pi_0, 1, n);
@@ -106,11 +106,11 @@ class DMDummyGenerator : public DMShardedPermutationGenerator<T> {
             // use the all_prg to generate without communication
 
             // generate random permutations
-            std::vector<int> random_perm_0(n);
+            std::vector<IndexType> random_perm_0(n);
             gen_perm(random_perm_0, all_prg);
             pi_0 = random_perm_0;
 
-            std::vector<int> random_perm_1(n);
+            std::vector<IndexType> random_perm_1(n);
             gen_perm(random_perm_1, all_prg);
             pi_1 = random_perm_1;
         }
@@ -125,7 +125,8 @@ class DMDummyGenerator : public DMShardedPermutationGenerator<T> {
      * @param pi_0 The permutation of the first party.
      * @param pi_1 The permutation of the second party.
      */
-    void getNextImpl(std::shared_ptr<ShardedPermutation> perm, Vector<int> pi_0, Vector<int> pi_1) {
+    void getNextImpl(std::shared_ptr<ShardedPermutation> perm, Vector<IndexType> pi_0,
+                     Vector<IndexType> pi_1) {
         auto dm_perm = std::static_pointer_cast<DMShardedPermutation<T>>(perm);
         size_t n = dm_perm->size();
 
@@ -127,9 +127,8 @@ class DMPermutationCorrelationGenerator : public DMShardedPermutationGenerator<T
                 oprf->evaluate_plaintext<__int128_t>(hashes_0.as_std_vector(), key);
 
             // permute the hashes
-            std::vector<int> pi_vec(n);
-            gen_perm(pi_vec, prg);
-            Vector<int> pi_0(std::move(pi_vec));
+            auto pi_0 = Vector<IndexType>::uninitialized(n);
+            gen_perm(pi_0, prg);
             orq::operators::local_apply_perm_single_threaded(hashes_1, pi_0);
 
             Vector<__int128_t> B_1 = oprf->evaluate_sender<__int128_t>(key, n);
@@ -145,9 +144,8 @@ class DMPermutationCorrelationGenerator : public DMShardedPermutationGenerator<T
                 oprf->evaluate_plaintext<__int128_t>(hashes_1.as_std_vector(), key);
 
             // permute the hashes
-            std::vector<int> pi_vec(n);
-            gen_perm(pi_vec, prg);
-            Vector<int> pi_1(std::move(pi_vec));
+            auto pi_1 = Vector<IndexType>::uninitialized(n);
+            gen_perm(pi_1, prg);
             orq::operators::local_apply_perm_single_threaded(hashes_0, pi_1);
 
             Vector<__int128_t> C_1 = oprf->evaluate_receiver<__int128_t>(hashes_0);
@@ -7,7 +7,7 @@
 namespace orq::operators {
 
 template <typename Share>
-void local_apply_perm_single_threaded(Vector<Share>& x, Vector<int>& permutation);
+void local_apply_perm_single_threaded(Vector<Share>& x, Vector<IndexType>& permutation);
 
 }
 
@@ -23,10 +23,10 @@ namespace orq::random {
 template <typename T>
 class DMShardedPermutation : public ShardedPermutation {
     // the correlation type
-    using dm_perm_t = std::tuple<Vector<int>, Vector<T>, Vector<T>, Vector<T>>;
+    using dm_perm_t = std::tuple<Vector<IndexType>, Vector<T>, Vector<T>, Vector<T>>;
 
     // the underlying data
-    std::shared_ptr<std::tuple<Vector<int>, Vector<T>, Vector<T>, Vector<T>>> perm;
+    std::shared_ptr<std::tuple<Vector<IndexType>, Vector<T>, Vector<T>, Vector<T>>> perm;
 
     // the type of the permutation (arithmetic or binary)
     orq::Encoding encoding;
@@ -117,7 +117,7 @@ class DMShardedPermutation : public ShardedPermutation {
         auto [pi, A, B, C] = *perm;
 
         // create new copies of each vector
-        Vector<int> pi_copy(pi);
+        Vector<IndexType> pi_copy(pi);
         Vector<T> A_copy(A);
         Vector<T> B_copy(B);
         Vector<T> C_copy(C);
@@ -143,7 +143,7 @@ std::shared_ptr<DMShardedPermutation<T2>> dm_perm_convert_type(
     const auto& perm_tuple = *(perm->getTuple());
     const auto& [pi, A, B, C] = perm_tuple;
 
-    Vector<int> pi_copy = pi;
+    Vector<IndexType> pi_copy = pi;
 
     auto convert = [](const auto& v) {
         const auto& std_v = v.as_std_vector();
@@ -220,7 +220,7 @@ class DMShardedPermutationGenerator : public ShardedPermutationGenerator {
 
    public:
     // permutation correlation type
-    using dm_perm_t = std::tuple<Vector<int>, Vector<T>, Vector<T>, Vector<T>>;
+    using dm_perm_t = std::tuple<Vector<IndexType>, Vector<T>, Vector<T>, Vector<T>>;
 
     /**
      * Constructor for DMShardedPermutationGenerator.
@@ -283,7 +283,7 @@ class DMShardedPermutationGenerator : public ShardedPermutationGenerator {
 
         // declare values
         auto n = perm->size();
-        Vector<int> pi_0(n), pi_1(n);
+        Vector<IndexType> pi_0(n), pi_1(n);
         Vector<T> A_0(n), B_0(n), C_0(n);
         Vector<T> A_1(n), B_1(n), C_1(n);
 
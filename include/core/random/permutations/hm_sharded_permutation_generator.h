@@ -1,6 +1,9 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <bit>
+#include <limits>
 #include <numeric>
 
 #include "../correlation/correlation_generator.h"
@@ -11,7 +14,7 @@ const int random_buffer_size = 65536;
 namespace orq::random {
 
 using Group = std::set<int>;
-using LocalPermutation = std::vector<int>;
+using LocalPermutation = std::vector<IndexType>;
 
 /**
  * Honest Majority Sharded Permutation
@@ -60,14 +63,16 @@ class HMShardedPermutation : public ShardedPermutation {
 };
 
 /**
- * Generate a pseudorandom local permutation. Uses the Fisher-Yates shuffle algorithm: creates a
- * vector `{0, 1, ..., size-1}`, permutes it, and returns.
+ * Fisher-Yates shuffle of `{0, 1, ..., size-1}`, drawing candidate offsets of type `R` from the
+ * generator and rejecting those out of range.
  *
+ * @tparam R Unsigned type of the random draws; must hold `size`.
+ * @tparam Perm Storage type: a `std::vector<IndexType>` or a contiguous `Vector<IndexType>`.
  * @param permutation storage for the permutation.
  * @param generator The common PRG object used as the pseudorandomness source.
- *
  */
-void gen_perm(std::vector<int>& permutation, std::shared_ptr<CommonPRG> generator) {
+template <typename R, typename Perm>
+void gen_perm_with(Perm& permutation, std::shared_ptr<CommonPRG> generator) {
     size_t size = permutation.size();
 
     std::iota(permutation.begin(), permutation.end(), 0);
@@ -77,36 +82,54 @@ void gen_perm(std::vector<int>& permutation, std::shared_ptr<CommonPRG> generato
     // we don't know a priori how many random elements we will need,
     // so we don't want to overshoot by too much
     // however, we also get speed benefits from generating randomness in batches
-    orq::Vector<uint32_t> random(_buffer_size);
+    orq::Vector<R> random(_buffer_size);
     generator->getNext(random);
 
-    int bits = std::bit_width(size);
-    int mask = (1 << bits) - 1;
-
-    int rand_count = 1;
+    // smallest all-ones mask covering [0, size - 1]
+    const int bits = std::bit_width(size);
+    const R mask = bits >= std::numeric_limits<R>::digits ? ~R(0) : (R(1) << bits) - 1;
 
     size_t rand_index = 0;
     for (size_t i = 0; i < size; i++) {
         // get the location to put the ith element
         // generate random int in range [0, n-i-1]
-        uint32_t rand = size;
+        R rand = size;
         while (rand > size - i - 1) {
             rand = random[rand_index] & mask;
             rand_index++;
             if (rand_index == _buffer_size) {
                 // generate new randomness and reset the index
                 generator->getNext(random);
-                // std::cout << std::format("get next {}; size {}\n", rand_count++, size);
                 rand_index = 0;
             }
         }
-        int location = i + rand;
+        size_t location = i + rand;
 
         // swap
         std::swap(permutation[i], permutation[location]);
     }
 }
 
+/**
+ * Generate a pseudorandom local permutation. Uses the Fisher-Yates shuffle algorithm: creates a
+ * vector `{0, 1, ..., size-1}`, permutes it, and returns.
+ *
+ * Draws 32-bit random values unless the permutation has 2^32 elements or more.
+ *
+ * @tparam Perm Storage type: a `std::vector<IndexType>` or a contiguous `Vector<IndexType>`.
+ * @param permutation storage for the permutation.
+ * @param generator The common PRG object used as the pseudorandomness source.
+ *
+ */
+template <typename Perm>
+void gen_perm(Perm& permutation, std::shared_ptr<CommonPRG> generator) {
+    if (permutation.size() < (size_t{1} << 32)) {
+        gen_perm_with<uint32_t>(permutation, generator);
+    } else {
+        gen_perm_with<uint64_t>(permutation, generator);
+    }
+}
+
 /**
  * Honest Majority Sharded Permutation Generator
  *
@@ -131,13 +154,44 @@ class HMShardedPermutationGenerator : public ShardedPermutationGenerator {
           commonPRGManager(std::move(_commonPRGManager)),
           groups(_groups) {}
 
+    /**
+     * Create a generator with its own CommonPRGs, seeded from this generator's CommonPRGs. The
+     * new generator can then be used from another thread without disturbing the order in which
+     * this generator's randomness is consumed.
+     *
+     * All parties must call this at the same point in their execution.
+     * @return The new generator.
+     */
+    std::shared_ptr<HMShardedPermutationGenerator> fork() {
+        int num_parties = 0;
+        for (auto& group : groups) {
+            num_parties = std::max(num_parties, *group.rbegin() + 1);
+        }
+        auto forked_manager = std::make_shared<CommonPRGManager>(num_parties);
+
+        for (auto group : groups) {
+            if (!group.contains(rank)) {
+                continue;
+            }
+            std::array<unsigned char, crypto_aead_aes256gcm_KEYBYTES> seed;
+            commonPRGManager->get(group)->getNext(seed);
+
+            std::vector<unsigned char> seed_vec(seed.begin(), seed.end());
+            auto common_prg = std::make_shared<CommonPRG>(
+                std::make_unique<AESCTRPRGAlgorithm>(seed_vec), rank);
+            forked_manager->add(common_prg, group);
+        }
+
+        return std::make_shared<HMShardedPermutationGenerator>(rank, forked_manager, groups);
+    }
+
     /**
      * Generate a mapping of permutations for the given size.
      * @param n The size of the permutations to generate.
      * @return A set of permutations, one for each group.
      */
     std::shared_ptr<ShardedPermutation> getNext(size_t n) {
-        auto group_permutation_map = std::make_shared<HMShardedPermutation>();
+        auto group_permutation_map = std::make_shared<HMShardedPermutation>(n);
 
         // generate random permutations for each group
         for (auto group : groups) {
@@ -186,7 +240,7 @@ class HMShardedPermutationGenerator : public ShardedPermutationGenerator {
                     continue;
                 }
                 auto common_prg = commonPRGManager->get(group);
-                std::vector<int> local_permutation(perm->size());
+                LocalPermutation local_permutation(perm->size());
                 (*(perm->getPermMap()))[group] = local_permutation;
                 gen_perm((*(perm->getPermMap()))[group], common_prg);
             }
@@ -1,5 +1,11 @@
 #pragma once
 
+#include <condition_variable>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <tuple>
+
 #include "backend/common/runtime.h"
 #include "dm_sharded_permutation_generator.h"
 #include "hm_sharded_permutation_generator.h"
@@ -21,8 +27,8 @@ void setup_dm_pair(std::shared_ptr<ShardedPermutation>& perm1,
     AESPRGAlgorithm::aesKeyGen(std::span<unsigned char>(seed.data(), seed.size()));
 
     // instantiate two AES-based PRG algorithms using the same seed so that parties share randomness
-    auto algo1 = std::make_unique<AESPRGAlgorithm>(seed);
-    auto algo2 = std::make_unique<AESPRGAlgorithm>(seed);
+    auto algo1 = std::make_unique<AESCTRPRGAlgorithm>(seed);
+    auto algo2 = std::make_unique<AESCTRPRGAlgorithm>(seed);
 
     // wrap the algorithms in CommonPRG instances
     auto first_prg = std::make_shared<CommonPRG>(std::move(algo1), -1);
@@ -39,31 +45,175 @@ void setup_dm_pair(std::shared_ptr<ShardedPermutation>& perm1,
 /**
  * @brief Singleton class for managing permutation correlations.
  *
- * Manages queues of individual permutations and pairs of permutations for efficient
+ * Keeps a pool of individual permutations and pairs of permutations, keyed by size, for efficient
  * batch generation and retrieval.
+ *
+ * With honest majority, permutations can also be generated ahead of time by a background thread
+ * (`prefetch`), which uses its own CommonPRGs so that it never races with the online phase. All
+ * parties must make the same sequence of `reserve`, `prefetch`, and `getNext` calls. Which pool a
+ * permutation is taken from only depends on that sequence, not on the background thread's timing:
+ * permutations from `reserve` are used first, then prefetched ones (waiting for them to be ready if
+ * needed), and otherwise a permutation is generated on the spot.
+ *
+ * The sizes requested during a run are recorded, and can be saved with `saveProfile` and then
+ * prefetched in a later run of the same query with `loadProfile`. If the `ORQ_PERMUTATION_PROFILE`
+ * environment variable is set, the manager does this itself: it prefetches the profile
+ * `$ORQ_PERMUTATION_PROFILE.<party>` (if it exists) when it is created, i.e., at the first
+ * permutation request, and overwrites it with the profile of the current run on exit.
  */
 class PermutationManager {
+    using PermPair =
+        std::pair<std::shared_ptr<ShardedPermutation>, std::shared_ptr<ShardedPermutation>>;
+
     // the singleton instance
     static std::shared_ptr<PermutationManager> instance;
 
-    // queue of sharded permutations
-    std::queue<std::shared_ptr<ShardedPermutation>> queue;
+    // sharded permutations generated by `reserve`, keyed by size
+    std::map<size_t, std::queue<std::shared_ptr<ShardedPermutation>>> queues;
 
-    // queue of pairs of sharded permutations (2PC only)
-    std::queue<std::pair<std::shared_ptr<ShardedPermutation>, std::shared_ptr<ShardedPermutation>>>
-        pair_queue;
-
-    // the size of the individual permutations stored in the queue
-    size_t stored_size = 0;
+    // pairs of sharded permutations (2PC only), keyed by size
+    std::map<size_t, std::queue<PermPair>> pair_queues;
 
     // whether we've shown the warning about no permutations in the queue
     bool have_shown_warning = false;
 
+    // Background preprocessing (honest majority only)
+
+    // generator used by the background thread, with its own CommonPRGs
+    std::shared_ptr<HMShardedPermutationGenerator> background_generator;
+    std::thread background_thread;
+    // guards `jobs`, `ready`, and `stopping`
+    std::mutex background_mutex;
+    std::condition_variable jobs_cv;
+    std::condition_variable ready_cv;
+    // pending (size, count) generation jobs, in request order
+    std::queue<std::pair<size_t, size_t>> jobs;
+    // permutations generated by the background thread, keyed by size
+    std::map<size_t, std::queue<std::shared_ptr<ShardedPermutation>>> ready;
+    bool stopping = false;
+    // prefetched permutations not yet retrieved, keyed by size. Only accessed
+    // by the main thread, so it is identical at all parties.
+    std::map<size_t, size_t> scheduled;
+
+    // Size profile: (size, permutations, pairs), in order of first request
+    std::vector<std::tuple<size_t, size_t, size_t>> profile;
+    std::map<size_t, size_t> profile_index;
+    // profile file given by `ORQ_PERMUTATION_PROFILE`, if any, written on destruction
+    std::string profile_path;
+
+    /**
+     * Prefetch the permutations in this party's profile from `ORQ_PERMUTATION_PROFILE`, if set
+     * and the file exists, and remember the path to save this run's profile to.
+     */
+    void loadEnvironmentProfile() {
+        const char* prefix = std::getenv("ORQ_PERMUTATION_PROFILE");
+        if (prefix == nullptr) {
+            return;
+        }
+        profile_path = std::string(prefix) + "." + std::to_string(runTime->getPartyID());
+        if (std::ifstream(profile_path)) {
+            loadProfile(profile_path);
+        }
+    }
+
+    /**
+     * Record a request in the size profile.
+     * @param size_permutation The size of the requested permutation.
+     * @param pair Whether a pair was requested.
+     */
+    void record(size_t size_permutation, bool pair) {
+        auto [it, inserted] = profile_index.insert({size_permutation, profile.size()});
+        if (inserted) {
+            profile.push_back({size_permutation, 0, 0});
+        }
+        auto& [_, num_permutations, num_pairs] = profile[it->second];
+        (pair ? num_pairs : num_permutations)++;
+    }
+
+    /**
+     * Get the number of prefetched permutations of a size which have not been retrieved.
+     * @param size_permutation The size of the permutations.
+     */
+    size_t num_scheduled(size_t size_permutation) {
+        auto it = scheduled.find(size_permutation);
+        return it == scheduled.end() ? 0 : it->second;
+    }
+
+    /**
+     * Retrieve a stored permutation of the given size, if there is one: first from `reserve`,
+     * then from the background thread, blocking until it has been generated.
+     * @param size_permutation The size of the permutation.
+     * @return The permutation, or nullptr if none is stored or scheduled.
+     */
+    std::shared_ptr<ShardedPermutation> take(size_t size_permutation) {
+        auto it = queues.find(size_permutation);
+        if (it != queues.end() && !it->second.empty()) {
+            auto next = it->second.front();
+            it->second.pop();
+            return next;
+        }
+
+        if (num_scheduled(size_permutation) == 0) {
+            return nullptr;
+        }
+        scheduled[size_permutation]--;
+
+        std::unique_lock lock(background_mutex);
+        auto& pool = ready[size_permutation];
+        ready_cv.wait(lock, [&] { return !pool.empty(); });
+        auto next = pool.front();
+        pool.pop();
+        return next;
+    }
+
+    /**
+     * Generate permutations in the background until stopped.
+     */
+    void background_loop() {
+        while (true) {
+            std::pair<size_t, size_t> job;
+            {
+                std::unique_lock lock(background_mutex);
+                jobs_cv.wait(lock, [&] { return stopping || !jobs.empty(); });
+                if (stopping) {
+                    return;
+                }
+                job = jobs.front();
+                jobs.pop();
+            }
+
+            auto [size_permutation, count] = job;
+            for (size_t i = 0; i < count; i++) {
+                auto perm = background_generator->getNext(size_permutation);
+                {
+                    std::lock_guard lock(background_mutex);
+                    ready[size_permutation].push(perm);
+                }
+                ready_cv.notify_all();
+            }
+        }
+    }
+
    public:
     /**
      * Empty constructor for the PermutationManager.
      */
-    PermutationManager() : stored_size(0) {}
+    PermutationManager() {}
+
+    /**
+     * Stops the background thread, if running, and saves the profile given by
+     * `ORQ_PERMUTATION_PROFILE`.
+     */
+    ~PermutationManager() {
+        stopPreprocessing();
+        if (!profile_path.empty()) {
+            try {
+                saveProfile(profile_path);
+            } catch (const std::runtime_error&) {
+                // the profile is only a hint for later runs; don't throw from a destructor
+            }
+        }
+    }
 
     /**
      * Delete assignment operator (singleton pattern).
@@ -77,21 +227,59 @@ class PermutationManager {
     static std::shared_ptr<PermutationManager> get() {
         if (instance == nullptr) {
             instance = std::make_shared<PermutationManager>();
+            instance->loadEnvironmentProfile();
         }
         return instance;
     }
 
     /**
-     * Get the number of sharded permutations in the queue.
-     * @return The number of sharded permutations in the queue.
+     * Get the number of sharded permutations available, including prefetched permutations which
+     * are still being generated.
+     * @return The number of sharded permutations available.
+     */
+    size_t size() {
+        size_t total = 0;
+        for (auto& [_, q] : queues) {
+            total += q.size();
+        }
+        for (auto& [_, count] : scheduled) {
+            total += count;
+        }
+        return total;
+    }
+
+    /**
+     * Get the number of sharded permutations of one size available, including prefetched
+     * permutations which are still being generated.
+     * @param size_permutation The size of the permutations.
+     * @return The number of sharded permutations of that size available.
      */
-    size_t size() { return queue.size(); }
+    size_t size(size_t size_permutation) {
+        auto it = queues.find(size_permutation);
+        return (it == queues.end() ? 0 : it->second.size()) + num_scheduled(size_permutation);
+    }
+
+    /**
+     * Get the number of pairs of sharded permutations of one size in the queue.
+     * @param size_permutation The size of the permutations.
+     * @return The number of pairs of sharded permutations of that size in the queue.
+     */
+    size_t size_pairs(size_t size_permutation) {
+        auto it = pair_queues.find(size_permutation);
+        return it == pair_queues.end() ? 0 : it->second.size();
+    }
 
     /**
      * Get the number of pairs of sharded permutations in the queue.
      * @return The number of pairs of sharded permutations in the queue.
      */
-    size_t size_pairs() { return pair_queue.size(); }
+    size_t size_pairs() {
+        size_t total = 0;
+        for (auto& [_, q] : pair_queues) {
+            total += q.size();
+        }
+        return total;
+    }
 
     /**
      * Reserve a number of sharded permutations in the queue.
@@ -114,35 +302,19 @@ class PermutationManager {
             runTime->rand0()
                 ->getCorrelation<__int128_t, orq::random::Correlation::ShardedPermutation>();
 
-        // if the queue is not empty and the sizes don't match, empty it
-        if (((!queue.empty()) || (!pair_queue.empty())) && (stored_size != size_permutation)) {
-            single_cout("WARNING: Emptying " << queue.size()
-                                             << " stored permutations due to incompatible sizes")
-
-                while (!queue.empty()) {
-                queue.pop();
-            }
-            while (!pair_queue.empty()) {
-                pair_queue.pop();
-            }
-        }
-
-        // set the size of the stored permutations
-        stored_size = size_permutation;
+        auto& queue = queues[size_permutation];
+        auto& pair_queue = pair_queues[size_permutation];
 
-        int rank = runTime->getPartyID();
+        // prefetched permutations count towards the reservation
+        size_t available = queue.size() + num_scheduled(size_permutation);
 
-        if ((num_permutations <= queue.size()) && (num_pairs <= pair_queue.size())) {
+        if ((num_permutations <= available) && (num_pairs <= pair_queue.size())) {
             // we have enough permutations and pairs, so don't do anything
             return;
         } else {
             // only allocate the extra, if needed
-            if (num_permutations > queue.size()) {
-                num_permutations -= queue.size();
-            }
-            if (num_pairs > pair_queue.size()) {
-                num_pairs -= pair_queue.size();
-            }
+            num_permutations -= std::min(num_permutations, available);
+            num_pairs -= std::min(num_pairs, pair_queue.size());
         }
 
         // calculate how many individual permutations to generate
@@ -180,6 +352,109 @@ class PermutationManager {
         }
     }
 
+    /**
+     * Schedule sharded permutations to be generated by the background thread, and return
+     * immediately. Starts the background thread if needed. Like `reserve`, only schedules the
+     * permutations which are not already stored or scheduled.
+     *
+     * Background generation needs honest-majority permutations, which are generated locally.
+     * Otherwise (e.g., 2PC, where generation needs communication), this falls back to a
+     * synchronous `reserve`.
+     *
+     * @param size_permutation The size of each sharded permutation.
+     * @param num_permutations The number of sharded permutations to generate.
+     * @param num_pairs (2PC only) how many pairs of correlated permutations to generate.
+     */
+    void prefetch(size_t size_permutation, size_t num_permutations, size_t num_pairs = 0) {
+        if (runTime->getNumParties() != 2) {
+            num_permutations += num_pairs;
+            num_pairs = 0;
+        }
+
+        if (!background_generator) {
+            auto generator = dynamic_cast<HMShardedPermutationGenerator *>(
+                runTime->rand0()
+                    ->getCorrelation<__int128_t,
+                                     orq::random::Correlation::ShardedPermutation>());
+            if (generator) {
+                background_generator = generator->fork();
+            }
+        }
+
+        if (!background_generator || runTime->getNumParties() == 2) {
+            reserve(size_permutation, num_permutations, num_pairs);
+            return;
+        }
+
+        num_permutations -= std::min(num_permutations, size(size_permutation));
+        if (num_permutations == 0) {
+            return;
+        }
+
+        if (!background_thread.joinable()) {
+            stopping = false;
+            background_thread = std::thread(&PermutationManager::background_loop, this);
+        }
+
+        scheduled[size_permutation] += num_permutations;
+        {
+            std::lock_guard lock(background_mutex);
+            jobs.push({size_permutation, num_permutations});
+        }
+        jobs_cv.notify_one();
+    }
+
+    /**
+     * Stop the background thread after its current permutation. Pending jobs are discarded, so
+     * this must only be called once all prefetched permutations have been retrieved (or when no
+     * more will be requested).
+     */
+    void stopPreprocessing() {
+        if (!background_thread.joinable()) {
+            return;
+        }
+        {
+            std::lock_guard lock(background_mutex);
+            stopping = true;
+        }
+        jobs_cv.notify_one();
+        background_thread.join();
+
+        jobs = {};
+        ready.clear();
+        scheduled.clear();
+    }
+
+    /**
+     * Write the permutation sizes requested so far to a file: one line per size, in order of first
+     * request, holding the size, the number of permutations, and the number of pairs.
+     * @param path The profile file to write.
+     */
+    void saveProfile(const std::string& path) {
+        std::ofstream out(path);
+        if (!out) {
+            throw std::runtime_error("Could not open permutation profile " + path);
+        }
+        for (auto& [size_permutation, num_permutations, num_pairs] : profile) {
+            out << size_permutation << " " << num_permutations << " " << num_pairs << "\n";
+        }
+    }
+
+    /**
+     * Prefetch the permutations listed in a profile written by `saveProfile`.
+     * @param path The profile file to read.
+     */
+    void loadProfile(const std::string& path) {
+        std::ifstream in(path);
+        if (!in) {
+            throw std::runtime_error("Could not open permutation profile " + path);
+        }
+        size_t size_permutation, num_permutations, num_pairs;
+        while (in >> size_permutation >> num_permutations >> num_pairs) {
+            prefetch(size_permutation, num_permutations, num_pairs);
+        }
+    }
+
     /**
      * Get the next sharded permutation in the queue.
      * @param size_permutation The size of the permutation to get.
@@ -194,9 +469,11 @@ class PermutationManager {
             stopwatch::profile_preprocessing();
         }
 
-        std::shared_ptr<ShardedPermutation> next;
+        record(size_permutation, false);
+
+        std::shared_ptr<ShardedPermutation> next = take(size_permutation);
 
-        if (size() == 0) {
+        if (next == nullptr) {
             if (!have_shown_warning) {
                 single_cout("NOTE: no permutations in queue. Recommend calling reserve().");
                 have_shown_warning = true;
@@ -207,17 +484,8 @@ class PermutationManager {
                     ->getCorrelation<__int128_t, orq::random::Correlation::ShardedPermutation>();
 
             next = generator->getNext(size_permutation);
-        } else {
-            // make sure the item retrieved from the queue is of the right size
-            if (size_permutation != stored_size) {
-                single_cout("WARNING: Returning wrong size permutation");
-                reserve(size_permutation, 1, 0);
-            }
-
-            next = queue.front();
-            assert(next->size() == size_permutation);
-            queue.pop();
         }
+        assert(next->size() == size_permutation);
 
         if (runTime->getNumParties() == 2) {
             auto dm_perm = std::dynamic_pointer_cast<DMShardedPermutation<__int128_t>>(next);
@@ -252,10 +520,12 @@ class PermutationManager {
             stopwatch::profile_preprocessing();
         }
 
+        record(size_permutation, true);
+
         // 3PC and 4PC logic (simpler)
         if (runTime->getNumParties() != 2) {
-            std::shared_ptr<ShardedPermutation> perm;
-            if (size() == 0) {
+            std::shared_ptr<ShardedPermutation> perm = take(size_permutation);
+            if (perm == nullptr) {
                 if (!have_shown_warning) {
                     single_cout("NOTE: no permutations in queue. Recommend calling reserve().");
                     have_shown_warning = true;
@@ -267,16 +537,8 @@ class PermutationManager {
                                          orq::random::Correlation::ShardedPermutation>();
 
                 perm = generator->getNext(size_permutation);
-            } else {
-                // make sure the item retrieved from the queue is of the right size
-                if (size_permutation != stored_size) {
-                    single_cout("WARNING: Returning wrong size permutation");
-                }
-
-                perm = queue.front();
-                assert(perm->size() == size_permutation);
-                queue.pop();
             }
+            assert(perm->size() == size_permutation);
 
             // create a deep copy for the second element
             auto copy = perm->clone();
@@ -285,7 +547,8 @@ class PermutationManager {
 
         // 2PC logic below here
 
-        if (size_pairs() == 0) {
+        auto& pair_queue = pair_queues[size_permutation];
+        if (pair_queue.empty()) {
             if (!have_shown_warning) {
                 single_cout("NOTE: no permutations in queue. Recommend calling reserve().");
                 have_shown_warning = true;
@@ -5,14 +5,22 @@
 
 using namespace orq::benchmarking;
 
+#include <condition_variable>
 #include <deque>
+#include <mutex>
+#include <thread>
 
 namespace orq::random {
 
 /**
  * @brief A wrapper that pools correlations from another generator.
  *
- * Manages a queue of pre-generated correlations for efficient batch processing.
+ * Manages a pool of pre-generated correlations for efficient batch processing. The pool is a
+ * queue of chunks, one per generated batch, so adding a batch copies nothing. A request that fits
+ * in the head chunk is served as a slice of it, without copying; only a request that straddles
+ * chunks is copied, and then only its own elements. A slice handed out keeps its chunk (not the
+ * whole pool) alive. The pool can optionally be refilled from a background thread (see
+ * `startBackgroundRefill`).
  *
  * Includes a compile-time check that the template parameter is a derived class
  *  of CorrelationGenerator.
@@ -23,120 +31,149 @@ namespace orq::random {
 template <typename Generator, typename... Ts>
     requires std::derived_from<Generator, CorrelationGenerator>
 class PooledGenerator : public CorrelationGenerator {
+    using chunk_t = std::tuple<Vector<Ts>...>;
+
     std::shared_ptr<Generator> generator;
 
-    // the main pool of generated randomness
-    std::tuple<std::deque<Ts>...> queueTuple;
+    // the pool of generated randomness: one chunk per generated batch, with
+    // one contiguous vector per component. The first `head` elements of the
+    // front chunk have already been handed out.
+    std::deque<chunk_t> chunks;
+    size_t head = 0;
+
+    // number of elements in the pool
+    size_t pooled = 0;
+
+    // background refill state. Refills are scheduled by the caller's thread
+    // only, based on `pooled + pending`, so every party generates the same
+    // batches in the same order.
+    std::thread worker;
+    mutable std::mutex mutex;
+    std::condition_variable work_cv;
+    std::condition_variable ready_cv;
+    std::deque<size_t> jobs;
+    size_t pending = 0;
+    bool stopping = false;
+
+    size_t low_watermark = 0;
+    size_t refill_size = 0;
 
     /**
-     * Private implementation method for adding a generated batch to the object's
-     * queue.
-     * @param batch The generated batch of randomness.
+     * Make each vector of a chunk contiguous, so that requests can be served as slices of it.
+     * @param chunk The chunk.
      * @tparam I Index sequence.
      */
     template <std::size_t... I>
-    void addToQueueImpl(std::tuple<Vector<Ts>...>& batch, std::index_sequence<I...>) {
-        // use fold expression to iterate and add each vector to its corresponding queue
-        ((std::get<I>(queueTuple)
-              .insert(std::get<I>(queueTuple).end(), std::get<I>(batch).begin(),
-                      std::get<I>(batch).end()),
-          void()),
-         ...);
+    static void materialize(chunk_t& chunk, std::index_sequence<I...>) {
+        ((std::get<I>(chunk).materialize_inplace(), void()), ...);
     }
 
     /**
-     * Private implementation method for adding a generated batch to the object's
-     * queue.
-     * @param batch The generated batch of randomness.
-     * @tparam I Index sequence.
+     * Private method to add a generated batch to the pool as a new chunk. The caller must hold
+     * `mutex` if the worker is running.
+     * @param chunk The generated batch of randomness, as `Vector`s (which are moved, not copied).
      */
-    template <std::size_t... I>
-    void addToQueueImpl(std::tuple<std::vector<Ts>...>& batch, std::index_sequence<I...>) {
-        // use fold expression to iterate and add each vector to its corresponding queue
-        ((std::get<I>(queueTuple)
-              .insert(std::get<I>(queueTuple).end(), std::get<I>(batch).begin(),
-                      std::get<I>(batch).end()),
-          void()),
-         ...);
+    void addToPool(chunk_t&& chunk) {
+        const size_t n = std::get<0>(chunk).size();
+        if (n == 0) {
+            return;
+        }
+        materialize(chunk, std::make_index_sequence<sizeof...(Ts)>{});
+        chunks.push_back(std::move(chunk));
+        pooled += n;
     }
 
     /**
-     * Private method to allow reserve() to add randomness to the pool.
-     * @param batch The generated batch of randomness.
+     * Private implementation function to get the next elements from the pool. A request that fits
+     * in the front chunk is a slice of it; a request that straddles chunks is copied into a new
+     * vector per component. The caller must hold `mutex` if the worker is running.
+     * @param count The number of elements to get.
+     * @tparam I Index sequence.
+     * @return A tuple of vectors containing the extracted elements.
      */
-    void addToQueue(std::tuple<Vector<Ts>...>& batch) {
-        addToQueueImpl(batch, std::make_index_sequence<sizeof...(Ts)>{});
-    }
+    template <std::size_t... I>
+    chunk_t getNextImpl(std::size_t count, std::index_sequence<I...>) {
+        assert(count <= pooled);
+        if (count == 0) {
+            return chunk_t{Vector<Ts>(0)...};
+        }
+        pooled -= count;
+
+        // advance past `n` elements of the front chunk
+        auto consume = [&](const size_t n) {
+            head += n;
+            if (head == std::get<0>(chunks.front()).size()) {
+                chunks.pop_front();
+                head = 0;
+            }
+        };
 
-    /**
-     * Private method to allow reserve() to add randomness to the pool.
-     * @param batch The generated batch of randomness.
-     */
-    void addToQueue(std::tuple<std::vector<Ts>...>& batch) {
-        addToQueueImpl(batch, std::make_index_sequence<sizeof...(Ts)>{});
+        if (count <= std::get<0>(chunks.front()).size() - head) {
+            chunk_t result{std::get<I>(chunks.front()).slice(head, head + count)...};
+            consume(count);
+            return result;
+        }
+
+        chunk_t result{Vector<Ts>(count)...};
+        size_t copied = 0;
+        while (copied < count) {
+            auto& chunk = chunks.front();
+            const size_t n = std::min(count - copied, std::get<0>(chunk).size() - head);
+            ((std::get<I>(result).slice(copied, copied + n) =
+                  std::get<I>(chunk).slice(head, head + n),
+              void()),
+             ...);
+            copied += n;
+            consume(n);
+        }
+        return result;
     }
 
     /**
-     * Private helper function to get elements from a specific deque in the tuple
-     * of deques.
-     * @param count The number of elements to extract.
-     * @return A vector containing the extracted elements.
+     * Background thread: generate scheduled batches in order.
      */
-    template <std::size_t I, template <typename...> class VectorType = Vector>
-    VectorType<typename std::tuple_element<I, std::tuple<Ts...>>::type> extractElements(
-        std::size_t count) {
-        using ElementType = typename std::tuple_element<I, std::tuple<Ts...>>::type;
-        std::vector<ElementType> result(count);
-
-        auto& deque = std::get<I>(queueTuple);
-
-        // insert the range of elements from deque to result vector
-        std::copy(deque.begin(), deque.begin() + count, result.begin());
-
-        // remove the extracted elements from the deque
-        deque.erase(deque.begin(), deque.begin() + count);
-
-        if constexpr (std::is_same_v<VectorType<ElementType>, Vector<ElementType>>) {
-            // convert to orq::Vector
-            return Vector(result);
-        } else {
-            // return as std::vector
-            return result;
+    void refillLoop() {
+        std::unique_lock lock(mutex);
+        while (true) {
+            work_cv.wait(lock, [&] { return stopping || !jobs.empty(); });
+            if (stopping) {
+                return;
+            }
+            size_t n = jobs.front();
+
+            // generate without holding the lock, so the caller can keep
+            // taking elements from the pool meanwhile
+            lock.unlock();
+            auto batch = generator->getNext(n);
+            lock.lock();
+
+            jobs.pop_front();
+            addToPool(std::move(batch));
+            pending -= n;
+            ready_cv.notify_all();
         }
     }
 
     /**
-     * Private implementation function to get the next elements from the pool.
-     * @param count The number of elements to get.
-     * @tparam I Index sequence.
-     * @return A tuple of vectors containing the extracted elements.
+     * Wait until the worker has finished all scheduled batches, so the
+     * caller can use the underlying generator directly.
+     * @param lock A lock on `mutex`.
      */
-    template <std::size_t... I, template <typename...> class VectorType = Vector>
-    std::tuple<VectorType<Ts>...> getNextImpl(std::size_t count, std::index_sequence<I...>) {
-        // create a tuple of vectors for the result
-        return std::make_tuple(
-            extractElements<I, VectorType>(count)...  // extract elements from each deque
-        );
+    void drain(std::unique_lock<std::mutex>& lock) {
+        ready_cv.wait(lock, [&] { return jobs.empty(); });
     }
 
     /**
-     * Private implementation function to get the size of the pool.
-     * @tparam I Index sequence.
-     * @return The number of elements in the pool.
+     * Schedule a background refill if the pool (including scheduled batches)
+     * is below the low watermark.
      */
-    template <std::size_t... I>
-    std::size_t sizeImpl(std::index_sequence<I...>) const {
-        std::size_t sizes[] = {std::get<I>(queueTuple).size()...};
-        std::size_t first_size = sizes[0];
-
-        // check that all sizes are the same
-        for (std::size_t size : sizes) {
-            if (size != first_size) {
-                throw std::runtime_error("Queue sizes do not match");
-            }
+    void maybeRefill() {
+        if (refill_size == 0 || pooled + pending >= low_watermark) {
+            return;
         }
-
-        return first_size;
+        jobs.push_back(refill_size);
+        pending += refill_size;
+        work_cv.notify_one();
     }
 
    public:
@@ -147,13 +184,63 @@ class PooledGenerator : public CorrelationGenerator {
     PooledGenerator(std::shared_ptr<Generator> _generator)
         : CorrelationGenerator(_generator->getRank()), generator(_generator) {}
 
+    ~PooledGenerator() { stopBackgroundRefill(); }
+
     /**
      * Generate and store correlations for later use.
      * @param count The number of correlations to generate and store.
      */
     void reserve(size_t count) {
-        auto batch = generator->getNext(count);
-        addToQueue(batch);
+        std::unique_lock lock(mutex);
+        drain(lock);
+        addToPool(generator->getNext(count));
+    }
+
+    /**
+     * Keep the pool topped up from a background thread. Whenever a request
+     * leaves fewer than `_low_watermark` correlations (counting batches
+     * already scheduled), another `_refill_size` are generated in the
+     * background.
+     *
+     * The underlying generator is only ever used by one thread at a time:
+     * synchronous generation waits for scheduled batches to finish first.
+     * The pool must be the generator's only owner, since a refill runs the
+     * generator's protocol (over its own channel, e.g. a libOTe socket) while
+     * the caller's thread keeps communicating; the generator's communicator
+     * is only used by `assertCorrelated`, from the caller's thread.
+     *
+     * @param _low_watermark Refill when the pool drops below this size.
+     * @param _refill_size The number of correlations to generate per refill.
+     */
+    void startBackgroundRefill(size_t _low_watermark, size_t _refill_size) {
+        assert(generator.use_count() == 1 &&
+               "background refill needs exclusive use of the underlying generator");
+        stopBackgroundRefill();
+
+        std::unique_lock lock(mutex);
+        low_watermark = _low_watermark;
+        refill_size = _refill_size;
+        stopping = false;
+        worker = std::thread(&PooledGenerator::refillLoop, this);
+        maybeRefill();
+    }
+
+    /**
+     * Stop the background thread once all scheduled batches are in the pool.
+     */
+    void stopBackgroundRefill() {
+        if (!worker.joinable()) {
+            return;
+        }
+        {
+            std::unique_lock lock(mutex);
+            // finish scheduled batches, so the parties stay in step
+            drain(lock);
+            stopping = true;
+            refill_size = 0;
+        }
+        work_cv.notify_all();
+        worker.join();
     }
 
     /**
@@ -161,8 +248,8 @@ class PooledGenerator : public CorrelationGenerator {
      * @return The number of correlations currently in the pool.
      */
     std::size_t size() const {
-        // use a helper function with index sequence internally
-        return sizeImpl(std::make_index_sequence<sizeof...(Ts)>{});
+        std::unique_lock lock(mutex);
+        return pooled;
     }
 
     /**
@@ -179,16 +266,23 @@ class PooledGenerator : public CorrelationGenerator {
      * @param count The number of elements to get.
      * @return A tuple of vectors containing the requested correlations.
      */
-    auto getNext(size_t count) {
-        size_t currentSize = size();
-
-        // if not enought elements, generate more
-        if (currentSize < count) {
-            return generator->getNext(count);
+    chunk_t getNext(size_t count) {
+        std::unique_lock lock(mutex);
+
+        // if not enough elements (even after scheduled refills), generate more
+        if (pooled + pending < count) {
+            drain(lock);
+            auto batch = generator->getNext(count);
+            maybeRefill();
+            return batch;
         }
 
+        ready_cv.wait(lock, [&] { return pooled >= count; });
+
         // call a helper function to actually get the elements
-        return getNextImpl(count, std::make_index_sequence<sizeof...(Ts)>{});
+        auto result = getNextImpl(count, std::make_index_sequence<sizeof...(Ts)>{});
+        maybeRefill();
+        return result;
     }
 };
 
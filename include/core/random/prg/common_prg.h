@@ -36,7 +36,7 @@ class CommonPRG : public CorrelationGenerator {
     CommonPRG(int rank) : CorrelationGenerator(rank) {
         std::vector<unsigned char> seed(crypto_aead_aes256gcm_KEYBYTES);
         AESPRGAlgorithm::aesKeyGen(seed);
-        prg_algorithm = std::make_unique<AESPRGAlgorithm>(seed);
+        prg_algorithm = std::make_unique<AESCTRPRGAlgorithm>(seed);
     }
 
     /**
@@ -11,6 +11,12 @@
 #include <span>
 #include <vector>
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <smmintrin.h>
+#include <wmmintrin.h>
+#define __ORQ_AESNI_SUPPORTED
+#endif
+
 #define __DEFAULT_PRGALGORITHM_BUFFER_SIZE (1 << 20)
 #define __MAX_AES_QUERY_BYTES (1 << 20)
 #define __MAX_DEV_URANDOM_QUERY_BYTES (1 << 20)
@@ -46,14 +52,24 @@ class PRGAlgorithm {
     /**
      * Fills nums with random data.
      *
-     * This function creates a buffer to hold the random values before copying
-     * them to the Vector.
+     * If the Vector has no mapping, its current batch is contiguous in memory
+     * and is filled in place. Otherwise, this function creates a buffer to hold
+     * the random values before copying them to the Vector.
      *
      * @tparam T The data type for the vector elements.
      * @param nums The vector to fill with random data.
      */
     template <typename T>
     void getNext(Vector<T>& nums) {
+        if (!nums.has_mapping()) {
+            // NOTE: the buffered path fills in chunks of the preferred buffer
+            // size, which is a multiple of sizeof(T), so the generated stream
+            // is identical either way.
+            auto batch = nums.batch_span();
+            fillBytes(std::span<uint8_t>(reinterpret_cast<uint8_t*>(batch.data()),
+                                         batch.size() * sizeof(T)));
+            return;
+        }
         size_t preferred_size = getPreferredBufferSize();
         if (thread_buffer.size() < preferred_size) {
             thread_buffer.resize(preferred_size);
@@ -199,7 +215,6 @@ class AESPRGAlgorithm : public DeterministicPRGAlgorithm {
    protected:
     size_t getPreferredBufferSize() override { return __MAX_AES_QUERY_BYTES; }
 
-   private:
     // the seed shared between the parties
     unsigned char seed[crypto_aead_aes256gcm_KEYBYTES] = {};
 
@@ -211,7 +226,7 @@ class AESPRGAlgorithm : public DeterministicPRGAlgorithm {
      * Generate random bytes using AES-256-GCM.
      * @param dest The span to fill with random bytes.
      */
-    void aesGenerateValues(std::span<uint8_t> dest) {
+    virtual void aesGenerateValues(std::span<uint8_t> dest) {
         // get the nonce as a char array
         unsigned char nonce_char[crypto_aead_aes256gcm_NPUBBYTES];
         unsigned long nonce_temp = nonce;
@@ -231,6 +246,199 @@ class AESPRGAlgorithm : public DeterministicPRGAlgorithm {
     }
 };
 
+/**
+ * @brief AES-NI counter-mode deterministic PRG implementation.
+ *
+ * Produces exactly the same stream as AESPRGAlgorithm: with a zero plaintext,
+ * AES-256-GCM outputs the CTR keystream \f$AES_k(nonce \| ctr)\f$, with a
+ * 96-bit nonce and a 32-bit big-endian counter starting at 2. This class
+ * computes that keystream directly with AES-NI, eight blocks at a time, and
+ * writes it straight into the destination. Unlike libsodium, it skips the GHASH
+ * tag (which is discarded anyway) and never reads a zero plaintext buffer.
+ *
+ * Since the streams are identical, parties may mix this and AESPRGAlgorithm.
+ * If the CPU does not support AES-NI, generation falls back to libsodium.
+ */
+class AESCTRPRGAlgorithm : public AESPRGAlgorithm {
+   public:
+    /**
+     * Creates an AESCTRPRGAlgorithm object.
+     *
+     * @param _seed The seed shared between the parties.
+     */
+    AESCTRPRGAlgorithm(std::vector<unsigned char>& _seed) : AESPRGAlgorithm(_seed) {
+        expandKey();
+    }
+
+    /**
+     * Set the AES key from seed bytes, and expand the key schedule.
+     * @param _seed The seed bytes to use as AES key.
+     */
+    void setSeed(std::vector<unsigned char>& _seed) override {
+        AESPRGAlgorithm::setSeed(_seed);
+        expandKey();
+    }
+
+    /**
+     * @return true if this CPU supports the AES-NI instructions used here.
+     */
+    static bool hardwareSupported() {
+#ifdef __ORQ_AESNI_SUPPORTED
+        static const bool supported =
+            __builtin_cpu_supports("aes") && __builtin_cpu_supports("sse4.1");
+        return supported;
+#else
+        return false;
+#endif
+    }
+
+   protected:
+    /**
+     * Generate the AES-256-GCM keystream for the current nonce.
+     * @param dest The span to fill with random bytes.
+     */
+    void aesGenerateValues(std::span<uint8_t> dest) override {
+#ifdef __ORQ_AESNI_SUPPORTED
+        if (hardwareSupported()) {
+            ctrGenerateValues(dest);
+            nonce++;
+            return;
+        }
+#endif
+        AESPRGAlgorithm::aesGenerateValues(dest);
+    }
+
+   private:
+    static const int AES_ROUNDS = 14;
+    // number of independent blocks in flight; hides the latency of aesenc
+    static const int PIPELINE_BLOCKS = 8;
+    // GCM uses counter 1 for the tag; the keystream starts at 2
+    static const uint32_t FIRST_COUNTER = 2;
+
+    // AES-256 round keys
+    alignas(16) uint8_t round_keys[(AES_ROUNDS + 1) * 16] = {};
+
+#ifdef __ORQ_AESNI_SUPPORTED
+    /**
+     * One step of the AES-256 key expansion (Intel AES-NI white paper).
+     * Computes the next even round key in `a` and, unless `LAST`, the next odd
+     * round key in `b`.
+     */
+    template <int RCON, bool LAST = false>
+    __attribute__((target("aes,sse4.1"))) static void expandStep(__m128i& a, __m128i& b) {
+        __m128i t = _mm_shuffle_epi32(_mm_aeskeygenassist_si128(b, RCON), 0xff);
+        a = _mm_xor_si128(a, _mm_slli_si128(a, 4));
+        a = _mm_xor_si128(a, _mm_slli_si128(a, 4));
+        a = _mm_xor_si128(a, _mm_slli_si128(a, 4));
+        a = _mm_xor_si128(a, t);
+        if constexpr (!LAST) {
+            t = _mm_shuffle_epi32(_mm_aeskeygenassist_si128(a, 0), 0xaa);
+            b = _mm_xor_si128(b, _mm_slli_si128(b, 4));
+            b = _mm_xor_si128(b, _mm_slli_si128(b, 4));
+            b = _mm_xor_si128(b, _mm_slli_si128(b, 4));
+            b = _mm_xor_si128(b, t);
+        }
+    }
+
+    /**
+     * Counter block: the 96-bit little-endian nonce in `base`, then a 32-bit
+     * big-endian counter in the last four bytes (i.e., dword 3, byte swapped).
+     */
+    __attribute__((target("aes,sse4.1"))) static __m128i counterBlock(const __m128i& base,
+                                                                      const uint32_t& ctr) {
+        return _mm_insert_epi32(base, static_cast<int>(__builtin_bswap32(ctr)), 3);
+    }
+
+    __attribute__((target("aes,sse4.1"))) void expandKeyAESNI() {
+        __m128i* rk = reinterpret_cast<__m128i*>(round_keys);
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(seed));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(seed + 16));
+        rk[0] = a;
+        rk[1] = b;
+        expandStep<0x01>(a, b);
+        rk[2] = a;
+        rk[3] = b;
+        expandStep<0x02>(a, b);
+        rk[4] = a;
+        rk[5] = b;
+        expandStep<0x04>(a, b);
+        rk[6] = a;
+        rk[7] = b;
+        expandStep<0x08>(a, b);
+        rk[8] = a;
+        rk[9] = b;
+        expandStep<0x10>(a, b);
+        rk[10] = a;
+        rk[11] = b;
+        expandStep<0x20>(a, b);
+        rk[12] = a;
+        rk[13] = b;
+        expandStep<0x40, true>(a, b);
+        rk[14] = a;
+    }
+
+    /**
+     * Fill `dest` with the keystream for the current nonce.
+     * @param dest The span to fill. At most 2^32 - 2 blocks.
+     */
+    __attribute__((target("aes,sse4.1"))) void ctrGenerateValues(std::span<uint8_t> dest) {
+        const __m128i* rk = reinterpret_cast<const __m128i*>(round_keys);
+
+        const __m128i base = _mm_set_epi64x(0, static_cast<int64_t>(nonce));
+
+        const size_t full_blocks = dest.size() / 16;
+        uint8_t* out = dest.data();
+        uint32_t ctr = FIRST_COUNTER;
+        size_t blk = 0;
+
+        for (; blk + PIPELINE_BLOCKS <= full_blocks; blk += PIPELINE_BLOCKS) {
+            __m128i x[PIPELINE_BLOCKS];
+            for (int j = 0; j < PIPELINE_BLOCKS; j++) {
+                x[j] = _mm_xor_si128(counterBlock(base, ctr++), rk[0]);
+            }
+            for (int r = 1; r < AES_ROUNDS; r++) {
+                for (int j = 0; j < PIPELINE_BLOCKS; j++) {
+                    x[j] = _mm_aesenc_si128(x[j], rk[r]);
+                }
+            }
+            for (int j = 0; j < PIPELINE_BLOCKS; j++) {
+                x[j] = _mm_aesenclast_si128(x[j], rk[AES_ROUNDS]);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + (blk + j) * 16), x[j]);
+            }
+        }
+
+        // Remaining blocks, including a final partial block
+        for (; blk * 16 < dest.size(); blk++) {
+            __m128i x = _mm_xor_si128(counterBlock(base, ctr++), rk[0]);
+            for (int r = 1; r < AES_ROUNDS; r++) {
+                x = _mm_aesenc_si128(x, rk[r]);
+            }
+            x = _mm_aesenclast_si128(x, rk[AES_ROUNDS]);
+
+            const size_t bytes = std::min<size_t>(16, dest.size() - blk * 16);
+            if (bytes == 16) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + blk * 16), x);
+            } else {
+                alignas(16) uint8_t tail[16];
+                _mm_store_si128(reinterpret_cast<__m128i*>(tail), x);
+                std::memcpy(out + blk * 16, tail, bytes);
+            }
+        }
+    }
+#endif
+
+    /**
+     * Expand the current seed into the round keys, if AES-NI is available.
+     */
+    void expandKey() {
+#ifdef __ORQ_AESNI_SUPPORTED
+        if (hardwareSupported()) {
+            expandKeyAESNI();
+        }
+#endif
+    }
+};
+
 /**
  * @brief PRG implementation using /dev/urandom.
  *
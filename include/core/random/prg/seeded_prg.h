@@ -41,7 +41,7 @@ class PseudoRandomGenerator : public RandomGenerator {
         std::cout << "Random seed: " << debug::container2str(seed_vec) << "\n";
 
         std::unique_ptr<DeterministicPRGAlgorithm> prg_algorithm =
-            std::make_unique<orq::random::AESPRGAlgorithm>(seed_vec);
+            std::make_unique<orq::random::AESCTRPRGAlgorithm>(seed_vec);
         cprg = std::make_unique<CommonPRG>(std::move(prg_algorithm), 0);
     }
 
@@ -52,7 +52,7 @@ class PseudoRandomGenerator : public RandomGenerator {
     PseudoRandomGenerator(std::vector<unsigned char> _seed) : RandomGenerator() {
         std::cout << "Fixed seed: " << debug::container2str(_seed) << "\n";
         std::unique_ptr<DeterministicPRGAlgorithm> prg_algorithm =
-            std::make_unique<orq::random::AESPRGAlgorithm>(_seed);
+            std::make_unique<orq::random::AESCTRPRGAlgorithm>(_seed);
         cprg = std::make_unique<CommonPRG>(std::move(prg_algorithm), 0);
     }
 
@@ -21,6 +21,7 @@
 
 #define MPI_COMMUNICATOR 1
 #define NOCOPY_COMMUNICATOR 4
+#define SHM_COMMUNICATOR 5
 
 /**
  * @brief The default communicator
@@ -39,6 +40,8 @@
 #define MPC_USE_MPI_COMMUNICATOR 1
 #elif COMMUNICATOR_NUM == NOCOPY_COMMUNICATOR
 #define MPC_USE_NO_COPY_COMMUNICATOR 1
+#elif COMMUNICATOR_NUM == SHM_COMMUNICATOR
+#define MPC_USE_SHM_COMMUNICATOR 1
 #endif
 #endif
 
@@ -53,16 +56,36 @@
 #define SOCKET_COMMUNICATOR_BUFFER_SIZE 65536UL  // bytes
 #define SOCKET_COMMUNICATOR_WAIT_MS 10
 
+/**
+ * @brief Mapped Vectors whose runs of consecutive storage average fewer elements than this are
+ * packed before sending (and unpacked after receiving); longer runs are sent and received in place
+ *
+ */
+#define COMMUNICATOR_MIN_RUN_ELEMENTS 64
+
 /**
  * @brief Current communicaton API only uses 1 ring element, ring_size can be changed later if
  * needed
  *
  */
 #define NOCOPY_COMMUNICATOR_RING_SIZE 16UL
+#define NOCOPY_COMMUNICATOR_MAX_IOV 16  // Ring entries gathered into a single sendmsg
+#define NOCOPY_COMMUNICATOR_PACK_BYTES (1UL << 18)  // Chunk size when packing mapped Vectors
 #ifndef NOCOPY_COMMUNICATOR_THREADS
 #define NOCOPY_COMMUNICATOR_THREADS -1  // Set to '-1' to use 1 comm thread per ORQ thread
 #endif
 
+/**
+ * @brief Shared-memory communicator: bytes per ring (one ring per ordered party
+ * pair and thread; must be a power of two), busy-poll iterations before
+ * sleeping, futex sleep bound, and how long to wait for peers at startup
+ *
+ */
+#define SHM_COMMUNICATOR_RING_BYTES (1UL << 22)
+#define SHM_COMMUNICATOR_SPIN 4096
+#define SHM_COMMUNICATOR_WAIT_US 1000
+#define SHM_COMMUNICATOR_CONNECT_S 60
+
 #define MPC_GENERATE_DATA 1
 #define MPC_RANDOM_DATA_RANGE 100
 #define MPC_USE_RANDOM_GENERATOR_DATA 1
@@ -153,6 +176,8 @@
 #define SERVICE_NAMESPACE orq::service::mpi_service
 #elif MPC_USE_NO_COPY_COMMUNICATOR
 #define SERVICE_NAMESPACE orq::service::nocopy_service
+#elif MPC_USE_SHM_COMMUNICATOR
+#define SERVICE_NAMESPACE orq::service::shm_service
 #endif
 
 #if PROTOCOL_NUM == FANTASTIC4
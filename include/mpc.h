@@ -13,6 +13,8 @@
 #include "core/communication/no_copy_communicator/no_copy_communicator.h"
 #include "core/communication/no_copy_communicator/no_copy_communicator_factory.h"
 #include "core/communication/null_communicator.h"
+#include "core/communication/shm_communicator/shm_communicator.h"
+#include "core/communication/shm_communicator/shm_communicator_factory.h"
 
 // Core - Random
 #include "core/random/correlation/dummy_auth_random_generator.h"
@@ -56,11 +58,13 @@
 #include "core/containers/a_shared_vector.h"
 #include "core/containers/b_shared_vector.h"
 #include "core/containers/encoded_vector.h"
+#include "core/containers/packed_b_shared_vector.h"
 #include "core/containers/permutation.h"
 #include "core/containers/shared_vector.h"
 
 // Tabular
 #include "core/containers/tabular/encoded_table.h"
+#include "core/containers/tabular/lazy_column.h"
 #include "core/containers/tabular/shared_column.h"
 
 // Operators
@@ -86,12 +90,18 @@
     template <typename T>                                                                     \
     using BSharedVector = orq::BSharedVector<T, _EVector_<T, _Replication_>>;                 \
                                                                                               \
+    template <typename T>                                                                     \
+    using PackedBSharedVector = orq::PackedBSharedVector<T, _EVector_<T, _Replication_>>;     \
+                                                                                              \
     using EncodedColumn = relational::EncodedColumn;                                          \
                                                                                               \
     template <typename T>                                                                     \
     using SharedColumn = relational::SharedColumn<T, _EVector_<T, _Replication_>>;            \
                                                                                               \
     template <typename T>                                                                     \
+    using LazyColumn = relational::LazyColumn<T, _EVector_<T, _Replication_>>;                \
+                                                                                              \
+    template <typename T>                                                                     \
     using EncodedTable =                                                                      \
         orq::relational::EncodedTable<T, SharedColumn<T>, ASharedVector<T>, BSharedVector<T>, \
                                       orq::EncodedVector, DataTable<T>>;
@@ -40,4 +40,20 @@ for i in "${!COMMS[@]}"; do
     echo "== All ${COMMS[$i]} tests passed!"
 done
 
-echo "[[ All ${PROTOCOL}PC $THREADS_NUM thread $COMMS tests passed! ]]"
\ No newline at end of file
+# SHM only runs with all parties on this machine; it is launched with startmpc like NOCOPY.
+# Cover the communicator itself and the runtime on top of it.
+STARTMPC=../include/backend/nocopy_communicator/startmpc/startmpc
+SHM_TESTS=(test_communication test_runtime)
+
+echo "== Starting SHM tests"
+cmake .. -Wno-dev -DPROTOCOL=$PROTOCOL -DCOMM=SHM -DEXTRA= -DCOMM_THREADS=1
+make -j "${SHM_TESTS[@]}"
+for test in "${SHM_TESTS[@]}"
+do
+    echo "== Running test:" $test
+    $STARTMPC -n $PROTOCOL ./$test $THREADS_NUM || exit 1;
+    echo "--------------------------------------"
+done
+echo "== All SHM tests passed!"
+
+echo "[[ All ${PROTOCOL}PC $THREADS_NUM thread ${COMMS[*]} SHM tests passed! ]]"
\ No newline at end of file
@@ -60,6 +60,36 @@ void TestBasicCommunication(const int& testSize) {
     }
 }
 
+template <typename T>
+void TestMappedCommunication(const int& testSize) {
+    orq::Vector<T> x(2 * testSize);
+    runTime->populateLocalRandom(x);
+
+    // A single run, a few long runs, and a mapping too fragmented to send in place
+    std::vector<orq::Vector<T>> views = {
+        x.slice(testSize / 2, testSize / 2 + testSize),
+        x.alternating_subset_reference(testSize / 4, testSize / 4),
+        x.simple_subset_reference(0, 2, 2 * testSize - 1)};
+
+    for (auto& view : views) {
+        // Receive into a fragmented view, then send it back from there
+        orq::Vector<T> buffer(2 * testSize), z(testSize);
+        auto y = buffer.simple_subset_reference(1, 2, 2 * testSize - 1);
+
+        runTime->comm0()->exchangeShares(view, y, +1, -1, testSize);
+        runTime->comm0()->exchangeShares(y, z, -1, +1, testSize);
+
+        if (runTime->getPartyID() == 0) {
+            assert(view.same_as(z));
+        }
+
+        // The untouched half of the receive buffer must stay zero
+        for (int i = 0; i < 2 * testSize; i += 2) {
+            assert(buffer[i] == 0);
+        }
+    }
+}
+
 int main(int argc, char** argv) {
     orq_init(argc, argv);
 
@@ -78,6 +108,11 @@ int main(int argc, char** argv) {
     TestBasicCommunication<__int128_t>(test_size);
     single_cout("__int128_t communication: OK");
 
+    TestMappedCommunication<int8_t>(test_size);
+    TestMappedCommunication<int32_t>(test_size);
+    TestMappedCommunication<__int128_t>(test_size);
+    single_cout("mapped communication: OK");
+
     // Tear down communication
 
     return 0;
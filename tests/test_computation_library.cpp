@@ -104,6 +104,61 @@ int main(int argc, char **argv) {
         assert(v3.same_as(vec_pattern_1));
     }
 
+    {
+        // Views of views, against the same access patterns on plain index lists
+        orq::Vector<int> base(64);
+        std::iota(base.begin(), base.end(), 0);
+
+        using Pattern = std::function<orq::Vector<int>(const orq::Vector<int> &)>;
+        using Expected = std::function<std::vector<int>(const std::vector<int> &)>;
+        std::vector<std::pair<Pattern, Expected>> patterns = {
+            {[](auto &x) { return x.slice(2, x.size() - 1); },
+             [](auto &e) { return std::vector<int>(e.begin() + 2, e.end() - 1); }},
+            {[](auto &x) { return x.simple_subset_reference(1, 3); },
+             [](auto &e) {
+                 std::vector<int> r;
+                 for (size_t i = 1; i < e.size(); i += 3) r.push_back(e[i]);
+                 return r;
+             }},
+            {[](auto &x) { return x.alternating_subset_reference(3, 2); },
+             [](auto &e) {
+                 std::vector<int> r;
+                 for (size_t i = 0; i < e.size(); i++)
+                     if (i % 5 < 3) r.push_back(e[i]);
+                 return r;
+             }},
+            {[](auto &x) { return x.repeated_subset_reference(2); },
+             [](auto &e) {
+                 std::vector<int> r;
+                 for (auto v : e) r.insert(r.end(), {v, v});
+                 return r;
+             }},
+            {[](auto &x) { return x.cyclic_subset_reference(2); },
+             [](auto &e) {
+                 std::vector<int> r(e);
+                 r.insert(r.end(), e.begin(), e.end());
+                 return r;
+             }},
+            {[](auto &x) { return x.directed_subset_reference(-1); },
+             [](auto &e) { return std::vector<int>(e.rbegin(), e.rend()); }},
+        };
+
+        for (auto &[p1, e1] : patterns) {
+            for (auto &[p2, e2] : patterns) {
+                for (auto &[p3, e3] : patterns) {
+                    auto view = p3(p2(p1(base)));
+                    auto expected = e3(e2(e1(base.as_std_vector())));
+                    assert(std::ranges::equal(view, expected));
+
+                    // resizing a view keeps a prefix
+                    view.resize(view.size() / 2);
+                    expected.resize(expected.size() / 2);
+                    assert(std::ranges::equal(view, expected));
+                }
+            }
+        }
+    }
+
     single_cout("Vector-Patterns...ok");
 
     // Basic ranges
@@ -133,6 +188,137 @@ int main(int argc, char **argv) {
 
     single_cout("Vector-conversion...ok");
 
+    // Element-wise operations on contiguous, strided, broadcast, and index-mapped operands, against
+    // the same operations on plain values
+    auto test_elementwise = [&]<typename T>() {
+        const size_t n = 100;
+        orq::Vector<T> x(3 * n), y(3 * n);
+        for (size_t i = 0; i < 3 * n; i++) {
+            x[i] = (T)(i * 0x9E3779B97F4A7C15ULL >> 7);
+            y[i] = (T)(i * 0xC2B2AE3D27D4EB4FULL >> 11) | 1;
+        }
+        std::vector<size_t> shuffled(n);
+        for (size_t i = 0; i < n; i++) shuffled[i] = (i * 37) % n;
+
+        std::vector<orq::Vector<T>> views = {
+            x.slice(0, n),
+            x.simple_subset_reference(1, 3),
+            x.slice(n, 2 * n).directed_subset_reference(-1),
+            x.slice(5, 6).repeated_subset_reference(n),
+            x.mapping_reference(shuffled),
+        };
+        // second operands cover the contiguous, strided, negative-stride, and broadcast kernels
+        std::vector<orq::Vector<T>> others = {
+            y.slice(0, n),
+            y.simple_subset_reference(2, 3),
+            y.slice(n, 2 * n).directed_subset_reference(-1),
+            y.slice(7, 8).repeated_subset_reference(n),
+        };
+
+        for (auto &a : views) {
+            for (auto &other : others) {
+                auto check = [&](const orq::Vector<T> &r, auto f) {
+                    assert(r.size() == n);
+                    for (size_t i = 0; i < n; i++) assert(r[i] == (T)f(a[i], other[i]));
+                };
+                check(a + other, [](T u, T v) { return u + v; });
+                check(a - other, [](T u, T v) { return u - v; });
+                check(a * other, [](T u, T v) { return u * v; });
+                check(a ^ other, [](T u, T v) { return u ^ v; });
+                check(a & other, [](T u, T v) { return u & v; });
+                check(other < a, [](T u, T v) { return v < u; });
+                check(~a, [](T u, T) { return ~u; });
+                check(a * 3, [](T u, T) { return u * 3; });
+                check(a.bit_arithmetic_right_shift(3), [](T u, T) { return u >> 3; });
+                check(a.bit_left_shift(5), [](T u, T) {
+                    return (std::make_unsigned_t<T>)u << 5;
+                });
+                check(a.bit_xor(), [](T u, T) {
+                    return std::popcount((std::make_unsigned_t<T>)u) & 1;
+                });
+
+                // in place, through a strided or reversed destination
+                orq::Vector<T> z(2 * n);
+                for (auto dst : {z.simple_subset_reference(0, 2),
+                                 z.slice(n / 2, n / 2 + n).directed_subset_reference(-1)}) {
+                    dst = a;
+                    dst ^= other;
+                    check(dst, [](T u, T v) { return u ^ v; });
+                    dst += 1;
+                    check(dst, [](T u, T v) { return (T)(u ^ v) + 1; });
+
+                    // fused accumulation, against the unfused Vector expressions
+                    using U = std::make_unsigned_t<T>;
+                    dst = other;
+                    dst.fma_accumulate(a, other, other, a, a, a);
+                    check(dst, [](U u, U v) { return v + u * v + v * u + u * u; });
+                    assert(std::ranges::equal(dst, other + a * other + other * a + a * a));
+                    dst = other;
+                    dst.xor_and_accumulate(a, other, a, a);
+                    check(dst, [](T u, T v) { return v ^ (u & v) ^ u; });
+                    assert(std::ranges::equal(dst, other ^ (a & other) ^ (a & a)));
+
+                    const size_t agg = 7;
+                    orq::Vector<T> dot((n + agg - 1) / agg, 1);
+                    dot.dot_product_accumulate(agg, a, other, a, a);
+                    for (size_t g = 0; g < dot.size(); g++) {
+                        U sum = 1;
+                        for (size_t i = g * agg; i < std::min(n, (g + 1) * agg); i++) {
+                            sum += (U)a[i] * (U)other[i] + (U)a[i] * (U)a[i];
+                        }
+                        assert(dot[g] == (T)sum);
+                    }
+                    orq::Vector<T> dot_ones(dot.size(), 1);
+                    assert(std::ranges::equal(dot, dot_ones + (a * other + a * a).chunkedSum(agg)));
+                }
+            }
+        }
+
+        // pack and unpack bit 3 of a contiguous vector
+        const int w = sizeof(T) * 8;
+        orq::Vector<T> packed((n + w - 1) / w);
+        packed.pack_from(x, 3);
+        orq::Vector<T> unpacked(n, (T)-1);
+        unpacked.unpack_from(packed, 3);
+        for (size_t i = 0; i < n; i++) {
+            assert(((x[i] >> 3) & 1) == ((unpacked[i] >> 3) & 1));
+            assert((unpacked[i] | (T)8) == (T)-1);
+        }
+    };
+    test_elementwise.template operator()<int8_t>();
+    test_elementwise.template operator()<int16_t>();
+    test_elementwise.template operator()<int32_t>();
+    test_elementwise.template operator()<int64_t>();
+
+    single_cout("Vector-elementwise...ok");
+
+    {
+        // Storage reused from the pool is initialized as requested
+        const size_t n = 1 << 16;
+        const auto before = orq::memory::pool_stats();
+        {
+            orq::Vector<int64_t> a(n, 7);
+            assert(orq::memory::pool_stats().current >= before.current + n * sizeof(int64_t));
+        }
+        orq::Vector<int64_t> b(n);
+        assert(std::ranges::all_of(b, [](const int64_t x) { return x == 0; }));
+        auto c = orq::Vector<int64_t>::uninitialized(n);
+        assert(c.size() == n);
+
+        const auto after = orq::memory::pool_stats();
+        assert(after.peak >= after.current);
+        assert(after.hits + after.misses == before.hits + before.misses + 3);
+#ifdef USE_VECTOR_POOL
+        assert(after.hits > before.hits);
+#endif
+    }
+
+    // The caches of all threads can be freed between queries
+    orq::service::runTime->trim_memory();
+    assert(orq::memory::pool_stats().cached == 0);
+
+    single_cout("Vector-pool...ok");
+
     // Testing bit manipulation
     orq::Vector<int> vec_bit_01 = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
     orq::Vector<int> vec_bit_02 = vec_bit_01.simple_bit_compress(0, 1, 0, 1);
@@ -123,6 +123,47 @@ void TestDummyAuthRandomGenerator(const size_t& testSize) {
     dummyGenerator.assertCorrelated(a);
 }
 
+template <typename T>
+void TestDaBitGenerator(const size_t& testSize) {
+    auto gen = runTime->rand0()->getCorrelation<T, Correlation::DaBit>();
+    constexpr size_t L = std::numeric_limits<std::make_unsigned_t<T>>::digits;
+
+    // half of the daBits come from the pool, the rest are generated on demand; daBits are
+    // reserved in whole words
+    gen->reserve(testSize / 2);
+    assert(gen->available() >= testSize / 2 && gen->available() < testSize / 2 + L);
+    auto [b, a] = gen->getNext(testSize);
+    assert(gen->available() == 0);
+
+    const size_t words = (testSize + L - 1) / L;
+    using B = COMPILED_MPC_PROTOCOL_NAMESPACE::BSharedVector<T>;
+    using A = COMPILED_MPC_PROTOCOL_NAMESPACE::ASharedVector<T>;
+    using E = COMPILED_MPC_PROTOCOL_NAMESPACE::EVector<T>;
+    B sb(words);
+    A sa(words * L);
+    sb.vector = E(b);
+    sa.vector = E(a);
+
+    // the boolean shares are packed, one daBit per bit
+    auto b_opened = sb.open();
+    auto a_opened = sa.open();
+
+    size_t ones = 0;
+    for (size_t i = 0; i < words * L; ++i) {
+        const T bit = (T)(((std::make_unsigned_t<T>)b_opened[i / L] >> (i % L)) & 1);
+        assert(a_opened[i] == bit);
+        ones += bit;
+    }
+    assert(ones > 0 && ones < words * L);
+
+    // requests within one generated chunk are views into it
+    gen->reserve(4 * L);
+    gen->getNext(L);
+    assert(gen->available() == 3 * L);
+    auto [b2, a2] = gen->getNext(3 * L);
+    assert(gen->available() == 0 && b2[0].size() == 3 && a2[0].size() == 3 * L);
+}
+
 int main(int argc, char** argv) {
     orq_init(argc, argv);
     auto pid = runTime->getPartyID();
@@ -152,6 +193,15 @@ int main(int argc, char** argv) {
     single_cout("Permutation Correlations... OK");
 #endif
 
+    single_cout("Testing DaBitGenerator...");
+    TestDaBitGenerator<int8_t>(test_size);
+    TestDaBitGenerator<int32_t>(test_size);
+    TestDaBitGenerator<int64_t>(test_size);
+    TestDaBitGenerator<__int128_t>(test_size);
+    single_cout("daBit generation: OK");
+
+    single_cout("");
+
     ///////////////////////////////////////////
     // Testing the DummyAuthTriplesGenerator //
     ///////////////////////////////////////////
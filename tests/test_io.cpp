@@ -35,6 +35,7 @@ int main(int argc, char **argv) {
     EncodedTable<int32_t> employees_2(tableName, schema, employeesSize);
     EncodedTable<int32_t> employees_3(tableName, schema, employeesSize);
     EncodedTable<int32_t> employees_4(tableName, schema, employeesSize);
+    EncodedTable<int32_t> employees_5(tableName, schema, employeesSize);
 
     {
         // Reading input from file with party 0 using plain text.
@@ -70,6 +71,19 @@ int main(int argc, char **argv) {
         single_cout("Table: writing secret shares ...OK");
     }
 
+    {
+        // Round trip through the binary share file format.
+        employees_1.outputBinaryTableSecretShares("../results/employees/employees_secrets_3pc_" +
+                                                  std::to_string(runTime->getPartyID()) + ".bin");
+        employees_5.inputBinaryTableSecretShares("../results/employees/employees_secrets_3pc_" +
+                                                 std::to_string(runTime->getPartyID()) + ".bin");
+        auto opened_5 = employees_5.open_with_schema();
+        assert(employeeAge_25.same_as(opened_5.first[0]));
+        assert(employeeID.same_as(opened_5.first[1]));
+        assert(employeeRegion.same_as(opened_5.first[2]));
+        single_cout("Table: binary secret shares ...OK");
+    }
+
     Vector<int32_t> employeeAge_32 = {25, 30, 35, 40, 45,  50, 55, 60, 65, 70, 75,
                                       80, 85, 90, 95, 100, 25, 30, 35, 40, 45, 50,
                                       55, 60, 25, 0,  0,   0,  0,  0,  0,  0};
@@ -435,6 +435,250 @@ void test_unique() {
     assert(tj.get_column(op, "A").same_as({8, 4, 2, -1, -2}));
 }
 
+void test_hash() {
+    single_cout("Hash join...");
+    single_cout("  with valid bit");
+    {
+        // clang-format off
+        std::vector<orq::Vector<int>> pk_data = {
+            {1, 2, 3, 4},
+            {100, 200, 300, 400},
+            {1, 0, 1, 0}};
+        // clang-format on
+        EncodedTable<int> P = secret_share(pk_data, {"[K]", "[D2]", "[_VALID]"});
+        P.filter(P["[_VALID]"]);
+
+        // clang-format off
+        std::vector<orq::Vector<int>> fk_data = {
+            { 1,  1,  1,  1,  2,  3,  3,  3,  3,  5,  5},
+            {10, 20, 30, 32, 35, 40, 50, 60, 65, 70, 80},
+            { 1,  1,  0,  1,  1,  1,  0,  0,  1,  1,  0},
+        };
+        // clang-format on
+        EncodedTable<int> F = secret_share(fk_data, {"[K]", "[Data]", "[_VALID]"});
+        F.filter(F["[_VALID]"]);
+
+        auto J = P.hash_join(F, {"[K]"}, {{"[D2]", "[D2]", copy<B>}});
+
+        // only the matching rows are returned
+        assert(J.size() == 5);
+        assert(P.size() == 4 && F.size() == 11);
+
+        J.sort({"[Data]"}, ASC);
+        auto T = J.open_with_schema();
+        print_table(T, runTime->getPartyID());
+
+        assert(J.get_column(T, "[Data]").same_as({10, 20, 32, 40, 65}));
+        assert(J.get_column(T, "[D2]").same_as({100, 100, 100, 300, 300}));
+    }
+
+    single_cout("  compound key");
+    {
+        std::vector<orq::Vector<int>> d1 = {
+            {0, 0, 0, 1, 1, 2, 2, 2, 2, 3, 4, 5, 5},
+            {0, 1, 2, 0, 1, 0, 1, 2, 3, 3, 4, 5, 6},
+            {9, 8, 7, 6, 5, 4, 3, 2, 1, 0, -1, -2, -3},
+            {9, 8, 7, 6, 5, 4, 3, 2, 1, 0, -1, -2, -3},
+        };
+
+        std::vector<orq::Vector<int>> d2 = {
+            {0, 1, 1, 1, 1, 2, 2, 3, 4, 4, 4, 4, 5, 2},
+            {1, 5, 4, 3, 2, 0, 2, 4, 1, 2, 3, 4, 5, 0},
+            {99, 88, 77, 66, 55, 44, 33, 22, 11, 0, -11, -22, -33, -44},
+        };
+
+        EncodedTable<int> t1 = secret_share(d1, {"[K1]", "[K2]", "A", "Q"});
+        EncodedTable<int> t2 = secret_share(d2, {"[K1]", "[K2]", "[B]"});
+
+        auto tj = t1.hash_join(t2, {"[K1]", "[K2]"}, {{"A", "A", copy<A>}});
+        assert(tj.size() == 6);
+
+        auto cols = tj.getColumnNames();
+        ASSERT_CONTAINS(cols, "A");
+        REFUTE_CONTAINS(cols, "Q");
+        ASSERT_CONTAINS(cols, "[B]");
+
+        tj.sort({"[B]"}, ASC);
+        auto op = tj.open_with_schema();
+        print_table(op, runTime->getPartyID());
+
+        assert(tj.get_column(op, "[B]").same_as({-44, -33, -22, 33, 44, 99}));
+        assert(tj.get_column(op, "[K1]").same_as({2, 5, 4, 2, 2, 0}));
+        assert(tj.get_column(op, "[K2]").same_as({0, 5, 4, 2, 0, 1}));
+        assert(tj.get_column(op, "A").same_as({4, -2, -1, 2, 4, 8}));
+    }
+
+    single_cout("  no matches");
+    {
+        std::vector<orq::Vector<int>> d1 = {{1, 2, 3}};
+        std::vector<orq::Vector<int>> d2 = {{4, 5}, {6, 7}};
+        EncodedTable<int> t1 = secret_share(d1, {"[K]"});
+        EncodedTable<int> t2 = secret_share(d2, {"[K]", "[V]"});
+
+        auto tj = t1.hash_join(t2, {"[K]"});
+        assert(tj.size() == 0);
+    }
+
+    single_cout("  more rows than 8-bit indices");
+    {
+        // invalid rows must get unique messages, even where their index overflows the share type
+        const size_t n = 300;
+        orq::Vector<int8_t> k1(n, 0), v1(n, 0), k2(n, 0), v2(n, 0), d2(n);
+        v1[3] = 1;
+        v2[10] = 1;
+        v2[20] = 1;
+        for (size_t i = 0; i < n; i++) {
+            d2[i] = (int8_t)i;
+        }
+        std::vector<orq::Vector<int8_t>> left_data = {k1, v1};
+        std::vector<orq::Vector<int8_t>> right_data = {k2, d2, v2};
+        EncodedTable<int8_t> t1 = secret_share(left_data, {"[K]", "[_VALID]"});
+        EncodedTable<int8_t> t2 = secret_share(right_data, {"[K]", "[D]", "[_VALID]"});
+        t1.filter(t1["[_VALID]"]);
+        t2.filter(t2["[_VALID]"]);
+
+        auto tj = t1.hash_join(t2, {"[K]"});
+        assert(tj.size() == 2);
+
+        tj.sort({"[D]"}, ASC);
+        auto op = tj.open_with_schema();
+        assert(tj.get_column(op, "[D]").same_as({10, 20}));
+    }
+}
+
+/**
+ * @brief The public parameters of the hash join PRF reproduce the SIMON128/128 test vector.
+ */
+void test_prf_cipher() {
+    using namespace orq::operators::simon;
+
+    std::array<uint64_t, ROUNDS> k;
+    k[0] = 0x0706050403020100;
+    k[1] = 0x0f0e0d0c0b0a0908;
+    for (int i = 0; i < ROUNDS - 2; i++) {
+        k[i + 2] = next_round_key(k[i], k[i + 1]) ^ round_constant(i);
+    }
+
+    uint64_t x = 0x6373656420737265;
+    uint64_t y = 0x6c6c657661727420;
+    for (int r = 0; r < ROUNDS; r++) {
+        round_finish(x, y, rotl(x, 1) & rotl(x, 8), k[r]);
+    }
+    assert(x == 0x49681b1e1e54fe3f);
+    assert(y == 0x65aa832af84e0bbc);
+
+    single_cout("PRF cipher test vector...");
+}
+
+void test_many_to_many() {
+    single_cout("Many-to-many join...");
+    // clang-format off
+    std::vector<orq::Vector<int>> l_data = {
+        { 1,  1,  2,  3,  3,  3,  7},
+        {10, 11, 20, 30, 31, 32, 70},
+        {-1, -2, -3, -4, -5, -6, -7},
+        { 1,  1,  1,  1,  0,  1,  1}};
+    std::vector<orq::Vector<int>> r_data = {
+        {  3,   1,   2,   1,   3,   9,   1},
+        {300, 100, 200, 101, 301, 900, 102},
+        {  1,   1,   0,   1,   1,   1,   1}};
+    // clang-format on
+    EncodedTable<int> L = secret_share(l_data, {"[K]", "[L]", "X", "[_VALID]"});
+    L.filter(L["[_VALID]"]);
+    EncodedTable<int> R = secret_share(r_data, {"[K]", "[R]", "[_VALID]"});
+    R.filter(R["[_VALID]"]);
+
+    single_cout("  duplicate keys on both sides");
+    {
+        auto J = L.many_to_many_join(R, {"[K]"}, 16,
+                                     {{"[L]", "[L]", copy<B>}, {"X", "Y", copy<A>}});
+        assert(J.size() == 16);
+
+        auto cols = J.getColumnNames();
+        ASSERT_CONTAINS(cols, "Y");
+        REFUTE_CONTAINS(cols, "X");
+
+        J.sort({"[R]", "[L]"}, ASC);
+        auto T = J.open_with_schema();
+        print_table(T, runTime->getPartyID());
+
+        assert(J.get_column(T, "[R]").same_as({100, 100, 101, 101, 102, 102, 300, 300, 301, 301}));
+        assert(J.get_column(T, "[L]").same_as({10, 11, 10, 11, 10, 11, 30, 32, 30, 32}));
+        assert(J.get_column(T, "[K]").same_as({1, 1, 1, 1, 1, 1, 3, 3, 3, 3}));
+        assert(J.get_column(T, "Y").same_as({-1, -2, -1, -2, -1, -2, -4, -6, -4, -6}));
+    }
+
+    single_cout("  exact bound");
+    {
+        auto J = L.many_to_many_join(R, {"[K]"}, 10, {{"[L]", "[L]", copy<B>}});
+        assert(J.size() == 10);
+
+        J.sort({"[R]", "[L]"}, ASC);
+        auto T = J.open_with_schema();
+        assert(J.get_column(T, "[L]").same_as({10, 11, 10, 11, 10, 11, 30, 32, 30, 32}));
+    }
+
+    single_cout("  bound exceeded");
+    {
+        bool thrown = false;
+        try {
+            L.many_to_many_join(R, {"[K]"}, 9, {{"[L]", "[L]", copy<B>}});
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+
+    // narrow share types: positions are computed in `int8_t`
+    auto narrow_table = [](size_t n, const std::vector<std::string>& columns) {
+        // key 0 and a distinct value per row
+        std::vector<orq::Vector<int8_t>> data = {orq::Vector<int8_t>(n, 0), orq::Vector<int8_t>(n)};
+        for (size_t i = 0; i < n; i++) {
+            data[1][i] = (int8_t)i;
+        }
+        return EncodedTable<int8_t>(secret_share(data, columns));
+    };
+
+    single_cout("  8-bit shares");
+    {
+        auto L8 = narrow_table(8, {"[K]", "[L]"});
+        auto R8 = narrow_table(8, {"[K]", "[R]"});
+        auto J =
+            L8.many_to_many_join(R8, {"[K]"}, 80, {{"[L]", "[L]", copy<BSharedVector<int8_t>>}});
+        assert(J.size() == 80);
+
+        auto T = J.open_with_schema();
+        assert(J.get_column(T, "[R]").size() == 64);
+    }
+
+    single_cout("  8-bit total wraps around");
+    {
+        // 16 * 16 = 256 output rows: the total is 0 mod 2^8, but must not pass as fitting
+        auto L8 = narrow_table(16, {"[K]", "[L]"});
+        auto R8 = narrow_table(16, {"[K]", "[R]"});
+        bool thrown = false;
+        try {
+            L8.many_to_many_join(R8, {"[K]"}, 90, {{"[L]", "[L]", copy<BSharedVector<int8_t>>}});
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+
+    single_cout("  more rows than 8-bit positions");
+    {
+        auto L8 = narrow_table(100, {"[K]", "[L]"});
+        auto R8 = narrow_table(100, {"[K]", "[R]"});
+        bool thrown = false;
+        try {
+            L8.many_to_many_join(R8, {"[K]"}, 10, {{"[L]", "[L]", copy<BSharedVector<int8_t>>}});
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+}
+
 int main(int argc, char** argv) {
     orq_init(argc, argv);
 
@@ -453,6 +697,11 @@ int main(int argc, char** argv) {
 
     test_unique();
 
+    test_prf_cipher();
+    test_hash();
+
+    test_many_to_many();
+
     // TODO: Add tests here
 
     return 0;
@@ -1,9 +1,137 @@
+#include <random>
+
+#include "core/protocols/jmp_hash.h"
 #include "orq.h"
 
 using namespace orq::service;
 
 using namespace COMPILED_MPC_PROTOCOL_NAMESPACE;
 
+using Digest = std::array<uint8_t, orq::PolyJmpHash::DIGEST_BYTES>;
+
+/**
+ * @brief Hash `msg` with the polynomial JMP hash, feeding it in updates of `chunk` bytes.
+ *
+ */
+Digest poly_digest(const std::vector<uint8_t>& msg, const std::vector<uint8_t>& key,
+                   bool use_hardware, size_t chunk, uint8_t domain = 1) {
+    orq::PolyJmpHash h(use_hardware);
+    h.set_key(key);
+    h.init(domain);
+    for (size_t i = 0; i < msg.size(); i += chunk) {
+        h.update(msg.data() + i, std::min(chunk, msg.size() - i));
+    }
+    Digest d;
+    h.final(d.data());
+    return d;
+}
+
+std::vector<uint8_t> random_bytes(size_t n, std::mt19937_64& gen) {
+    std::vector<uint8_t> v(n);
+    for (auto& b : v) {
+        b = gen();
+    }
+    return v;
+}
+
+/**
+ * @brief The PCLMUL and portable GF(2^128) paths must give identical digests, for any message
+ * length and any split into updates (full 8-block lanes, single blocks, and partial blocks).
+ *
+ */
+void test_poly_hash_paths() {
+    std::mt19937_64 gen(42);
+    auto key = random_bytes(orq::PolyJmpHash::KEY_BYTES, gen);
+
+    for (size_t n : {0, 1, 15, 16, 17, 127, 128, 129, 1000, 4099}) {
+        auto msg = random_bytes(n, gen);
+        auto expected = poly_digest(msg, key, false, std::max<size_t>(n, 1));
+        for (size_t chunk : {1, 7, 16, 33, 128, 4099}) {
+            assert(poly_digest(msg, key, false, chunk) == expected);
+            assert(poly_digest(msg, key, true, chunk) == expected);
+        }
+    }
+
+    if (orq::PolyJmpHash::hardwareSupported()) {
+        single_cout("JMP hash PCLMUL vs portable... OK");
+    } else {
+        single_cout("JMP hash PCLMUL vs portable... OK (no PCLMUL, portable only)");
+    }
+}
+
+/**
+ * @brief Changing a single message (one flipped bit, a dropped or appended byte) or the domain
+ * must change the polynomial hash digest.
+ *
+ */
+void test_poly_hash_tamper() {
+    std::mt19937_64 gen(7);
+    auto key = random_bytes(orq::PolyJmpHash::KEY_BYTES, gen);
+    auto msg = random_bytes(1000, gen);
+    auto expected = poly_digest(msg, key, true, msg.size());
+
+    // first block, inside a full lane, and in the zero-padded last block
+    for (size_t i : {0, 200, 999}) {
+        auto tampered = msg;
+        tampered[i] ^= 1;
+        assert(poly_digest(tampered, key, true, msg.size()) != expected);
+    }
+
+    // the length block catches truncation and zero padding
+    auto shorter = msg;
+    shorter.pop_back();
+    assert(poly_digest(shorter, key, true, shorter.size()) != expected);
+    auto longer = msg;
+    longer.push_back(0);
+    assert(poly_digest(longer, key, true, longer.size()) != expected);
+
+    assert(poly_digest(msg, key, true, msg.size(), 2) != expected);
+
+    single_cout("JMP hash tamper detection... OK");
+}
+
+/**
+ * @brief Updates applied through the background queue give the same digests as applying them
+ * directly, with several hashes interleaved as in the 4PC protocol.
+ *
+ */
+template <typename Hash>
+void test_async_hash(const std::string& name) {
+    const int num_hashes = 3;
+    std::mt19937_64 gen(3);
+    auto key = random_bytes(Hash::KEY_BYTES, gen);
+
+    std::vector<Hash> sync(num_hashes), async(num_hashes);
+    for (int h = 0; h < num_hashes; h++) {
+        sync[h].set_key(key);
+        sync[h].init(h);
+        async[h].set_key(key);
+        async[h].init(h);
+    }
+
+    {
+        orq::JmpHashQueue<Hash> queue;
+        for (int i = 0; i < 200; i++) {
+            auto msg = random_bytes(gen() % 300, gen);
+            int h = i % num_hashes;
+            sync[h].update(msg.data(), msg.size());
+            queue.push(&async[h], msg.data(), msg.size());
+            // the queue copies the message, so the buffer may be reused right away
+            std::fill(msg.begin(), msg.end(), 0);
+        }
+        queue.drain();
+    }
+
+    for (int h = 0; h < num_hashes; h++) {
+        std::array<uint8_t, Hash::DIGEST_BYTES> d_sync{}, d_async{};
+        sync[h].final(d_sync.data());
+        async[h].final(d_async.data());
+        assert(d_sync == d_async);
+    }
+
+    single_cout("JMP async hash (" << name << ")... OK");
+}
+
 /**
  * @brief Parties broadcast their checks, and then take AND of all received.
  * This ensure tests pass regardless of which party actually detected the
@@ -28,6 +156,11 @@ bool joint_malicious_check() {
 int main(int argc, char** argv) {
     orq_init(argc, argv);
 
+    test_poly_hash_paths();
+    test_poly_hash_tamper();
+    test_async_hash<orq::PolyJmpHash>("polynomial");
+    test_async_hash<orq::Blake2bJmpHash>("BLAKE2b");
+
 #ifdef MALICIOUS_PROTOCOL
     auto pid = runTime->getPartyID();
 
@@ -197,6 +197,52 @@ void test_vector_aggregation(const size_t test_size = 32) {
     ASSERT_SAME(min_[GROUP_ONE_SIZE], g0_min);
 }
 
+/**
+ * @brief Aggregate over two sorted key columns with many groups of varying size, and check that
+ * every group's sum lands at its first row (forward) and last row (reverse).
+ *
+ * @tparam S
+ * @param test_size
+ */
+template <typename S>
+void test_multi_key_aggregation(const size_t test_size = 1024) {
+    single_cout("Testing multi-key aggregation...");
+
+    orq::Vector<S> k1(test_size), k2(test_size), data(test_size);
+    for (size_t i = 0; i < test_size; i++) {
+        k1[i] = i / 100;
+        k2[i] = (i % 100) / 7;
+        data[i] = (i * 31) % 17;
+    }
+
+    BSharedVector<S> k1b = secret_share_b(k1, 0);
+    BSharedVector<S> k2b = secret_share_b(k2, 0);
+    ASharedVector<S> da = secret_share_a(data, 0);
+    ASharedVector<S> ra(test_size), rar(test_size);
+
+    std::vector<BSharedVector<S>> keys = {k1b, k2b};
+    aggregate(keys, {}, {{da, ra, sum}});
+    aggregate(keys, {}, {{da, rar, sum}}, Direction::Reverse);
+
+    auto sum_ = ra.open();
+    auto sum_rev = rar.open();
+
+    size_t start = 0;
+    for (size_t i = 1; i <= test_size; i++) {
+        if (i < test_size && k1[i] == k1[start] && k2[i] == k2[start]) {
+            continue;
+        }
+        // group is [start, i)
+        S expected = 0;
+        for (size_t j = start; j < i; j++) {
+            expected += data[j];
+        }
+        ASSERT_SAME(sum_[start], expected);
+        ASSERT_SAME(sum_rev[i - 1], expected);
+        start = i;
+    }
+}
+
 template <typename S>
 void test_distinct(const int test_size = 32) {
     single_cout("Testing " << std::numeric_limits<std::make_unsigned_t<S>>::digits
@@ -528,6 +574,8 @@ int main(int argc, char** argv) {
 #endif
     test_vector_aggregation<int>(SIZE);
 
+    test_multi_key_aggregation<int>();
+
     test_distinct<int8_t>(SIZE);
     test_distinct<int32_t>(SIZE);
     test_distinct<int64_t>(SIZE);
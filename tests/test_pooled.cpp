@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cstdio>
 #include <iostream>
 #include <type_traits>
 
@@ -14,6 +16,65 @@ const size_t test_size_1 = 1 << 12;
 const size_t test_size_2 = 1 << 11;
 const size_t test_size_3 = 1 << 10;
 
+/**
+ * @brief A local generator that numbers its outputs consecutively, to check the pool's ordering.
+ */
+class CountingGenerator : public CorrelationGenerator {
+    int64_t next = 0;
+
+   public:
+    CountingGenerator(int rank) : CorrelationGenerator(rank) {}
+
+    std::tuple<Vector<int32_t>, Vector<int64_t>> getNext(size_t n) {
+        Vector<int32_t> a(n);
+        Vector<int64_t> b(n);
+        for (size_t i = 0; i < n; i++) {
+            a[i] = next;
+            b[i] = -next;
+            next++;
+        }
+        return {a, b};
+    }
+
+    void assertCorrelated(std::tuple<Vector<int32_t>, Vector<int64_t>>&) {}
+};
+
+void test_pooled_chunks() {
+    auto pooled = make_pooled<CountingGenerator>(runTime->getPartyID());
+
+    int64_t expected = 0;
+    auto check = [&](auto batch, size_t n) {
+        auto& [a, b] = batch;
+        assert(a.size() == n && b.size() == n);
+        for (size_t i = 0; i < n; i++) {
+            assert(a[i] == expected && b[i] == -expected);
+            expected++;
+        }
+        return batch;
+    };
+
+    pooled->reserve(100);
+    pooled->reserve(50);
+
+    // requests within the first chunk are views of it
+    auto [a1, b1] = check(pooled->getNext(30), 30);
+    auto [a2, b2] = check(pooled->getNext(40), 40);
+    assert(&a2[0] == &a1[0] + 30);
+    assert(&b2[0] == &b1[0] + 30);
+
+    // straddles both chunks, then empties the second one
+    check(pooled->getNext(60), 60);
+    check(pooled->getNext(20), 20);
+    assert(pooled->size() == 0);
+
+    // more than is pooled: generated directly
+    pooled->reserve(10);
+    assert(std::get<0>(pooled->getNext(0)).size() == 0);
+    auto [a3, b3] = pooled->getNext(25);
+    assert(a3.size() == 25);
+    assert(pooled->size() == 10);
+}
+
 template <typename Generator>
 void test_pooled() {
     auto pID = runTime->getPartyID();
@@ -29,10 +90,34 @@ void test_pooled() {
     // get the batch and check that the correlation is correct
     auto batch = pooled->getNext(test_size_3);
     assert(pooled->size() == test_size_1 + test_size_2 - test_size_3);
+    // spans both reserved batches
     auto batch_2 = pooled->getNext(test_size_1 + test_size_2 - test_size_3);
     assert(pooled->size() == 0);
 
     pooled->assertCorrelated(batch);
+    pooled->assertCorrelated(batch_2);
+}
+
+template <typename Generator>
+void test_background_refill() {
+    auto pID = runTime->getPartyID();
+    auto comm = runTime->comm0();
+
+    auto pooled = make_pooled<Generator>(pID, comm, 0);
+
+    // keep at least test_size_2 pooled, in batches of test_size_1
+    pooled->startBackgroundRefill(test_size_2, test_size_1);
+    for (int i = 0; i < 8; i++) {
+        auto batch = pooled->getNext(test_size_3);
+        pooled->assertCorrelated(batch);
+    }
+
+    // larger than anything scheduled: generated synchronously
+    auto batch = pooled->getNext(4 * test_size_1);
+    pooled->assertCorrelated(batch);
+
+    pooled->stopBackgroundRefill();
+    assert(pooled->size() >= test_size_2);
 }
 
 #ifdef MPC_PROTOCOL_BEAVER_TWO
@@ -85,9 +170,65 @@ void test_pooled_permutations(size_t num_permutations, size_t permutation_size)
     auto permutation = manager->getNext<int32_t>(permutation_size);
 }
 
+void test_background_permutations() {
+    auto pID = runTime->getPartyID();
+    auto manager = PermutationManager::get();
+
+    // shuffle a vector and make sure the parties used the same permutation
+    auto check_shuffle = [](size_t n) {
+        orq::Vector<int> x(n);
+        for (size_t i = 0; i < n; i++) {
+            x[i] = i;
+        }
+        BSharedVector<int> b = secret_share_b(x, 0);
+        b.shuffle();
+        auto opened = b.open();
+        std::sort(opened.begin(), opened.end());
+        assert(opened.same_as(x));
+    };
+
+    // mix of prefetched and reserved permutations, of different sizes
+    manager->prefetch(test_size_1, 2);
+    manager->prefetch(test_size_2, 1);
+    manager->reserve(test_size_3, 1);
+    manager->reserve(test_size_1, 3);
+    assert(manager->size(test_size_1) == 3);
+    assert(manager->size(test_size_2) == 1);
+    assert(manager->size(test_size_3) == 1);
+
+    for (int i = 0; i < 4; i++) {
+        check_shuffle(test_size_1);
+    }
+    check_shuffle(test_size_2);
+    check_shuffle(test_size_3);
+
+    assert(manager->size(test_size_1) == 0);
+    assert(manager->size(test_size_2) == 0);
+    assert(manager->size(test_size_3) == 0);
+
+    // replay the profile of this run
+    std::string profile = "/tmp/orq_perm_profile_" + std::to_string(pID);
+    manager->saveProfile(profile);
+    manager->loadProfile(profile);
+    assert(manager->size(test_size_1) >= 4);
+    assert(manager->size(test_size_2) >= 1);
+
+    for (int i = 0; i < 4; i++) {
+        check_shuffle(test_size_1);
+    }
+    check_shuffle(test_size_2);
+    check_shuffle(test_size_3);
+
+    manager->stopPreprocessing();
+    std::remove(profile.c_str());
+}
+
 int main(int argc, char** argv) {
     orq_init(argc, argv);
 
+    test_pooled_chunks();
+    single_cout("Pooled chunks...OK");
+
 #ifndef MPC_PROTOCOL_BEAVER_TWO
     if (orq::service::runTime->get_num_threads() > 1) {
         test_pooled_permutations(10, 100000);
@@ -95,6 +236,9 @@ int main(int argc, char** argv) {
     } else {
         single_cout("Parallel Permutations...SKIPPED");
     }
+
+    test_background_permutations();
+    single_cout("Background Permutations...OK");
 #else
     test_pooled<GilboaOLE<int8_t>>();
     test_pooled<GilboaOLE<int32_t>>();
@@ -106,6 +250,10 @@ int main(int argc, char** argv) {
     test_pooled<SilentOT<int64_t>>();
     single_cout("Pooled Silent OT...OK");
 
+    test_background_refill<GilboaOLE<int32_t>>();
+    test_background_refill<SilentOT<int32_t>>();
+    single_cout("Background refill...OK");
+
     test_pooled_triples<GilboaOLE<int8_t>, int8_t, orq::Encoding::AShared>();
     test_pooled_triples<GilboaOLE<int32_t>, int32_t, orq::Encoding::AShared>();
     test_pooled_triples<GilboaOLE<int64_t>, int64_t, orq::Encoding::AShared>();
@@ -41,6 +41,62 @@ void test_b2a(int test_size) {
     }
 }
 
+template <typename T>
+void test_b2a_dabit(int test_size) {
+    orq::Vector<T> v(test_size);
+    runTime->populateLocalRandom(v);
+
+    BSharedVector<T> b = secret_share_b(v, 0);
+    ASharedVector<T> a = b.b2a_dabit();
+
+    auto a_opened = a.open();
+    auto b_opened = b.open();
+    assert(a_opened.same_as(b_opened));
+}
+
+template <typename T>
+void test_a2b_edabit(int test_size) {
+    orq::Vector<T> v(test_size);
+    runTime->populateLocalRandom(v);
+
+    ASharedVector<T> a = secret_share_a(v, 0);
+    BSharedVector<T> b = a.a2b_edabit();
+
+    auto a_opened = a.open();
+    auto b_opened = b.open();
+    assert(a_opened.same_as(b_opened));
+}
+
+template <typename T>
+void test_low_bits(int test_size, int bits) {
+    using U = std::make_unsigned_t<T>;
+    const T m = (T)(((U)1 << bits) - 1);
+
+    orq::Vector<T> x(test_size), y(test_size);
+    runTime->populateLocalRandom(x);
+    runTime->populateLocalRandom(y);
+
+    // shares are full-width; only the low bits are operated on and sent
+    BSharedVector<T> bx = secret_share_b(x, 0);
+    BSharedVector<T> by = secret_share_b(y, 0);
+    BSharedVector<T> bz(test_size);
+    bz = bx;
+    bz.and_low_bits(by, bits);
+
+    auto x_open = bx.open_low_bits(bits);
+    auto z_open = bz.open();
+    auto z_low_open = bz.open_low_bits(bits);
+
+    // plaintext inputs are only known to party 0
+    if (runTime->getPartyID() == 0) {
+        for (int i = 0; i < test_size; i++) {
+            assert(x_open[i] == (x[i] & m));
+            assert(z_open[i] == (x[i] & y[i] & m));
+            assert(z_low_open[i] == (x[i] & y[i] & m));
+        }
+    }
+}
+
 // Define a test for secret-vs-plaintext binary operators
 #define DEFINE_TEST_BINARY_OP(_op_, shareType, name)                   \
     template <typename T>                                              \
@@ -171,6 +227,55 @@ void test_equals(int test_size) {
     }
 }
 
+template <typename T>
+void test_packed_bits(int test_size) {
+    auto L = std::numeric_limits<std::make_unsigned_t<T>>::digits;
+    single_cout_nonl(L << "-bit packed bits...");
+    orq::Vector<T> x(test_size), y(test_size), s(test_size);
+    runTime->populateLocalRandom(x);
+    runTime->populateLocalRandom(y);
+    runTime->populateLocalRandom(s);
+    for (int i = 0; i < test_size; i++) {
+        x[i] &= 1;
+        y[i] &= 1;
+        s[i] &= 1;
+    }
+
+    BSharedVector<T> bx = secret_share_b(x, 0);
+    BSharedVector<T> by = secret_share_b(y, 0);
+    BSharedVector<T> bs = secret_share_b(s, 0);
+    PackedBSharedVector<T> px(bx), py(by), ps(bs);
+    assert(px.packed.size() == PackedBSharedVector<T>::packed_size(test_size));
+
+    auto x_open = px.open();
+    auto and_open = (px & py)->open();
+    auto xor_open = (px ^ py)->open();
+    auto or_open = (px | py)->open();
+    auto not_open = (~px)->open();
+    auto mux_open = multiplex(ps, px, py).open();
+    auto mux_b_open = multiplex(ps, bx, by).open();
+
+    // unpacking only writes the given bit position
+    BSharedVector<T> shifted(test_size);
+    px.unpack_into(shifted, 3);
+    auto shifted_open = shifted.open();
+
+    // plaintext inputs are only known to party 0
+    if (runTime->getPartyID() == 0) {
+        for (int i = 0; i < test_size; i++) {
+            assert(x_open[i] == x[i]);
+            assert(and_open[i] == (x[i] & y[i]));
+            assert(xor_open[i] == (x[i] ^ y[i]));
+            assert(or_open[i] == (x[i] | y[i]));
+            assert(not_open[i] == 1 - x[i]);
+            assert(mux_open[i] == (s[i] ? y[i] : x[i]));
+            assert(mux_b_open[i] == (s[i] ? y[i] : x[i]));
+            assert(shifted_open[i] == (x[i] << 3));
+        }
+    }
+    single_cout("OK");
+}
+
 int main(int argc, char** argv) {
     orq_init(argc, argv);
 
@@ -515,6 +620,31 @@ int main(int argc, char** argv) {
     test_b2a<__int128_t>(100);
     single_cout("B2A Conversion...OK");
 
+    test_b2a_dabit<int8_t>(100);
+    test_b2a_dabit<int64_t>(100);
+    test_b2a_dabit<__int128_t>(100);
+    // preprocess some of the daBits; the rest are generated on demand, so the request spans two
+    // pooled chunks
+    runTime->reserve_dabits<int32_t>(32 * test_size / 2);
+    test_b2a_dabit<int32_t>(test_size);
+    single_cout("B2A Conversion (daBits)...OK");
+
+    test_a2b_edabit<int8_t>(100);
+    test_a2b_edabit<int32_t>(100);
+    test_a2b_edabit<int64_t>(test_size);
+    test_a2b_edabit<__int128_t>(100);
+    single_cout("A2B Conversion (edaBits)...OK");
+
+    test_packed_bits<int8_t>(1000);
+    test_packed_bits<int32_t>(1000);
+    test_packed_bits<int64_t>(test_size + 3);
+
+    test_low_bits<int8_t>(test_size + 1, 3);
+    test_low_bits<int32_t>(test_size, 1);
+    test_low_bits<int64_t>(test_size + 7, 5);
+    test_low_bits<__int128_t>(test_size, 1);
+    single_cout("Narrow AND and opening...OK");
+
     runTime->malicious_check();
 
     runTime->print_statistics();
@@ -71,6 +71,60 @@ void test_xchacha20_randomness() {
     return;
 }
 
+// **************************************** //
+//        Test AES-NI CTR Correctness       //
+// **************************************** //
+// The AES-NI algorithm must produce exactly the libsodium AES-256-GCM stream
+void test_aes_ctr_correctness() {
+    if (!AESCTRPRGAlgorithm::hardwareSupported()) {
+        return;
+    }
+
+    // GCM spec test case 14: K = 0^256, IV = 0^96, P = 0^128
+    std::vector<unsigned char> zero_seed(crypto_aead_aes256gcm_KEYBYTES, 0);
+    AESCTRPRGAlgorithm kat(zero_seed);
+    std::vector<uint8_t> block(16);
+    kat.fillBytes(block);
+    const std::vector<uint8_t> expected = {0xce, 0xa7, 0x40, 0x3d, 0x4d, 0x60, 0x6b, 0x6e,
+                                           0x07, 0x4e, 0xc5, 0xd3, 0xba, 0xf3, 0x9d, 0x18};
+    assert(block == expected);
+
+    // Compare against libsodium if it supports AES-GCM on this machine. Otherwise, still check
+    // that the fast (in-place) and buffered Vector paths produce the same stream.
+    std::vector<unsigned char> seed(crypto_aead_aes256gcm_KEYBYTES);
+    AESPRGAlgorithm::aesKeyGen(seed);
+    std::unique_ptr<DeterministicPRGAlgorithm> reference;
+    if (crypto_aead_aes256gcm_is_available()) {
+        reference = std::make_unique<AESPRGAlgorithm>(seed);
+    } else {
+        reference = std::make_unique<AESCTRPRGAlgorithm>(seed);
+    }
+    AESCTRPRGAlgorithm ctr(seed);
+
+    // sizes cover the pipelined loop, partial blocks, and multiple nonces
+    const size_t max_query = AESPRGAlgorithm::MAX_AES_QUERY_BYTES;
+    std::vector<size_t> sizes = {1, 15, 16, 17, 128, 1000, max_query + 33};
+    for (size_t size : sizes) {
+        std::vector<uint8_t> a(size), b(size);
+        reference->fillBytes(a);
+        ctr.fillBytes(b);
+        assert(a == b);
+    }
+
+    // contiguous Vectors are filled in place; mapped Vectors are buffered
+    Vector<int64_t> v(1 << 18), w(1 << 18);
+    reference->getNext(v);
+    ctr.getNext(w);
+    assert(v.same_as(w));
+
+    Vector<int64_t> mapped(1000), contiguous(500);
+    auto even = mapped.simple_subset_reference(0, 2);
+    assert(even.has_mapping());
+    reference->getNext(contiguous);
+    ctr.getNext(even);
+    assert(even.same_as(contiguous));
+}
+
 // **************************************** //
 //           Test Group Generation          //
 // **************************************** //
@@ -410,6 +464,10 @@ int main(int argc, char** argv) {
     test_xchacha20_randomness<int64_t>();
     if (pID == 0) std::cout << "XChaCha20 randomness...OK" << std::endl;
 
+    // test AES-NI counter mode
+    test_aes_ctr_correctness();
+    if (pID == 0) std::cout << "AES-NI CTR...OK" << std::endl;
+
     // test automatic group generation
     test_group_generation();
     if (pID == 0) std::cout << "Automatic Group Generation...OK" << std::endl;
@@ -32,6 +32,66 @@ void test_modify_parallel(int test_size) {
     assert(opened.same_as(v));
 }
 
+void test_work_stealing(int test_size) {
+    bool was_enabled = runTime->getWorkStealing();
+    runTime->setWorkStealing(true);
+
+    // every index must be visited exactly once, regardless of which worker
+    // ends up executing each batch
+    std::vector<int> visits(test_size, 0);
+    runTime->execute_parallel_unsafe(test_size, [&](const size_t start, const size_t end) {
+        for (size_t i = start; i < end; i++) {
+            visits[i]++;
+        }
+    });
+    assert(std::all_of(visits.begin(), visits.end(), [](int v) { return v == 1; }));
+
+    // local tasks over shared vectors should give the same result as static
+    // partitioning
+    test_modify_parallel(test_size);
+
+    runTime->setWorkStealing(was_enabled);
+}
+
+void test_async_dispatch() {
+    std::vector<size_t> sizes = {1000, 3000, 1};
+    std::vector<orq::Vector<int>> xs, ys;
+    std::vector<ASharedVector<int>> ax, ay, ar;
+    for (auto n : sizes) {
+        xs.emplace_back(n);
+        ys.emplace_back(n);
+        std::iota(xs.back().begin(), xs.back().end(), 0);
+        std::iota(ys.back().begin(), ys.back().end(), 7);
+        ax.emplace_back(secret_share_a(xs.back(), 0));
+        ay.emplace_back(secret_share_a(ys.back(), 0));
+        ar.emplace_back(n);
+    }
+
+    BSharedVector<int> bx = secret_share_b(xs[0], 0);
+    BSharedVector<int> by = secret_share_b(ys[0], 0);
+    BSharedVector<int> br(sizes[0]);
+
+    std::vector<AsyncHandle> handles;
+    for (size_t i = 0; i < sizes.size(); i++) {
+        handles.push_back(
+            runTime->multiply_a_async(ax[i].asEVector(), ay[i].asEVector(), ar[i].asEVector()));
+    }
+    auto h_and = runTime->and_b_async(bx.asEVector(), by.asEVector(), br.asEVector());
+
+    // one group for the multiplications, one for the AND
+    assert(runTime->num_pending() == 2);
+    assert(!h_and.ready());
+
+    h_and.wait();
+    assert(runTime->num_pending() == 0);
+
+    for (size_t i = 0; i < sizes.size(); i++) {
+        assert(handles[i].ready());
+        assert(ar[i].open().same_as(xs[i] * ys[i]));
+    }
+    assert(br.open().same_as(xs[0] & ys[0]));
+}
+
 void test_parallel_generation(size_t test_size) {
     int pID = orq::service::runTime->getPartyID();
 
@@ -62,6 +122,12 @@ int main(int argc, char **argv) {
     test_modify_parallel(1000000);
     single_cout("Modify Parallel...OK");
 
+    test_work_stealing(1000003);
+    single_cout("Work Stealing...OK");
+
+    test_async_dispatch();
+    single_cout("Async Dispatch...OK");
+
     auto T = orq::service::runTime->get_num_threads();
     if (T > 1) {
         test_parallel_generation(T * (1 << 24));
@@ -9,7 +9,8 @@ using namespace orq::service;
 using namespace COMPILED_MPC_PROTOCOL_NAMESPACE;
 
 using Group = std::set<int>;
-using LocalPermutation = std::vector<int>;
+using orq::IndexType;
+using orq::LocalPermutation;
 
 // **************************************** //
 //          Test Shuffle GenPerm            //
@@ -25,7 +26,7 @@ void test_shuffle_gen_perm(int test_size) {
         auto common_prg = runTime->rand0()->commonPRGManager->get(group);
 
         // generate the permutation
-        std::vector<int> permutation = orq::operators::gen_perm(test_size, common_prg);
+        LocalPermutation permutation = orq::operators::gen_perm(test_size, common_prg);
 
         int lowestRank = *group.begin();
         if (rank == lowestRank) {
@@ -33,7 +34,7 @@ void test_shuffle_gen_perm(int test_size) {
             for (int otherRank : group) {
                 if (rank == otherRank) continue;
                 int relative_rank = otherRank - rank;
-                Vector<int> remote(test_size);
+                Vector<IndexType> remote(test_size);
                 runTime->comm0()->exchangeShares(permutation, remote, relative_rank, relative_rank,
                                                  test_size);
 
@@ -45,7 +46,7 @@ void test_shuffle_gen_perm(int test_size) {
         } else {
             // just exchange with lowest rank, check equality
             int relative_rank = lowestRank - rank;
-            Vector<int> remote(test_size);
+            Vector<IndexType> remote(test_size);
             runTime->comm0()->exchangeShares(permutation, remote, relative_rank, relative_rank,
                                              test_size);
 
@@ -74,7 +75,7 @@ void test_shuffle_local_apply_perm(int test_size) {
     for (std::set<int> group : runTime->getGroups()) {
         BSharedVector<int> b = secret_share_b(x, 0);
         BSharedVector<int> b_inv = secret_share_b(x, 0);
-        std::vector<int> permutation;
+        LocalPermutation permutation;
         if (group.contains(rank)) {
             auto common_prg = runTime->rand0()->commonPRGManager->get(group);
 
@@ -125,9 +126,11 @@ void test_shuffle_oblivious_apply_sharded_perm(int test_size) {
     auto groups = orq::service::runTime->getGroups();
 
     std::shared_ptr<orq::random::ShardedPermutation> perm_a =
-        orq::random::PermutationManager::get()->getNext<int>(test_size, orq::Encoding::AShared);
+        orq::random::PermutationManager::get()->getNext<IndexType>(test_size,
+                                                                   orq::Encoding::AShared);
     std::shared_ptr<orq::random::ShardedPermutation> perm_b =
-        orq::random::PermutationManager::get()->getNext<int>(test_size, orq::Encoding::BShared);
+        orq::random::PermutationManager::get()->getNext<IndexType>(test_size,
+                                                                   orq::Encoding::BShared);
 
     // apply the permutation
     oblivious_apply_sharded_perm(a, perm_a);
@@ -187,7 +190,7 @@ void test_oblivious_apply_elementwise_perm(int test_size) {
     perm1.shuffle();
 
     // check correctness against local
-    Vector<int> local_perm1 = perm1.open();
+    Vector<IndexType> local_perm1 = perm1.open();
     for (int i = 0; i < test_size; i++) {
         assert(local_perm1[i] < test_size);
     }
@@ -210,7 +213,7 @@ void test_oblivious_apply_elementwise_perm(int test_size) {
     perm2.shuffle();
 
     // check correctness against local
-    Vector<int> local_perm2 = perm2.open();
+    Vector<IndexType> local_perm2 = perm2.open();
 
     orq::operators::oblivious_apply_elementwise_perm(b1, perm2);
     orq::operators::local_apply_perm(b2, local_perm2);
@@ -223,6 +226,40 @@ void test_oblivious_apply_elementwise_perm(int test_size) {
     }
 }
 
+// **************************************** //
+//   Test Multi-Column Elementwise Perm     //
+// **************************************** //
+void test_oblivious_apply_elementwise_perm_columns(int test_size) {
+    // generate a test vector
+    orq::Vector<int> x(test_size);
+    for (int i = 0; i < test_size; i++) {
+        x[i] = i;
+    }
+
+    // mix of arithmetic and binary columns
+    ASharedVector<int> a1 = secret_share_a(x, 0);
+    ASharedVector<int> a2 = secret_share_a(x, 0);
+    BSharedVector<int> b1 = secret_share_b(x, 0);
+    orq::ElementwisePermutation<orq::EVector<int, a1.vector.replicationNumber>> perm(
+        test_size, orq::Encoding::BShared);
+    perm.shuffle();
+
+    Vector<IndexType> local_perm = perm.open();
+
+    using E = orq::EVector<int, a1.vector.replicationNumber>;
+    std::vector<orq::SharedVector<int, E>*> columns = {&a1, &a2, &b1};
+    orq::operators::oblivious_apply_elementwise_perm(columns, perm);
+
+    Vector<int> expected(test_size);
+    for (int i = 0; i < test_size; i++) {
+        expected[local_perm[i]] = x[i];
+    }
+
+    assert(a1.open().same_as(expected));
+    assert(a2.open().same_as(expected));
+    assert(b1.open().same_as(expected));
+}
+
 // **************************************** //
 //           Test Reverse Perm              //
 // **************************************** //
@@ -427,8 +464,8 @@ void test_permutation_composition(int test_size) {
     sigma.shuffle();
     rho.shuffle();
 
-    orq::Vector<int> sigma_opened = sigma.open();
-    orq::Vector<int> rho_opened = rho.open();
+    orq::Vector<IndexType> sigma_opened = sigma.open();
+    orq::Vector<IndexType> rho_opened = rho.open();
 
     // apply the permutations sequentially locally
     orq::operators::local_apply_perm(v1, sigma_opened);
@@ -515,6 +552,9 @@ int main(int argc, char** argv) {
     test_oblivious_apply_elementwise_perm(DEFAULT_TEST_SIZE);
     single_cout("Oblivious Elementwise Permutation Application...OK");
 
+    test_oblivious_apply_elementwise_perm_columns(DEFAULT_TEST_SIZE);
+    single_cout("Multi-Column Elementwise Permutation Application...OK");
+
     test_reverse_elementwise_permutation(DEFAULT_TEST_SIZE);
     single_cout("Reverse Elementwise Permutation...OK");
 
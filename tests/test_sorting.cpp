@@ -173,6 +173,43 @@ void test_radix_sort(int test_size) {
     }
 }
 
+// **************************************** //
+//         Test Multi-Bit Radix Sort        //
+// **************************************** //
+template <typename T>
+void test_radix_sort_ccs(int test_size) {
+    // scrambled values with duplicates and negatives, identical at all parties
+    Vector<T> v(test_size);
+    for (int i = 0; i < test_size; i++) {
+        v[i] = (T)((uint32_t)(i % (test_size / 2)) * 2654435761u);
+    }
+
+    // only the 10 LSBs, so that most digit widths don't divide the key width
+    Vector<T> v_short(test_size);
+    for (int i = 0; i < test_size; i++) {
+        v_short[i] = v[i] & 1023;
+    }
+
+    std::vector<T> expected(v.begin(), v.end());
+    std::vector<T> expected_short(v_short.begin(), v_short.end());
+    std::sort(expected.begin(), expected.end());
+    std::sort(expected_short.begin(), expected_short.end());
+
+    for (int d = 1; d <= RADIX_MAX_DIGIT_BITS; d++) {
+        BSharedVector<T> b1 = secret_share_b(v, 0);
+        BSharedVector<T> b2 = secret_share_b(v_short, 0);
+        BSharedVector<T> b2_data = secret_share_b(v_short, 0);
+
+        orq::operators::radix_sort_ccs(b1, sizeof(T) * 8, true, d);
+        auto permutation = orq::operators::radix_sort_ccs(b2, 10, false, d);
+        orq::operators::oblivious_apply_elementwise_perm(b2_data, permutation);
+
+        assert(b1.open().same_as(expected));
+        assert(b2.open().same_as(expected_short));
+        assert(b2_data.open().same_as(expected_short));
+    }
+}
+
 // **************************************** //
 //            Test Valid Bit Sort           //
 // **************************************** //
@@ -248,8 +285,8 @@ void test_table_sort_single(int num_rows, int num_columns, orq::SortingProtocol
     }
 
     // Make sure we used all of our perms
-    assert(orq::random::PermutationManager::get()->size() == 0);
-    assert(orq::random::PermutationManager::get()->size_pairs() == 0);
+    assert(orq::random::PermutationManager::get()->size(num_rows) == 0);
+    assert(orq::random::PermutationManager::get()->size_pairs(num_rows) == 0);
 }
 
 // **************************************** //
@@ -376,6 +413,9 @@ int main(int argc, char** argv) {
     test_radix_sort<int64_t>(TEST_SIZE);
     single_cout("Radix Sort 64...OK");
 
+    test_radix_sort_ccs<int>(TEST_SIZE);
+    single_cout("Multi-Bit Radix Sort...OK");
+
     test_valid_bit_sorting(TEST_SIZE * 10);
     single_cout("Valid Bit Sort...OK");
 
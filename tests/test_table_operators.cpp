@@ -1,4 +1,5 @@
 #include "orq.h"
+#include "util.h"
 
 using namespace orq::debug;
 using namespace orq::service;
@@ -136,6 +137,161 @@ void test_resize() {
     single_cout("OK");
 }
 
+template <typename T>
+void test_lazy_columns() {
+    single_cout_nonl("Testing " << std::numeric_limits<std::make_unsigned_t<T>>::digits
+                                << "-bit: lazy columns... ");
+
+    Vector<T> x = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    Vector<T> y = {9, 8, 7, 6, 5, 4, 3, 2, 1, 0};
+    EncodedTable<T> table = secret_share<T>({x, y, x, y}, {"[X]", "[Y]", "A", "B"});
+    table.addColumns({"[Pred]", "Arith"}, table.size());
+
+    auto lx = table.lazy("[X]");
+    auto ly = table.lazy("[Y]");
+    auto la = table.lazy("A");
+    auto lb = table.lazy("B");
+
+    // operations with public constants are local
+    assert((la * 3).depth() == 0);
+    assert((lx & 6).depth() == 0);
+    assert((lx | 6).depth() == 0);
+    assert((lx == 6).depth() == 1);
+
+    // the four comparisons run as one kernel call, then both ANDs, then the OR
+    auto pred = ((lx < 5) & (ly >= 7)) | ((lx != ly) & (lx > 8));
+    assert(pred.depth() == 3);
+    table["[Pred]"] = pred.materialize();
+
+    // one multiplication; the multiplication by a constant and the additions are local
+    auto arith = la * lb + la * 3 - lb;
+    assert(arith.depth() == 1);
+    table["Arith"] = arith.materialize();
+
+    auto p = table.asBSharedVector("[Pred]").open();
+    auto q = table.asASharedVector("Arith").open();
+    for (size_t i = 0; i < x.size(); i++) {
+        ASSERT_SAME(p[i], (T)(((x[i] < 5) && (y[i] >= 7)) || ((x[i] != y[i]) && (x[i] > 8))));
+        ASSERT_SAME(q[i], (T)(x[i] * y[i] + x[i] * 3 - y[i]));
+    }
+
+    // every comparison, with columns and constants, fused at one level; OR fused with AND
+    auto cmps = decltype(lx)::materialize(
+        {lx < ly, lx <= 4, lx > ly, lx >= 5, lx == ly, lx != 3, (lx < 5) | (ly < 5), lx | 6});
+    std::vector<Vector<T>> got;
+    for (auto& c : cmps) {
+        got.push_back(static_cast<BSharedVector<T>*>(c->contents.get())->open());
+    }
+    for (size_t i = 0; i < x.size(); i++) {
+        ASSERT_SAME(got[0][i], (T)(x[i] < y[i]));
+        ASSERT_SAME(got[1][i], (T)(x[i] <= 4));
+        ASSERT_SAME(got[2][i], (T)(x[i] > y[i]));
+        ASSERT_SAME(got[3][i], (T)(x[i] >= 5));
+        ASSERT_SAME(got[4][i], (T)(x[i] == y[i]));
+        ASSERT_SAME(got[5][i], (T)(x[i] != 3));
+        ASSERT_SAME(got[6][i], (T)((x[i] < 5) || (y[i] < 5)));
+        ASSERT_SAME(got[7][i], (T)(x[i] | 6));
+    }
+
+    // lazy filter should match the eager one
+    table.filter((lx > 2) & (ly > 2));
+    auto valid = table.getValidVector()->open();
+    for (size_t i = 0; i < x.size(); i++) {
+        ASSERT_SAME(valid[i], (T)((x[i] > 2) && (y[i] > 2)));
+    }
+
+    single_cout("OK");
+}
+
+template <typename T>
+void test_domain_aggregate() {
+    single_cout_nonl("Testing " << std::numeric_limits<std::make_unsigned_t<T>>::digits
+                                << "-bit: domainAggregate... ");
+
+    Vector<T> k1 = {2, 0, 1, 2, 0, 2, 1, 0, 2, 1};
+    Vector<T> k2 = {5, 7, 5, 5, 7, 7, 5, 5, 5, 7};
+    Vector<T> x = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    EncodedTable<T> table = secret_share<T>({k1, k2, x}, {"[K1]", "[K2]", "X"});
+    table.addColumns({"Sum", "Count"}, table.size());
+
+    // last row is invalid
+    auto valid = table.getValidVector()->slice(table.size() - 1);
+    BSharedVector<T> zero(1);
+    valid = zero;
+
+    // value 3 of the first key never occurs
+    std::vector<T> d1 = {0, 1, 2, 3};
+    std::vector<T> d2 = {5, 7};
+    table.setDomain("[K1]", d1);
+    table.setDomain("[K2]", d2);
+
+    using A = ASharedVector<T>;
+    auto res = table.domainAggregate(
+        {"[K1]", "[K2]"},
+        {{"X", "Sum", orq::aggregators::sum<A>}, {"X", "Count", orq::aggregators::count<A>}});
+    ASSERT_SAME(res.size(), d1.size() * d2.size());
+
+    auto r1 = res.asBSharedVector("[K1]").open();
+    auto r2 = res.asBSharedVector("[K2]").open();
+    auto sum = res.asASharedVector("Sum").open();
+    auto count = res.asASharedVector("Count").open();
+    auto res_valid = res.getValidVector()->open();
+    for (size_t g = 0; g < res.size(); g++) {
+        ASSERT_SAME(r1[g], d1[g / d2.size()]);
+        ASSERT_SAME(r2[g], d2[g % d2.size()]);
+
+        T expected_sum = 0, expected_count = 0;
+        for (size_t i = 0; i + 1 < x.size(); i++) {
+            if (k1[i] == r1[g] && k2[i] == r2[g]) {
+                expected_sum += x[i];
+                expected_count++;
+            }
+        }
+        ASSERT_SAME(sum[g], expected_sum);
+        ASSERT_SAME(count[g], expected_count);
+        ASSERT_SAME(res_valid[g], (T)(expected_count > 0));
+    }
+
+    single_cout("OK");
+}
+
+/**
+ * @brief A group of `2^8` rows in an 8-bit table has a count of zero, but must still be valid.
+ */
+void test_domain_aggregate_wraparound() {
+    single_cout_nonl("Testing 8-bit: domainAggregate with a wrapped count... ");
+
+    // 256 rows with key 0, then one invalid row with key 1
+    const size_t n = 257;
+    Vector<int8_t> k(n, 0);
+    Vector<int8_t> x(n, 1);
+    k[n - 1] = 1;
+    EncodedTable<int8_t> table = secret_share<int8_t>({k, x}, {"[K]", "X"});
+    table.addColumns({"Sum", "Count"}, table.size());
+
+    auto valid = table.getValidVector()->slice(n - 1);
+    BSharedVector<int8_t> zero(1);
+    valid = zero;
+
+    std::vector<int8_t> domain = {0, 1, 2};
+    table.setDomain("[K]", domain);
+
+    using A = ASharedVector<int8_t>;
+    auto res = table.domainAggregate(
+        {"[K]"},
+        {{"X", "Sum", orq::aggregators::sum<A>}, {"X", "Count", orq::aggregators::count<A>}});
+    ASSERT_SAME(res.size(), domain.size());
+
+    auto count = res.asASharedVector("Count").open();
+    auto res_valid = res.getValidVector()->open();
+    ASSERT_SAME(count[0], 0);
+    ASSERT_SAME(res_valid[0], 1);
+    ASSERT_SAME(res_valid[1], 0);
+    ASSERT_SAME(res_valid[2], 0);
+
+    single_cout("OK");
+}
+
 int main(int argc, char** argv) {
     orq_init(argc, argv);
 
@@ -144,5 +300,9 @@ int main(int argc, char** argv) {
     test_delete_columns<int>();
     test_project<int>();
     test_resize<int>();
+    test_lazy_columns<int>();
+    test_lazy_columns<int64_t>();
+    test_domain_aggregate<int>();
+    test_domain_aggregate_wraparound();
     return 0;
 }
\ No newline at end of file